@@ -0,0 +1,120 @@
+/**
+ *  @file
+ *  @brief Declaration of CanWheelSpeedInput class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+#ifndef __FIXPOSITION_DRIVER_LIB_CAN_INPUT__
+#define __FIXPOSITION_DRIVER_LIB_CAN_INPUT__
+
+/* SYSTEM / STL */
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/* EXTERNAL */
+
+/* PACKAGE */
+#include <fixposition_driver_lib/params.hpp>
+
+namespace fixposition {
+
+/**
+ * @brief Read wheel speeds directly from a SocketCAN interface
+ *
+ * Every configured signal is decoded from its frame. Once all signals have been received since the last output, the
+ * observers are called with the speeds in the order of the configuration, i.e. the same vector the speed message
+ * subscriber hands to FixpositionDriver::WsCallback().
+ */
+class CanWheelSpeedInput {
+   public:
+    using WheelSpeedObserver = std::function<void(const std::vector<int>& speeds)>;
+
+    /**
+     * @brief Construct a new CanWheelSpeedInput object, does not open the socket yet
+     *
+     * @param[in] params
+     */
+    CanWheelSpeedInput(const CanInputParams& params);
+
+    /**
+     * @brief Destroy the CanWheelSpeedInput object, close the socket
+     *
+     */
+    ~CanWheelSpeedInput();
+
+    /**
+     * @brief Open a non-blocking raw CAN socket on the configured interface, filtering the configured ids
+     *
+     * @return true success
+     * @return false cannot open or bind the socket
+     */
+    bool Open();
+
+    /**
+     * @brief Close the socket
+     *
+     */
+    void Close();
+
+    /**
+     * @brief Read all pending frames without blocking and call the observers for every complete set of speeds
+     *
+     * @return true frames read or nothing to read
+     * @return false socket error, reopen the socket
+     */
+    bool Read();
+
+    /**
+     * @brief Decode one CAN frame, call the observers if it completes a set of speeds
+     *
+     * @param[in] can_id CAN identifier without flags
+     * @param[in] data frame data
+     * @param[in] dlc number of data bytes
+     */
+    void ProcessFrame(const uint32_t can_id, const uint8_t* data, const int dlc);
+
+    /**
+     * @brief Socket file descriptor, -1 if not open
+     *
+     * @return int
+     */
+    int GetFd() const { return fd_; }
+
+    /**
+     * @brief Add Observer to call for every complete set of speeds
+     *
+     * @param[in] ob
+     */
+    void AddObserver(WheelSpeedObserver ob) { obs_.push_back(ob); }
+
+   private:
+    CanInputParams params_;
+    int fd_ = -1;
+    std::vector<int> speeds_;  //!< latest decoded speeds
+    std::vector<bool> fresh_;  //!< signal received since the last output
+    std::vector<WheelSpeedObserver> obs_;
+};
+
+/**
+ * @brief Extract the raw value of a signal from a CAN frame, DBC bit numbering
+ *
+ * @param[in] signal signal definition
+ * @param[in] data frame data
+ * @param[in] dlc number of data bytes
+ * @param[out] raw raw signal value, sign extended if the signal is signed
+ * @return true success
+ * @return false signal does not fit into the frame
+ */
+bool ExtractCanSignal(const CanSignalParams& signal, const uint8_t* data, const int dlc, int64_t& raw);
+
+}  // namespace fixposition
+#endif  // __FIXPOSITION_DRIVER_LIB_CAN_INPUT__
@@ -0,0 +1,130 @@
+/**
+ *  @file
+ *  @brief Declaration of ClockModel and ClockShmWriter classes
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+#ifndef __FIXPOSITION_DRIVER_LIB_CLOCK_MODEL__
+#define __FIXPOSITION_DRIVER_LIB_CLOCK_MODEL__
+
+/* SYSTEM / STL */
+#include <deque>
+#include <string>
+
+/* EXTERNAL */
+
+/* PACKAGE */
+#include <fixposition_driver_lib/gps_clock.hpp>
+#include <fixposition_driver_lib/params.hpp>
+
+namespace fixposition {
+
+/**
+ * @brief Estimate offset and drift of the host monotonic clock with respect to GPS time
+ *
+ * Every message arrives some transport and processing delay after its GPS stamp, the delay is never negative. Of each
+ * window, the sample with the lowest delay is kept, and a line is fitted through the kept samples of the latest
+ * windows. The known minimum output delay of the sensor can be given to remove the remaining bias. A sample far off
+ * the estimate (reconnect to another sensor, time jump) restarts the estimation.
+ */
+class ClockModel {
+   public:
+    /**
+     * @brief Construct a new ClockModel object
+     *
+     * @param[in] params
+     */
+    ClockModel(const ClockModelParams& params);
+
+    /**
+     * @brief Add a sample
+     *
+     * @param[in] gps GPS stamp of the message in [s] since the GPS epoch
+     * @param[in] arrival host monotonic time the message arrived in [s]
+     * @return true the estimate was updated
+     * @return false
+     */
+    bool Update(const double gps, const double arrival);
+
+    /**
+     * @brief Get the current estimate
+     *
+     * @return const ClockEstimate&
+     */
+    const ClockEstimate& GetEstimate() const { return estimate_; }
+
+   private:
+    static constexpr const double kResetThreshold = 1.0;  //!< sample to estimate difference that restarts in [s]
+    static constexpr const int kMinWindows = 3;           //!< windows needed for a valid estimate
+
+    struct Sample {
+        double gps;
+        double host;
+    };
+
+    /**
+     * @brief Fit the estimate through the kept samples
+     *
+     */
+    void Fit();
+
+    ClockModelParams params_;
+    std::deque<Sample> samples_;  //!< lowest delay sample of each of the latest windows
+    Sample window_best_;          //!< lowest delay sample of the current window
+    double window_start_ = 0.0;   //!< host time the current window started
+    bool window_open_ = false;    //!< a window is being collected
+    ClockEstimate estimate_;
+};
+
+/**
+ * @brief Publish the clock estimate in a shared memory page for ClockShmReader
+ *
+ */
+class ClockShmWriter {
+   public:
+    ClockShmWriter() = default;
+    ClockShmWriter(const ClockShmWriter&) = delete;
+    ClockShmWriter& operator=(const ClockShmWriter&) = delete;
+
+    /**
+     * @brief Mark the estimate invalid and unmap the page. The object is not removed, the next driver reuses it.
+     *
+     */
+    ~ClockShmWriter();
+
+    /**
+     * @brief Create the page, or map the one of a previous driver as it is
+     *
+     * @param[in] name shared memory object name, e.g. "/fixposition_clock"
+     * @return true
+     * @return false
+     */
+    bool Open(const std::string& name);
+
+    /**
+     * @brief Update the page
+     *
+     * @param[in] estimate
+     */
+    void Write(const ClockEstimate& estimate);
+
+    /**
+     * @brief Unmap the page without touching it, e.g. once the successor writes it after a hot restart
+     *
+     */
+    void Detach();
+
+   private:
+    ClockShmPage* page_ = nullptr;
+};
+
+}  // namespace fixposition
+#endif  // __FIXPOSITION_DRIVER_LIB_CLOCK_MODEL__
@@ -16,7 +16,10 @@
 #define __FIXPOSITION_DRIVER_LIB_CONVERTER_BASE_CONVERTER__
 
 /* SYSTEM / STL */
+#include <cerrno>
+#include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <vector>
 
 /* EXTERNAL */
@@ -29,26 +32,72 @@ namespace fixposition {
 class BaseAsciiConverter {
    public:
     BaseAsciiConverter() = default;
-    ~BaseAsciiConverter() = default;
+    virtual ~BaseAsciiConverter() = default;  // owned through base pointers by the driver
 
     /**
      * @brief Virtual interface to convert the split tokens into ros messages
      *
      * @param[in] tokens vector of strings split by comma
+     * @return true
+     * @return false malformed message (wrong size, version or number), observers were not called
      */
-    virtual void ConvertTokens(const std::vector<std::string>& tokens) = 0;
+    virtual bool ConvertTokens(const std::vector<std::string>& tokens) = 0;
 
 };
 
 //===================================================
 
 /**
- * @brief Helper function to convert string into double. If string is empty then 0.0 is returned
+ * @brief Helper function to convert string into double. If string is empty then 0.0 is returned. Does not throw, the
+ * library is usable without exceptions.
+ *
+ * @param[in] in_str
+ * @param[in,out] ok set to false if in_str is not a number, unchanged otherwise
+ * @return double 0.0 if in_str is not a number
+ */
+inline double StringToDouble(const std::string& in_str, bool& ok) {
+    if (in_str.empty()) {
+        return 0.;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const double value = std::strtod(in_str.c_str(), &end);
+    if (end != in_str.c_str() + in_str.size() || errno == ERANGE) {
+        ok = false;
+        return 0.;
+    }
+    return value;
+}
+
+/**
+ * @brief Helper function to convert string into double, 0.0 if it is empty or not a number
  *
  * @param[in] in_str
  * @return double
  */
-inline double StringToDouble(const std::string& in_str) { return in_str.empty() ? 0. : std::stod(in_str); }
+inline double StringToDouble(const std::string& in_str) {
+    bool ok = true;
+    return StringToDouble(in_str, ok);
+}
+
+/**
+ * @brief Helper function to convert string into int. Does not throw.
+ *
+ * @param[in] in_str
+ * @param[in,out] ok set to false if in_str is empty or not an integer, unchanged otherwise
+ * @return int 0 if in_str is not an integer
+ */
+inline int StringToInt(const std::string& in_str, bool& ok) {
+    char* end = nullptr;
+    errno = 0;
+    const long value = std::strtol(in_str.c_str(), &end, 10);
+    if (in_str.empty() || end != in_str.c_str() + in_str.size() || errno == ERANGE ||
+        value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+        ok = false;
+        return 0;
+    }
+    return static_cast<int>(value);
+}
 
 /**
  * @brief Make sure the quaternion is unit quaternion
@@ -71,6 +120,19 @@ inline Eigen::Vector3d Vector3ToEigen(const std::string& x, const std::string& y
     return Eigen::Vector3d(StringToDouble(x), StringToDouble(y), StringToDouble(z));
 }
 
+/**
+ * @brief Convert 3 string values into a Eigen::Vector3d
+ *
+ * @param[in] x
+ * @param[in] y
+ * @param[in] z
+ * @param[in,out] ok set to false if a value is not a number
+ * @return Eigen::Vector3d
+ */
+inline Eigen::Vector3d Vector3ToEigen(const std::string& x, const std::string& y, const std::string& z, bool& ok) {
+    return Eigen::Vector3d(StringToDouble(x, ok), StringToDouble(y, ok), StringToDouble(z, ok));
+}
+
 /**
  * @brief convert 4 string values into a Eigen::Quaterniond
  *
@@ -85,19 +147,54 @@ inline Eigen::Quaterniond Vector4ToEigen(const std::string& w, const std::string
     return Eigen::Quaterniond(StringToDouble(w), StringToDouble(x), StringToDouble(y), StringToDouble(z));
 }
 
+/**
+ * @brief convert 4 string values into a Eigen::Quaterniond
+ *
+ * @param[in] w
+ * @param[in] x
+ * @param[in] y
+ * @param[in] z
+ * @param[in,out] ok set to false if a value is not a number
+ * @return Eigen::Quaterniond
+ */
+inline Eigen::Quaterniond Vector4ToEigen(const std::string& w, const std::string& x, const std::string& y,
+                                         const std::string& z, bool& ok) {
+    return Eigen::Quaterniond(StringToDouble(w, ok), StringToDouble(x, ok), StringToDouble(y, ok),
+                              StringToDouble(z, ok));
+}
+
 /**
  * @brief Helper function to convert strings containing gps_wno and gps_tow into ros::Time
  *
  * @param[in] gps_wno
  * @param[in] gps_tow
- * @return ros::Time
+ * @param[in,out] ok set to false if a value is malformed
+ * @return ros::Time GpsTime(0, 0) if empty or malformed
  */
-inline times::GpsTime ConvertGpsTime(const std::string& gps_wno, const std::string& gps_tow) {
+inline times::GpsTime ConvertGpsTime(const std::string& gps_wno, const std::string& gps_tow, bool& ok) {
     if (!gps_wno.empty() && !gps_tow.empty()) {
-        return times::GpsTime(std::stoi(gps_wno), std::stod(gps_tow));
-    } else {
-        return times::GpsTime(0, 0);
+        bool valid = true;
+        const int wno = StringToInt(gps_wno, valid);
+        const double tow = StringToDouble(gps_tow, valid);
+        if (valid) {
+            return times::GpsTime(wno, tow);
+        }
+        ok = false;
     }
+    return times::GpsTime(0, 0);
+}
+
+/**
+ * @brief Helper function to convert strings containing gps_wno and gps_tow into ros::Time, GpsTime(0, 0) if they are
+ * empty or malformed
+ *
+ * @param[in] gps_wno
+ * @param[in] gps_tow
+ * @return ros::Time
+ */
+inline times::GpsTime ConvertGpsTime(const std::string& gps_wno, const std::string& gps_tow) {
+    bool ok = true;
+    return ConvertGpsTime(gps_wno, gps_tow, ok);
 }
 }  // namespace fixposition
 #endif  // __FIXPOSITION_DRIVER_LIB_CONVERTER_BASE_CONVERTER__
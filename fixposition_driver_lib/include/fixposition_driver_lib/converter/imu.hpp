@@ -44,8 +44,10 @@ class ImuConverter : public BaseAsciiConverter {
      * $FP,CORRIMU,1,2197,126191.777855,-0.195224,0.393969,9.869998,0.013342,-0.004620,-0.000728*7D
      *
      * @param[in] tokens message split in tokens
+     * @return true
+     * @return false malformed message, observers were not called
      */
-    void ConvertTokens(const std::vector<std::string>& tokens) final;
+    bool ConvertTokens(const std::vector<std::string>& tokens) final;
 
     /**
      * @brief Add Observer to call at the end of ConvertTokens()
@@ -44,8 +44,10 @@ class LlhConverter : public BaseAsciiConverter {
      * $FP,LLH,1,2197,126191.765,47.398826818,8.458494107,457.518,0.31537,1.0076,0.072696,-0.080012,0.0067274,-0.011602*4E\r\n
      *
      * @param[in] tokens message split in tokens
+     * @return true
+     * @return false malformed message, observers were not called
      */
-    void ConvertTokens(const std::vector<std::string>& tokens) final;
+    bool ConvertTokens(const std::vector<std::string>& tokens) final;
 
     /**
      * @brief Add Observer to call at the end of ConvertTokens()
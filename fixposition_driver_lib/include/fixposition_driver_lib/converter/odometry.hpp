@@ -24,6 +24,7 @@
 /* PACKAGE */
 
 #include <fixposition_driver_lib/converter/base_converter.hpp>
+#include <fixposition_driver_lib/extrinsic.hpp>
 #include <fixposition_driver_lib/msg_data.hpp>
 #include <fixposition_driver_lib/time_conversions.hpp>
 
@@ -31,6 +32,8 @@ namespace fixposition {
 
 class OdometryConverter : public BaseAsciiConverter {
    public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
     /**
      * @brief Data for Messages published from the ODOMETRY msg
      *
@@ -44,6 +47,8 @@ class OdometryConverter : public BaseAsciiConverter {
         TfData tf_ecef_poi;
         TfData tf_ecef_enu;
         TfData tf_ecef_enu0;
+        NavSatFixData llh;       //!< derived from the ECEF position, only if enabled in the constructor
+        bool llh_valid = false;  //!< llh was filled from this message: enabled and fusion initialized
     };
 
     using OdometryObserver = std::function<void(const Msgs&)>;
@@ -51,8 +56,15 @@ class OdometryConverter : public BaseAsciiConverter {
     /**
      * @brief Construct a new Fixposition Msg Converter object
      *
+     * @param[in] derive_llh also compute Msgs::llh, so FP,LLH does not need to be enabled on the sensor
+     * @param[in] extrinsic output everything for this vehicle frame instead of the POI, if configured
      */
-    OdometryConverter() : BaseAsciiConverter(), tf_ecef_enu0_set_(false) {
+    OdometryConverter(const bool derive_llh = false, const ExtrinsicParams& extrinsic = ExtrinsicParams())
+        : BaseAsciiConverter(),
+          derive_llh_(derive_llh),
+          extrinsic_(extrinsic),
+          child_frame_id_(extrinsic_.Enabled() ? extrinsic_.FrameId() : "gnss"),
+          tf_ecef_enu0_set_(false) {
         msgs_.tf_ecef_enu0.frame_id = "ECEF";
         msgs_.tf_ecef_enu0.child_frame_id = "FP_ENU0";
     }
@@ -68,10 +80,11 @@ class OdometryConverter : public BaseAsciiConverter {
      * 0.00090,-0.00105,-0.00832,0.00021,0.00016,0.00019,-0.00000,0.00001,0.00008,0.07652,
      * 0.05768,0.05234,0.00309,-0.00001,0.00173,fp_release_vr2_2.46.1_124*7D
      *
-     * @param[in] state state message as string
-     * @return nav_msgs::Odometry message
+     * @param[in] tokens message split in tokens
+     * @return true
+     * @return false malformed message, observers were not called
      */
-    virtual void ConvertTokens(const std::vector<std::string>& tokens) final;
+    virtual bool ConvertTokens(const std::vector<std::string>& tokens) final;
 
     /**
      * @brief Add Observer to call at the end of ConvertTokens()
@@ -80,11 +93,32 @@ class OdometryConverter : public BaseAsciiConverter {
      */
     void AddObserver(OdometryObserver ob) { obs_.push_back(ob); }
 
+    /**
+     * @brief Get the ENU0 origin, set by the first ODOMETRY message
+     *
+     * @param[out] t_ecef_enu0 origin in ECEF
+     * @return true
+     * @return false not set yet
+     */
+    bool GetEnu0(Eigen::Vector3d& t_ecef_enu0) const;
+
+    /**
+     * @brief Set the ENU0 origin instead of taking the first ODOMETRY position, e.g. to continue the ENU0 frame of a
+     * previous driver instance
+     *
+     * @param[in] t_ecef_enu0 origin in ECEF
+     */
+    void SetEnu0(const Eigen::Vector3d& t_ecef_enu0);
+
    private:
     const std::string header_ = "ODOMETRY";
     static constexpr const int kVersion_ = 2;
     static constexpr const int kSize_ = 45;
 
+    const bool derive_llh_;             //!< compute Msgs::llh
+    const StaticExtrinsic extrinsic_;   //!< POI to vehicle frame
+    const std::string child_frame_id_;  //!< frame of the outputs, the vehicle frame or the POI
+
     //! transform between ECEF and ENU0
     bool tf_ecef_enu0_set_;  //!< flag to indicate if the tf is already set
     Eigen::Vector3d t_ecef_enu0_;
@@ -39,10 +39,11 @@ class TfConverter : public BaseAsciiConverter {
      * @brief ake comma-delimited tokens of FP,TF message, convert to Data structs and if available,
      * call observers
      *
-     * @param[in] state state message as string
-     * @return nav_msgs::Odometry message
+     * @param[in] tokens message split in tokens
+     * @return true
+     * @return false malformed message, observers were not called
      */
-    void ConvertTokens(const std::vector<std::string>& tokens) final;
+    bool ConvertTokens(const std::vector<std::string>& tokens) final;
 
     /**
      * @brief Add Observer to call at the end of ConvertTokens()
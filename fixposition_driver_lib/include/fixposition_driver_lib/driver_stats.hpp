@@ -0,0 +1,249 @@
+/**
+ *  @file
+ *  @brief Declaration of DriverStatsWriter class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+#ifndef __FIXPOSITION_DRIVER_LIB_DRIVER_STATS__
+#define __FIXPOSITION_DRIVER_LIB_DRIVER_STATS__
+
+/* SYSTEM / STL */
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+/* EXTERNAL */
+
+/* PACKAGE */
+#include <fixposition_driver_lib/stream_framer.hpp>
+
+namespace fixposition {
+
+static constexpr const uint32_t kStatsShmMagic = 0x54535046;  //!< "FPST"
+static constexpr const uint32_t kStatsShmVersion = 1;
+static constexpr const int kStatsMaxTypes = 32;      //!< message types counted separately, the rest goes to "OTHER"
+static constexpr const int kStatsTypeNameSize = 24;  //!< incl. the terminating NUL
+static constexpr const int kStatsLatencyBins = 80;   //!< below 1 us, then 4 per octave, the last also takes more
+static constexpr const int kStatsBinsPerOctave = 4;
+
+/**
+ * @brief Counters of one message type. The name is written before num_types is raised to include the slot.
+ *
+ */
+struct StatsShmType {
+    char name[kStatsTypeNameSize];  //!< FP_A header, NMEA sentence (e.g. "GPGGA") or NOV_B message name
+    std::atomic<uint64_t> frames;   //!< frames received
+    std::atomic<uint64_t> bytes;    //!< bytes of these frames
+    std::atomic<uint64_t> errors;   //!< frames that could not be decoded
+};
+
+/**
+ * @brief Layout of the shared memory page. All counters only grow, readers take differences between two looks. Each
+ * counter is consistent by itself, not with the others.
+ *
+ */
+struct StatsShmPage {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t pid;                                         //!< process id of the driver
+    std::atomic<uint32_t> num_types;                      //!< slots of types in use
+    std::atomic<uint64_t> connects;                       //!< connection attempts
+    std::atomic<uint32_t> connected;                      //!< 1 while the sensor connection is open
+    std::atomic<uint32_t> write_queue;                    //!< outbound bytes waiting for the connection
+    std::atomic<uint32_t> backlog;                        //!< bytes still waiting on the connection after the last read
+    std::atomic<uint32_t> pending;                        //!< bytes of the partial frame held by the framer
+    std::atomic<uint64_t> reads;                          //!< reads that returned data
+    std::atomic<uint64_t> bytes;                          //!< bytes read
+    std::atomic<uint64_t> nmea_checksum_errors;           //!< NMEA sentences with a wrong checksum
+    std::atomic<uint64_t> nov_crc_errors;                 //!< NOV_B messages with a wrong CRC
+    std::atomic<uint64_t> shed;                           //!< messages dropped by load shedding
+    std::atomic<uint64_t> write_dropped;                  //!< outbound bytes dropped
+    std::atomic<uint64_t> rx_delay[kStatsLatencyBins];    //!< histogram of kernel receive to read delays (TCP only)
+    std::atomic<uint64_t> processing[kStatsLatencyBins];  //!< histogram of the processing times of the reads
+    StatsShmType types[kStatsMaxTypes];
+};
+
+/**
+ * @brief Histogram bin of a duration
+ *
+ * @param[in] sec duration in [s]
+ * @return int bin, see StatsLatencyBinLimit()
+ */
+inline int StatsLatencyBin(const double sec) {
+    const double us = sec * 1e6;
+    if (!(us >= 1.0)) {
+        return 0;
+    }
+    // us = mantissa * 2^exp with the mantissa in [0.5, 1), its first bits after the leading one select the bin
+    int exp = 0;
+    const double mantissa = std::frexp(us, &exp);
+    const int sub = static_cast<int>((2.0 * mantissa - 1.0) * kStatsBinsPerOctave);
+    const int bin = 1 + (exp - 1) * kStatsBinsPerOctave + sub;
+    return bin < kStatsLatencyBins ? bin : kStatsLatencyBins - 1;
+}
+
+/**
+ * @brief Upper end of a histogram bin
+ *
+ * @param[in] bin
+ * @return double duration in [s]
+ */
+inline double StatsLatencyBinLimit(const int bin) {
+    if (bin <= 0) {
+        return 1e-6;
+    }
+    const int octave = (bin - 1) / kStatsBinsPerOctave;
+    const int sub = (bin - 1) % kStatsBinsPerOctave;
+    return std::ldexp(1.0 + (sub + 1.0) / kStatsBinsPerOctave, octave) * 1e-6;
+}
+
+/**
+ * @brief Count the driver's work in a shared memory page, for fixposition_top and other monitors
+ *
+ * The driver thread is the only writer: counters are bumped with plain relaxed loads and stores, no locked
+ * instructions and no system calls. Message types are looked up by name in the page, no allocation per frame.
+ */
+class DriverStatsWriter {
+   public:
+    DriverStatsWriter() = default;
+    DriverStatsWriter(const DriverStatsWriter&) = delete;
+    DriverStatsWriter& operator=(const DriverStatsWriter&) = delete;
+
+    /**
+     * @brief Unmap the page. The object is not removed, the next driver reuses it.
+     *
+     */
+    ~DriverStatsWriter();
+
+    /**
+     * @brief Create the page, or map the one of a previous driver as it is
+     *
+     * @param[in] name shared memory object name, e.g. "/fixposition_stats"
+     * @return true
+     * @return false
+     */
+    bool Open(const std::string& name);
+
+    /**
+     * @brief Start counting once the sensor connection is ours, resets the counters of a page of another process
+     *
+     */
+    void Start();
+
+    /**
+     * @brief Unmap the page without touching it, e.g. once the successor counts in it after a hot restart
+     *
+     */
+    void Detach();
+
+    /**
+     * @brief Check if the page is mapped, nothing is counted otherwise
+     *
+     * @return true
+     * @return false
+     */
+    bool IsOpen() const { return page_ != nullptr; }
+
+    /**
+     * @brief Count a frame
+     *
+     * @param[in] type
+     * @param[in] frame
+     * @param[in] size
+     */
+    void Frame(const StreamFramer::FrameType type, const uint8_t* frame, const int size);
+
+    /**
+     * @brief Count a frame the framer rejected
+     *
+     * @param[in] error
+     */
+    void FrameError(const StreamFramer::FrameError error);
+
+    /**
+     * @brief Count a frame that passed the checksum but could not be decoded
+     *
+     * @param[in] type FP_A header
+     */
+    void DecodeError(const std::string& type);
+
+    /**
+     * @brief Count a message dropped by load shedding
+     *
+     */
+    void Shed() {
+        if (page_ != nullptr) {
+            Add(page_->shed, 1);
+        }
+    }
+
+    /**
+     * @brief Count a read and update the queue depths
+     *
+     * @param[in] bytes bytes read
+     * @param[in] rx_delay time the data waited in the kernel in [s], 0 if not known
+     * @param[in] processing time to process the data in [s]
+     * @param[in] backlog bytes still waiting on the connection
+     * @param[in] pending bytes of the partial frame held by the framer
+     */
+    void Read(const int bytes, const double rx_delay, const double processing, const int backlog, const int pending);
+
+    /**
+     * @brief Update the connection state and the outbound counters
+     *
+     * @param[in] connected
+     * @param[in] write_queue outbound bytes waiting
+     * @param[in] write_dropped outbound bytes dropped since the start
+     */
+    void Connection(const bool connected, const std::size_t write_queue, const uint64_t write_dropped);
+
+    /**
+     * @brief Count a connection attempt
+     *
+     */
+    void Connect() {
+        if (page_ != nullptr) {
+            Add(page_->connects, 1);
+        }
+    }
+
+   private:
+    /**
+     * @brief Add to a counter, only the driver thread writes
+     *
+     * @param[in] counter
+     * @param[in] n
+     */
+    static void Add(std::atomic<uint64_t>& counter, const uint64_t n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Find or add the slot of a message type
+     *
+     * @param[in] name
+     * @param[in] size length of name
+     * @return StatsShmType&
+     */
+    StatsShmType& Type(const char* name, const int size);
+
+    /**
+     * @brief Zero the counters and mark the page as ours
+     *
+     */
+    void Reset();
+
+    StatsShmPage* page_ = nullptr;
+};
+
+}  // namespace fixposition
+#endif  // __FIXPOSITION_DRIVER_LIB_DRIVER_STATS__
@@ -0,0 +1,103 @@
+/**
+ *  @file
+ *  @brief Declaration of StaticExtrinsic class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+#ifndef __FIXPOSITION_DRIVER_LIB_EXTRINSIC__
+#define __FIXPOSITION_DRIVER_LIB_EXTRINSIC__
+
+/* SYSTEM / STL */
+#include <string>
+
+/* EXTERNAL */
+#include <eigen3/Eigen/Core>
+#include <eigen3/Eigen/Geometry>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/params.hpp>
+
+namespace fixposition {
+
+/**
+ * @brief Rigid transform of the ODOMETRY outputs from the sensor's POI to a vehicle frame (e.g. base_link)
+ *
+ * The lever arm t and rotation R of the vehicle frame in the POI frame are fixed, so the skew matrix of the lever arm
+ * and the twist Jacobian are computed once in the constructor. Orientation covariances are taken as expressed in ECEF,
+ * velocity covariances in the POI frame, as sent by the sensor.
+ */
+class StaticExtrinsic {
+   public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    /**
+     * @brief Construct a new StaticExtrinsic object
+     *
+     * @param[in] params disabled if the frame id is empty
+     */
+    StaticExtrinsic(const ExtrinsicParams& params);
+
+    /**
+     * @brief Is a vehicle frame configured
+     *
+     * @return true
+     * @return false
+     */
+    bool Enabled() const { return enabled_; }
+
+    /**
+     * @brief Name of the vehicle frame
+     *
+     * @return const std::string&
+     */
+    const std::string& FrameId() const { return frame_id_; }
+
+    /**
+     * @brief Pose of the POI to pose of the vehicle frame: p + R_ecef_poi * t, R_ecef_poi * R
+     *
+     * @param[in,out] position in ECEF
+     * @param[in,out] orientation from the body frame to ECEF
+     * @param[in,out] cov 6x6 position and orientation covariance in ECEF
+     */
+    void TransformPose(Eigen::Vector3d& position, Eigen::Quaterniond& orientation,
+                       Eigen::Matrix<double, 6, 6>& cov) const;
+
+    /**
+     * @brief Twist of the POI to twist of the vehicle frame: R^T * (v + w x t), R^T * w
+     *
+     * @param[in,out] linear velocity in the body frame
+     * @param[in,out] angular velocity in the body frame
+     * @param[in,out] cov 6x6 linear and angular velocity covariance in the body frame
+     */
+    void TransformTwist(Eigen::Vector3d& linear, Eigen::Vector3d& angular, Eigen::Matrix<double, 6, 6>& cov) const;
+
+    /**
+     * @brief Acceleration of the POI to acceleration of the vehicle frame, incl. the centripetal term. The angular
+     * acceleration is not known and neglected.
+     *
+     * @param[in,out] acc acceleration in the body frame
+     * @param[in] angular angular velocity in the vehicle frame, i.e. after TransformTwist()
+     */
+    void TransformAcceleration(Eigen::Vector3d& acc, const Eigen::Vector3d& angular) const;
+
+   private:
+    bool enabled_;
+    std::string frame_id_;
+    Eigen::Vector3d t_poi_base_;             //!< lever arm in the POI frame
+    Eigen::Vector3d t_base_;                 //!< lever arm in the vehicle frame
+    Eigen::Quaterniond q_poi_base_;          //!< rotation from the vehicle frame to the POI frame
+    Eigen::Matrix3d rot_base_poi_;           //!< rotation from the POI frame to the vehicle frame
+    Eigen::Matrix3d skew_t_;                 //!< [t]x
+    Eigen::Matrix<double, 6, 6> twist_jac_;  //!< d(twist_base) / d(twist_poi)
+};
+
+}  // namespace fixposition
+#endif  // __FIXPOSITION_DRIVER_LIB_EXTRINSIC__
@@ -18,16 +18,89 @@
 /* SYSTEM / STL */
 #include <termios.h>
 
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
 #include <unordered_map>
 
 /* EXTERNAL */
 
+#include <fixposition_driver_lib/can_input.hpp>
+#include <fixposition_driver_lib/clock_model.hpp>
 #include <fixposition_driver_lib/converter/base_converter.hpp>
+#include <fixposition_driver_lib/converter/imu.hpp>
+#include <fixposition_driver_lib/converter/llh.hpp>
+#include <fixposition_driver_lib/converter/odometry.hpp>
+#include <fixposition_driver_lib/converter/tf.hpp>
+#include <fixposition_driver_lib/driver_stats.hpp>
+#include <fixposition_driver_lib/flight_recorder.hpp>
+#include <fixposition_driver_lib/hot_restart.hpp>
+#include <fixposition_driver_lib/load_shedder.hpp>
 #include <fixposition_driver_lib/params.hpp>
 #include <fixposition_driver_lib/rawdmi.hpp>
+#include <fixposition_driver_lib/rtcm3_input.hpp>
+#include <fixposition_driver_lib/sequence_monitor.hpp>
+#include <fixposition_driver_lib/stream_framer.hpp>
 
 namespace fixposition {
 
+/**
+ * @brief Counters of the read loop, to compare the read strategies
+ *
+ */
+struct ReadStats {
+    uint64_t wakeups = 0;        //!< reads attempted
+    uint64_t empty_reads = 0;    //!< reads that found no data
+    uint64_t bytes = 0;          //!< bytes read
+    double cpu_time = 0.0;       //!< process CPU time (user + system) in [s]
+    uint64_t write_dropped = 0;  //!< outbound bytes dropped because the connection did not take them
+    uint64_t latency_count = 0;  //!< reads with a kernel receive timestamp (TCP only)
+    double latency_sum = 0.0;    //!< sum of kernel receive to read latencies in [s]
+    double latency_max = 0.0;    //!< largest kernel receive to read latency in [s]
+};
+
+/**
+ * @brief Counters of the RTCM3 corrections forwarded to the sensor
+ *
+ */
+struct Rtcm3Stats {
+    uint64_t frames = 0;       //!< frames written to the sensor connection
+    uint64_t bytes = 0;        //!< bytes of these frames
+    uint64_t dropped = 0;      //!< frames dropped because the connection was down or did not take them
+    uint64_t crc_errors = 0;   //!< frames with a wrong CRC-24Q, not forwarded
+    double latency_sum = 0.0;  //!< sum of the latencies from the arrival on the host to written in [s]
+    double latency_max = 0.0;  //!< largest latency from the arrival on the host to written in [s]
+    uint64_t age_count = 0;    //!< frames with observations whose age is known, needs clock.enabled
+    double age_sum = 0.0;      //!< sum of the ages of the observations when written (GPS time - epoch time) in [s]
+    double age_max = 0.0;      //!< largest age of the observations when written in [s]
+};
+
+/**
+ * @brief Where and when a raw frame was received
+ *
+ */
+struct RawFrameInfo {
+    double arrival;   //!< host time of the read that completed the frame, monotonic clock in [s]
+    uint64_t offset;  //!< stream offset of the first byte of the frame since the connection was opened
+};
+
+//! frame is the validated frame incl. checksum or CRC. It points into the driver's buffer and is only valid during
+//! the call: copy what you need to keep.
+using RawFrameObserver = std::function<void(const uint8_t* frame, const int size, const RawFrameInfo& info)>;
+
+using ClockObserver = std::function<void(const ClockEstimate& estimate)>;
+
+/**
+ * @brief A file descriptor of the driver and the poll events it waits for
+ *
+ */
+struct PollFd {
+    int fd;        //!< file descriptor
+    short events;  //!< POLLIN and/or POLLOUT
+};
+
 class FixpositionDriver {
    public:
     /**
@@ -43,11 +116,235 @@ class FixpositionDriver {
     ~FixpositionDriver();
 
     /**
-     * @brief Run in Loop the Read Convert and Publish cycle
+     * @brief Run in Loop the Read Convert and Publish cycle. Except for READ_STRATEGY::RATE, this waits for data for at
+     * most one loop period.
      *
      */
     virtual bool RunOnce();
 
+    /**
+     * @brief Connect the defined TCP or Serial socket. Blocks until the TCP connection is established or failed.
+     *
+     * @return true success
+     * @return false cannot connect
+     */
+    virtual bool Connect();
+
+    /**
+     * @brief File descriptors to watch when the driver runs in an external event loop instead of RunOnce(). The set
+     * changes with every call of Connect(), OnReadable() and OnWritable(), query it again after each.
+     *
+     * @return std::vector<PollFd> empty while not connected
+     */
+    std::vector<PollFd> GetPollFds() const;
+
+    /**
+     * @brief Process the data available on fd, call it when the event loop reports fd readable
+     *
+     * @param[in] fd one of GetPollFds()
+     * @return true
+     * @return false connection lost and closed, call Connect() after fp_output.reconnect_delay
+     */
+    bool OnReadable(const int fd);
+
+    /**
+     * @brief Send queued outbound data (wheelspeed measurements), call it when the event loop reports fd writable
+     *
+     * @param[in] fd one of GetPollFds()
+     * @return true
+     * @return false connection lost and closed, call Connect() after fp_output.reconnect_delay
+     */
+    bool OnWritable(const int fd);
+
+    /**
+     * @brief Check if the connection was handed over to a new driver instance, see HotRestart. RunOnce() and
+     * OnReadable() then return false, the application should exit instead of reconnecting.
+     *
+     * @return true
+     * @return false
+     */
+    bool HandedOver() const { return handed_over_; }
+
+    /**
+     * @brief Check if a running driver instance kept the connection instead of handing it over, see HotRestart. This
+     * instance does not connect then, the application should exit.
+     *
+     * @return true
+     * @return false
+     */
+    bool HandoffRefused() const { return handoff_refused_; }
+
+    /**
+     * @brief Discard the data that arrived while the application did not read, e.g. while a lifecycle node was
+     * inactive. Partial frames are dropped and the stream offsets restart at 0.
+     *
+     */
+    void FlushInput();
+
+    /**
+     * @brief Process recorded sensor output as if it had been read from the connection, e.g. to decode a capture
+     * offline with fp_output.type INPUT_TYPE::NONE. Frames may be split across calls.
+     *
+     * @param[in] data
+     * @param[in] size
+     */
+    void Process(const uint8_t* data, const int size);
+
+    /**
+     * @brief Statistics of each message stream, see SequenceMonitor
+     *
+     * @return const std::map<std::string, SequenceMonitor>& stream name to monitor
+     */
+    const std::map<std::string, SequenceMonitor>& GetSequenceMonitors() const { return seq_monitors_; }
+
+    /**
+     * @brief Load shedding state and the number of dropped messages per type
+     *
+     * @return const LoadShedder&
+     */
+    const LoadShedder& GetLoadShedder() const { return load_shedder_; }
+
+    /**
+     * @brief Number of malformed FP_A messages per type since the start, they are dropped
+     *
+     * @return const std::map<std::string, uint64_t>&
+     */
+    const std::map<std::string, uint64_t>& GetDecodeErrors() const { return decode_errors_; }
+
+    /**
+     * @brief Call ob with the raw bytes of every FP_A frame of the given type, e.g. "EOE" for $FP,EOE,... frames. Use
+     * this to decode messages the driver does not convert. Called before the driver's own conversion, also for frames
+     * dropped by load shedding.
+     *
+     * @param[in] header FP_A message type, empty for all NMEA frames (incl. non-FP_A sentences)
+     * @param[in] ob
+     */
+    void AddFpaFrameObserver(const std::string& header, RawFrameObserver ob) {
+        fpa_frame_obs_.emplace_back(header, ob);
+    }
+
+    /**
+     * @brief Call ob with the raw bytes (header, payload and CRC) of every NOV_B frame with the given message id
+     *
+     * @param[in] message_id NOV_B message id, e.g. static_cast<uint16_t>(MessageId::BESTGNSSPOS)
+     * @param[in] ob
+     */
+    void AddNovFrameObserver(const uint16_t message_id, RawFrameObserver ob) {
+        nov_frame_obs_[message_id].push_back(ob);
+    }
+
+    /**
+     * @brief Call ob with every converted FP,ODOMETRY message
+     *
+     * @param[in] ob
+     * @return true
+     * @return false ODOMETRY is not in fp_output.formats
+     */
+    bool AddOdometryObserver(OdometryConverter::OdometryObserver ob) {
+        if (odometry_converter_ == nullptr) {
+            return false;
+        }
+        odometry_converter_->AddObserver(ob);
+        return true;
+    }
+
+    /**
+     * @brief Call ob with every converted FP,LLH message
+     *
+     * @param[in] ob
+     * @return true
+     * @return false LLH is not in fp_output.formats, or derived from ODOMETRY (fp_output.llh_from_odometry)
+     */
+    bool AddLlhObserver(LlhConverter::LlhObserver ob) {
+        if (llh_converter_ == nullptr) {
+            return false;
+        }
+        llh_converter_->AddObserver(ob);
+        return true;
+    }
+
+    /**
+     * @brief Call ob with every converted FP,RAWIMU message
+     *
+     * @param[in] ob
+     * @return true
+     * @return false RAWIMU is not in fp_output.formats
+     */
+    bool AddRawImuObserver(ImuConverter::ImuObserver ob) {
+        if (rawimu_converter_ == nullptr) {
+            return false;
+        }
+        rawimu_converter_->AddObserver(ob);
+        return true;
+    }
+
+    /**
+     * @brief Call ob with every converted FP,CORRIMU message
+     *
+     * @param[in] ob
+     * @return true
+     * @return false CORRIMU is not in fp_output.formats
+     */
+    bool AddCorrImuObserver(ImuConverter::ImuObserver ob) {
+        if (corrimu_converter_ == nullptr) {
+            return false;
+        }
+        corrimu_converter_->AddObserver(ob);
+        return true;
+    }
+
+    /**
+     * @brief Call ob with every converted FP,TF message
+     *
+     * @param[in] ob
+     * @return true
+     * @return false neither TF nor ODOMETRY is in fp_output.formats
+     */
+    bool AddTfObserver(TfConverter::TfObserver ob) {
+        if (tf_converter_ == nullptr) {
+            return false;
+        }
+        tf_converter_->AddObserver(ob);
+        return true;
+    }
+
+    /**
+     * @brief Current host to GPS clock estimate, see ClockModel
+     *
+     * @return const ClockEstimate&
+     */
+    const ClockEstimate& GetClockEstimate() const { return clock_model_.GetEstimate(); }
+
+    /**
+     * @brief Call ob every time the clock estimate is updated, about once per clock.window
+     *
+     * @param[in] ob
+     */
+    void AddClockObserver(ClockObserver ob) { clock_obs_.push_back(ob); }
+
+    /**
+     * @brief Read loop counters since the start, see ReadStats
+     *
+     * @return ReadStats
+     */
+    ReadStats GetReadStats() const;
+
+    /**
+     * @brief Forward RTCM3 corrections received by other means than customer_input.rtcm3.port, e.g. from a ROS topic.
+     * Only complete frames with a valid CRC are sent to the sensor, frames may be split across calls.
+     *
+     * @param[in] data
+     * @param[in] size
+     */
+    void ForwardRtcm3(const uint8_t* data, const int size);
+
+    /**
+     * @brief Counters of the forwarded corrections since the start, see Rtcm3Stats
+     *
+     * @return Rtcm3Stats
+     */
+    Rtcm3Stats GetRtcm3Stats() const;
+
    protected:
     /**
      * @brief
@@ -71,6 +368,100 @@ class FixpositionDriver {
      */
     virtual void NovConvertAndPublish(const uint8_t* msg, int size);
 
+    /**
+     * @brief Call the raw frame observers matching the frame
+     *
+     * @param[in] type
+     * @param[in] frame
+     * @param[in] size
+     * @param[in] offset stream offset of the frame
+     */
+    void NotifyFrameObservers(const StreamFramer::FrameType type, const uint8_t* frame, const int size,
+                              const uint64_t offset);
+
+    /**
+     * @brief Account for the next message of a stream in its SequenceMonitor and, if it is the configured one, in the
+     * clock model
+     *
+     * @param[in] stream stream name
+     * @param[in] stamp GPS time of the message
+     */
+    void UpdateStream(const std::string& stream, const times::GpsTime& stamp);
+
+    /**
+     * @brief Queue data to send to the sensor and send as much of the queue as possible without blocking. If the
+     * connection does not keep up, stale data is dropped in favour of the new.
+     *
+     * @param[in] data
+     * @param[in] size
+     */
+    void QueueWrite(const uint8_t* data, const std::size_t size);
+
+    /**
+     * @brief Queue data to send to the sensor without sending it yet, see QueueWrite()
+     *
+     * @param[in] data
+     * @param[in] size
+     */
+    void AppendWrite(const uint8_t* data, const std::size_t size);
+
+    /**
+     * @brief Discard the write queue, counting the dropped bytes and corrections
+     *
+     */
+    void DropWriteQueue();
+
+    /**
+     * @brief Queue a validated RTCM3 frame for the sensor and remember when it arrived
+     *
+     * @param[in] frame
+     * @param[in] size
+     * @param[in] arrival host monotonic time in [s]
+     */
+    void QueueRtcm3(const uint8_t* frame, const int size, const double arrival);
+
+    /**
+     * @brief Account for the corrections that are completely written now
+     *
+     */
+    void CompleteRtcm3();
+
+    /**
+     * @brief Connect to the RTCM3 source again if the connection was lost at least fp_output.reconnect_delay ago
+     *
+     */
+    void ReopenRtcm3Input();
+
+    /**
+     * @brief Send as much of the write queue as possible without blocking
+     *
+     * @return true
+     * @return false write error, the queue is discarded
+     */
+    bool FlushWriteQueue();
+
+    /**
+     * @brief Close the connection
+     *
+     */
+    void Disconnect();
+
+    /**
+     * @brief Take over connection and state from a running driver instance
+     *
+     * @return true
+     * @return false no running instance or it had no connection, connect normally, unless HandoffRefused()
+     */
+    bool TakeOver();
+
+    /**
+     * @brief Hand connection and state over to a new driver instance if one is waiting
+     *
+     * @return true handed over, stop
+     * @return false nobody waiting or the handoff failed, carry on
+     */
+    bool ServeHandoff();
+
     /**
      * @brief Initialize convertes based on config
      *
@@ -80,20 +471,28 @@ class FixpositionDriver {
     virtual bool InitializeConverters();
 
     /**
-     * @brief Read data and publish to ros if possible
+     * @brief Wait for data according to the read strategy, also wakes up for the CAN input
      *
-     * @return true data read success or no data
-     * @return false connection problems, restart the connection
+     * @param[in] timeout max time to wait in [s]
+     * @return true the connection is readable
+     * @return false timeout or only the CAN or RTCM3 input is readable
      */
-    virtual bool ReadAndPublish();
+    virtual bool WaitForData(const double timeout);
 
     /**
-     * @brief Connect the defined TCP or Serial socket
+     * @brief READ_STRATEGY::RATE: spend the rest of the loop period forwarding wheelspeeds and corrections as they
+     * arrive, the sensor connection is read once per period after this
      *
-     * @return true success
-     * @return false cannot connect
      */
-    virtual bool Connect();
+    void WaitForInputs();
+
+    /**
+     * @brief Read data and publish to ros if possible
+     *
+     * @return true data read success or no data
+     * @return false connection problems, restart the connection
+     */
+    virtual bool ReadAndPublish();
 
     /**
      * @brief Initialize TCP connection
@@ -111,21 +510,93 @@ class FixpositionDriver {
      */
     virtual bool CreateSerialConnection();
 
+    /**
+     * @brief Find the baudrate the sensor sends at: listen at each candidate for at most fp_output.auto_baud_window
+     * and count the NMEA and NOV_B frames with a valid checksum. Locks on the first baudrate with kAutoBaudFrames
+     * frames, otherwise takes the one with the most frames.
+     *
+     * @param[in,out] options serial port options to apply, the detected speed is set in them
+     * @return int detected baudrate, 0 if no candidate delivered a valid frame
+     */
+    int DetectBaudrate(struct termios& options);
+
+    /**
+     * @brief Host time of the read being processed
+     *
+     * @return double monotonic time in [s]
+     */
+    double ReadTimeSec() const { return std::chrono::duration<double>(read_time_.time_since_epoch()).count(); }
+
     FixpositionDriverParams params_;
 
+    LoadShedder load_shedder_;  //!< drops low priority messages under overload
+
     RAWDMI rawdmi_;  //!< RAWDMI msg struct
 
+    StreamFramer framer_;  //!< splits the input stream into NMEA and NOV_B frames, keeps partial frames across reads
+
+    std::unique_ptr<CanWheelSpeedInput> can_input_;  //!< optional wheelspeed input directly from SocketCAN
+
+    /**
+     * @brief A RTCM3 frame in the write queue
+     *
+     */
+    struct PendingRtcm3 {
+        uint64_t end;      //!< outbound stream position after the last byte of the frame, see write_sent_
+        int size;          //!< frame size
+        double arrival;    //!< host monotonic time of the arrival in [s]
+        bool epoch_valid;  //!< the frame has observations with a GPS epoch time
+        double tow;        //!< GPS time of week of the observations in [s]
+    };
+    std::unique_ptr<Rtcm3Input> rtcm3_input_;                   //!< optional corrections for the sensor
+    std::chrono::steady_clock::time_point rtcm3_connect_time_;  //!< last connection attempt to the RTCM3 source
+    std::deque<PendingRtcm3> rtcm3_pending_;                    //!< frames in the write queue, oldest first
+    Rtcm3Stats rtcm3_stats_;                                    //!< forwarding counters
+
+    std::chrono::steady_clock::time_point read_time_;      //!< host time of the read being processed
+    std::chrono::steady_clock::time_point cycle_end_;      //!< end of the current loop period, READ_STRATEGY::RATE
+    ReadStats read_stats_;                                 //!< read loop counters
+    double read_rx_delay_ = 0.0;                           //!< time that data waited in the kernel in [s], TCP only
+    std::map<std::string, SequenceMonitor> seq_monitors_;  //!< GPS time gap and jitter tracking per stream
+
+    ClockModel clock_model_;                //!< host monotonic to GPS time mapping
+    ClockShmWriter clock_shm_;              //!< shares the clock estimate with other processes
+    std::vector<ClockObserver> clock_obs_;  //!< observers for clock estimate updates
+
     std::unordered_map<std::string, std::unique_ptr<BaseAsciiConverter>>
         a_converters_;  //!< ascii converters corresponding to the input formats
+    // Typed views of a_converters_, null if not configured
+    OdometryConverter* odometry_converter_ = nullptr;  //!< ODOMETRY converter
+    LlhConverter* llh_converter_ = nullptr;            //!< LLH converter
+    ImuConverter* rawimu_converter_ = nullptr;         //!< RAWIMU converter
+    ImuConverter* corrimu_converter_ = nullptr;        //!< CORRIMU converter
+    TfConverter* tf_converter_ = nullptr;              //!< TF converter
+    std::map<std::string, uint64_t> decode_errors_;    //!< malformed messages per type
+
+    std::unique_ptr<HotRestart> hot_restart_;  //!< hands the connection to the next instance, if configured
+    bool handed_over_ = false;                 //!< the connection belongs to the next instance now
+    bool handoff_refused_ = false;             //!< the connection stays with the running instance, do not connect
+
+    FlightRecorder flight_recorder_;  //!< keeps the latest decoded samples in a ring file, if configured
+    DriverStatsWriter stats_;         //!< counters in shared memory for fixposition_top, if configured
 
     using BestgnssposObserver = std::function<void(const Oem7MessageHeaderMem*, const BESTGNSSPOSMem*)>;
     std::vector<BestgnssposObserver> bestgnsspos_obs_;  //!< observers for bestgnsspos
 
     // TODO: Add more NOV types
 
+    std::vector<std::pair<std::string, RawFrameObserver>> fpa_frame_obs_;      //!< FP_A header -> raw frame observer
+    std::unordered_map<uint16_t, std::vector<RawFrameObserver>> nov_frame_obs_;  //!< NOV_B id -> raw frame observers
+
+    static constexpr const std::size_t kMaxWriteQueue = 4096;  //!< max outbound bytes waiting for the connection
+    std::vector<uint8_t> write_queue_;                         //!< outbound bytes not yet taken by the connection
+    uint64_t write_sent_ = 0;                                  //!< outbound bytes sent or dropped since the start
+
     int client_fd_ = -1;  //!< TCP or Serial file descriptor
     int connection_status_ = -1;
     struct termios options_save_;
+    int serial_baudrate_ = 0;                        //!< baudrate found by DetectBaudrate(), tried first on reconnects
+    static constexpr const int kAutoBaudFrames = 2;  //!< valid frames that lock DetectBaudrate() onto a baudrate
 };
 }  // namespace fixposition
 #endif  //__FIXPOSITION_DRIVER_LIB_FIXPOSITION_DRIVER__
@@ -0,0 +1,185 @@
+/**
+ *  @file
+ *  @brief Declaration of FlightRecorder class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+#ifndef __FIXPOSITION_DRIVER_LIB_FLIGHT_RECORDER__
+#define __FIXPOSITION_DRIVER_LIB_FLIGHT_RECORDER__
+
+/* SYSTEM / STL */
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* EXTERNAL */
+
+/* PACKAGE */
+#include <fixposition_driver_lib/converter/odometry.hpp>
+#include <fixposition_driver_lib/msg_data.hpp>
+#include <fixposition_driver_lib/nov_type.hpp>
+#include <fixposition_driver_lib/params.hpp>
+
+namespace fixposition {
+
+static constexpr const uint32_t kFlightRecorderMagic = 0x52465046;  //!< "FPFR"
+static constexpr const uint32_t kFlightRecorderVersion = 1;
+static constexpr const std::size_t kFlightRecorderHeaderSize = 4096;  //!< the records start on the next page
+
+enum class FlightRecordType : uint8_t { ODOMETRY = 1, RAWIMU = 2, CORRIMU = 3, BESTGNSSPOS = 4 };
+
+struct FlightOdometry {
+    double position[3];         //!< ECEF [m]
+    float orientation[4];       //!< ECEF to body, w x y z
+    float velocity[3];          //!< body frame [m/s]
+    float angular_velocity[3];  //!< body frame [rad/s]
+    float acceleration[3];      //!< body frame [m/s^2]
+    int8_t fusion_status;       //!< as in FP,ODOMETRY, -1 if not available
+    int8_t imu_bias_status;     //!< see fusion_status
+    int8_t gnss1_status;        //!< see fusion_status
+    int8_t gnss2_status;        //!< see fusion_status
+    int8_t wheelspeed_status;   //!< see fusion_status
+};
+
+struct FlightImu {
+    double linear_acceleration[3];  //!< [m/s^2]
+    double angular_velocity[3];     //!< [rad/s]
+};
+
+struct FlightBestGnssPos {
+    double lat;           //!< [deg]
+    double lon;           //!< [deg]
+    double hgt;           //!< [m] above mean sea level
+    float undulation;     //!< [m]
+    float lat_stdev;      //!< [m]
+    float lon_stdev;      //!< [m]
+    float hgt_stdev;      //!< [m]
+    uint32_t sol_stat;    //!< solution status, see BESTGNSSPOSMem
+    uint32_t pos_type;    //!< position type, see BESTGNSSPOSMem
+    uint8_t num_svs;      //!< satellites tracked
+    uint8_t num_sol_svs;  //!< satellites used in the solution
+    uint8_t secondary;    //!< 0: GNSS1, 1: GNSS2
+};
+
+/**
+ * @brief One sample in the flight recorder, fixed size
+ *
+ */
+struct FlightRecord {
+    uint64_t seq;      //!< number of the record since the ring file was created
+    double host_time;  //!< host wall clock (CLOCK_REALTIME) when recorded, [s] since 1970
+    double tow;        //!< GPS time of week of the sample [s]
+    uint16_t wno;      //!< GPS week number of the sample
+    uint8_t type;      //!< FlightRecordType
+    uint8_t reserved[5];
+    union {
+        FlightOdometry odometry;  //!< ODOMETRY
+        FlightImu imu;            //!< RAWIMU and CORRIMU
+        FlightBestGnssPos gnss;   //!< BESTGNSSPOS
+        uint8_t raw[96];
+    };
+};
+static_assert(sizeof(FlightRecord) == 128, "FlightRecord must stay 128 bytes, it is the file format");
+
+/**
+ * @brief Start of the ring file, the records follow at kFlightRecorderHeaderSize
+ *
+ */
+struct FlightRecorderHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t reserved;
+    uint64_t capacity;           //!< records in the ring
+    std::atomic<uint64_t> head;  //!< seq of the next record, the record at head - 1 is the newest
+};
+
+/**
+ * @brief Black-box recorder: keeps the latest decoded samples in a memory-mapped ring file
+ *
+ * Every sample is built on the stack and copied into its slot with a single memcpy, then head is advanced. The file is
+ * mapped shared, so the kernel writes it back on its own: the records survive a crash of the process (not a power
+ * loss). Opening an existing ring file of the same size continues it, so the history before a crash is kept across the
+ * restart. Not thread-safe, call from the thread that runs the driver.
+ */
+class FlightRecorder {
+   public:
+    FlightRecorder() = default;
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    /**
+     * @brief Destroy the FlightRecorder object, unmap the file (it is kept)
+     *
+     */
+    ~FlightRecorder();
+
+    /**
+     * @brief Map the ring file, create it if it does not exist or has a different size or format
+     *
+     * @param[in] params
+     * @return true
+     * @return false cannot create or map the file
+     */
+    bool Open(const FlightRecorderParams& params);
+
+    /**
+     * @brief Record an ODOMETRY message
+     *
+     * @param[in] msgs
+     */
+    void Record(const OdometryConverter::Msgs& msgs);
+
+    /**
+     * @brief Record a RAWIMU or CORRIMU message
+     *
+     * @param[in] imu
+     * @param[in] corrected CORRIMU
+     */
+    void Record(const ImuData& imu, const bool corrected);
+
+    /**
+     * @brief Record a BESTGNSSPOS message
+     *
+     * @param[in] header
+     * @param[in] bestgnsspos
+     */
+    void Record(const Oem7MessageHeaderMem* header, const BESTGNSSPOSMem* bestgnsspos);
+
+    /**
+     * @brief Read the records of a ring file, oldest first. Works while a driver is writing to it.
+     *
+     * The oldest slot is skipped, it may have been half overwritten when the writer stopped.
+     *
+     * @param[in] path
+     * @param[out] records
+     * @return true
+     * @return false not a ring file
+     */
+    static bool ReadFile(const std::string& path, std::vector<FlightRecord>& records);
+
+   private:
+    /**
+     * @brief Fill in the common fields and copy the record into the ring
+     *
+     * @param[in] record
+     */
+    void Append(FlightRecord& record);
+
+    FlightRecorderHeader* header_ = nullptr;
+    FlightRecord* records_ = nullptr;
+    std::size_t map_size_ = 0;
+};
+
+}  // namespace fixposition
+
+#endif  //__FIXPOSITION_DRIVER_LIB_FLIGHT_RECORDER__
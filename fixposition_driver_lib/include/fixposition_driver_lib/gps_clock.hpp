@@ -0,0 +1,194 @@
+/**
+ *  @file
+ *  @brief Host to GPS time mapping shared by the driver, header-only reader for other processes
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+#ifndef __FIXPOSITION_DRIVER_LIB_GPS_CLOCK__
+#define __FIXPOSITION_DRIVER_LIB_GPS_CLOCK__
+
+/* SYSTEM / STL */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/* EXTERNAL */
+
+/* PACKAGE */
+
+// Only depends on the STL and POSIX: other sensor drivers include this header without linking the driver library.
+
+namespace fixposition {
+
+/**
+ * @brief Mapping from the host monotonic clock (CLOCK_MONOTONIC, std::chrono::steady_clock) to GPS time
+ *
+ * gps = gps_ref + (host - host_ref) * (1 + drift)
+ */
+struct ClockEstimate {
+    bool valid = false;        //!< enough data for a reliable estimate
+    double host_ref = 0.0;     //!< host monotonic time of the reference point in [s]
+    double gps_ref = 0.0;      //!< GPS time at host_ref in [s] since the GPS epoch (no leap seconds)
+    double drift = 0.0;        //!< rate error of the host clock with respect to GPS time, [s/s]
+    double uncertainty = 0.0;  //!< rms of the fit residuals in [s]
+};
+
+/**
+ * @brief Convert a host monotonic time to GPS time
+ *
+ * @param[in] estimate
+ * @param[in] host host monotonic time in [s]
+ * @return double GPS time in [s] since the GPS epoch
+ */
+inline double HostToGps(const ClockEstimate& estimate, const double host) {
+    return estimate.gps_ref + (host - estimate.host_ref) * (1.0 + estimate.drift);
+}
+
+static constexpr const uint32_t kClockShmMagic = 0x46504b43;  //!< "FPCK"
+static constexpr const uint32_t kClockShmVersion = 1;
+
+/**
+ * @brief Layout of the shared memory page, written as a seqlock: seq is odd while the writer updates the page
+ *
+ */
+struct ClockShmPage {
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> seq;
+    std::atomic<uint32_t> valid;
+    std::atomic<double> host_ref;
+    std::atomic<double> gps_ref;
+    std::atomic<double> drift;
+    std::atomic<double> uncertainty;
+};
+static_assert(sizeof(std::atomic<double>) == sizeof(double), "std::atomic<double> must not carry a lock");
+
+/**
+ * @brief Read the clock estimate the driver publishes in shared memory (parameter clock.shm_name)
+ *
+ * Reading takes a few loads of the mapped page and never blocks the driver.
+ */
+class ClockShmReader {
+   public:
+    ClockShmReader() = default;
+    ClockShmReader(const ClockShmReader&) = delete;
+    ClockShmReader& operator=(const ClockShmReader&) = delete;
+    ~ClockShmReader() { Close(); }
+
+    /**
+     * @brief Map the page, the driver must have created it
+     *
+     * @param[in] name shared memory object name, e.g. "/fixposition_clock"
+     * @return true
+     * @return false not available (yet)
+     */
+    bool Open(const std::string& name) {
+        Close();
+        const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            return false;
+        }
+        void* addr = mmap(nullptr, sizeof(ClockShmPage), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            return false;
+        }
+        page_ = static_cast<const ClockShmPage*>(addr);
+        if (page_->magic != kClockShmMagic || page_->version != kClockShmVersion) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Unmap the page
+     *
+     */
+    void Close() {
+        if (page_ != nullptr) {
+            munmap(const_cast<ClockShmPage*>(page_), sizeof(ClockShmPage));
+            page_ = nullptr;
+        }
+    }
+
+    /**
+     * @brief Get a consistent copy of the current estimate
+     *
+     * @param[out] estimate
+     * @return true
+     * @return false page not mapped or no valid estimate
+     */
+    bool Read(ClockEstimate& estimate) const {
+        if (page_ == nullptr) {
+            return false;
+        }
+        for (int i = 0; i < kMaxRetries; i++) {
+            const uint32_t seq = page_->seq.load(std::memory_order_acquire);
+            if (seq & 1) {
+                continue;
+            }
+            estimate.valid = page_->valid.load(std::memory_order_relaxed) != 0;
+            estimate.host_ref = page_->host_ref.load(std::memory_order_relaxed);
+            estimate.gps_ref = page_->gps_ref.load(std::memory_order_relaxed);
+            estimate.drift = page_->drift.load(std::memory_order_relaxed);
+            estimate.uncertainty = page_->uncertainty.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (page_->seq.load(std::memory_order_relaxed) == seq) {
+                return estimate.valid;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Convert a host monotonic time to GPS time with the current estimate
+     *
+     * @param[in] host host monotonic time in [s], e.g. a camera frame timestamp
+     * @param[out] gps GPS time in [s] since the GPS epoch
+     * @return true
+     * @return false no valid estimate
+     */
+    bool HostToGps(const double host, double& gps) const {
+        ClockEstimate estimate;
+        if (!Read(estimate)) {
+            return false;
+        }
+        gps = fixposition::HostToGps(estimate, host);
+        return true;
+    }
+
+    /**
+     * @brief Current GPS time
+     *
+     * @param[out] gps GPS time in [s] since the GPS epoch
+     * @return true
+     * @return false no valid estimate
+     */
+    bool GpsNow(double& gps) const {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return HostToGps(now.tv_sec + now.tv_nsec * 1e-9, gps);
+    }
+
+   private:
+    static constexpr const int kMaxRetries = 100;  //!< reads colliding with a write before giving up
+
+    const ClockShmPage* page_ = nullptr;
+};
+
+}  // namespace fixposition
+#endif  // __FIXPOSITION_DRIVER_LIB_GPS_CLOCK__
@@ -0,0 +1,134 @@
+/**
+ *  @file
+ *  @brief Declaration of HotRestart class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+#ifndef __FIXPOSITION_DRIVER_LIB_HOT_RESTART__
+#define __FIXPOSITION_DRIVER_LIB_HOT_RESTART__
+
+/* SYSTEM / STL */
+#include <sys/types.h>
+#include <termios.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* EXTERNAL */
+#include <eigen3/Eigen/Core>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/params.hpp>
+
+namespace fixposition {
+
+/**
+ * @brief Driver state handed to the successor together with the sensor connection
+ *
+ */
+struct HandoffState {
+    INPUT_TYPE type = INPUT_TYPE::TCP;                      //!< connection type, the successor must use the same
+    uint64_t stream_offset = 0;                             //!< next stream offset, see StreamFramer::GetOffset()
+    std::vector<uint8_t> pending;                           //!< partial frame held by the framer
+    bool enu0_set = false;                                  //!< t_ecef_enu0 is valid
+    Eigen::Vector3d t_ecef_enu0 = Eigen::Vector3d::Zero();  //!< ENU0 origin of the ODOMETRY converter
+    bool termios_set = false;                               //!< termios is valid (serial only)
+    struct termios termios;                                 //!< original serial port options, restored on close
+};
+
+/**
+ * @brief Hand the sensor connection and driver state from a running driver to its successor, e.g. for an upgrade
+ *
+ * The running driver listens on a Unix socket. A new driver instance configured with the same socket connects to it
+ * once it is ready to process data and asks for the connection. The running driver stops reading, sends its sensor file
+ * descriptor (SCM_RIGHTS) and its state, and exits. Data arriving in the meantime waits in the kernel, nothing is lost
+ * and nothing is read twice. The successor then takes over the socket for the next restart.
+ *
+ * The successor acks the state and uses the descriptor only after the running driver confirms that it stopped. If the
+ * ack comes too late, the running driver carries on and closes the socket without confirming. The successor then must
+ * not connect by itself, the connection is never read by both. A running driver without a connection (e.g. while
+ * reconnecting) hands over its state without a descriptor and exits as well, the successor then connects.
+ */
+class HotRestart {
+   public:
+    //! Outcome of Receive()
+    enum class Handoff {
+        NONE,      //!< no driver running, connect normally
+        RECEIVED,  //!< the running driver stopped, fd (-1 if it had no connection) and state are valid
+        REFUSED,   //!< a running driver did not hand over and keeps the connection
+    };
+
+    /**
+     * @brief Construct a new HotRestart object
+     *
+     * @param[in] params
+     */
+    HotRestart(const HotRestartParams& params);
+
+    /**
+     * @brief Destroy the HotRestart object, remove the socket unless it was handed over
+     *
+     */
+    ~HotRestart();
+
+    /**
+     * @brief Ask a running driver for its connection
+     *
+     * @param[out] fd sensor file descriptor, owned by the caller, -1 if the running driver had no connection
+     * @param[out] state
+     * @return Handoff
+     */
+    Handoff Receive(int& fd, HandoffState& state);
+
+    /**
+     * @brief Listen for a successor, replaces a socket left behind by a driver that is gone
+     *
+     * @return true
+     * @return false another driver still listens on the socket
+     */
+    bool Listen();
+
+    /**
+     * @brief Listening socket to poll for POLLIN, -1 if not listening
+     *
+     * @return int
+     */
+    int GetFd() const { return listen_fd_; }
+
+    /**
+     * @brief Accept a waiting successor without blocking
+     *
+     * @return int connection to the successor, -1 if none waiting
+     */
+    int Accept();
+
+    /**
+     * @brief Hand the connection over to the successor. On success, stops listening without removing the socket,
+     * which now belongs to the successor.
+     *
+     * @param[in] conn connection from Accept(), closed by this function
+     * @param[in] fd sensor file descriptor, -1 if not connected
+     * @param[in] state
+     * @return true the successor has the connection, close it and exit
+     * @return false the successor went away, carry on
+     */
+    bool Send(const int conn, const int fd, const HandoffState& state);
+
+   private:
+    HotRestartParams params_;
+    int listen_fd_ = -1;  //!< listening socket
+    bool owner_ = false;  //!< the socket path is ours to remove
+    ino_t inode_ = 0;     //!< inode of the socket we bound, the path may have been replaced since
+};
+
+}  // namespace fixposition
+#endif  // __FIXPOSITION_DRIVER_LIB_HOT_RESTART__
@@ -0,0 +1,108 @@
+/**
+ *  @file
+ *  @brief Declaration of LoadShedder class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+#ifndef __FIXPOSITION_DRIVER_LIB_LOAD_SHEDDER__
+#define __FIXPOSITION_DRIVER_LIB_LOAD_SHEDDER__
+
+/* SYSTEM / STL */
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+/* EXTERNAL */
+
+/* PACKAGE */
+#include <fixposition_driver_lib/params.hpp>
+
+namespace fixposition {
+
+/**
+ * @brief Drop or decimate low priority message types while the driver cannot keep up
+ *
+ * After every read, the processing time and the bytes still waiting on the connection are compared with the budgets.
+ * Each read over budget raises the shedding level by one, a long enough run of reads well within budget lowers it by
+ * one. At level L, the types of the L lowest priorities are affected: the highest of those is decimated, the others
+ * are dropped. Priority 0 is never shed.
+ */
+class LoadShedder {
+   public:
+    /**
+     * @brief Construct a new LoadShedder object
+     *
+     * @param[in] params
+     */
+    LoadShedder(const LoadSheddingParams& params);
+
+    /**
+     * @brief Check if anything is being shed at the moment. Cheap, call it before Accept()
+     *
+     * @return true
+     * @return false
+     */
+    bool Shedding() const { return level_ > 0; }
+
+    /**
+     * @brief Decide if a message of the given type is processed, count it if not
+     *
+     * @param[in] type message type, e.g. "ODOMETRY"
+     * @return true process the message
+     * @return false drop the message
+     */
+    bool Accept(const std::string& type);
+
+    /**
+     * @brief Update the shedding level after processing one read
+     *
+     * @param[in] processing_time time spent processing the read in [s]
+     * @param[in] backlog bytes still waiting on the connection
+     */
+    void Update(const double processing_time, const int backlog);
+
+    /**
+     * @brief Current shedding level, 0 if nothing is shed
+     *
+     * @return int
+     */
+    int GetLevel() const { return level_; }
+
+    /**
+     * @brief Number of dropped messages per type since the start
+     *
+     * @return const std::map<std::string, uint64_t>&
+     */
+    const std::map<std::string, uint64_t>& GetShedCounts() const { return shed_; }
+
+   private:
+    static constexpr const int kCalmReads = 100;  //!< reads within half the budget needed to lower the level
+
+    /**
+     * @brief Priority of a type, 1 if not configured
+     *
+     * @param[in] type
+     * @return int
+     */
+    int Priority(const std::string& type) const;
+
+    LoadSheddingParams params_;
+    std::unordered_map<std::string, int> priority_;     //!< type -> priority
+    int max_priority_ = 1;                              //!< lowest priority (highest number) configured
+    int level_ = 0;                                     //!< shedding level
+    int calm_reads_ = 0;                                //!< consecutive reads within half the budget
+    std::unordered_map<std::string, uint64_t> passed_;  //!< per type counter for decimation
+    std::map<std::string, uint64_t> shed_;              //!< per type dropped messages
+};
+
+}  // namespace fixposition
+#endif  // __FIXPOSITION_DRIVER_LIB_LOAD_SHEDDER__
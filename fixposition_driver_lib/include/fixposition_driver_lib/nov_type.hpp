@@ -46,6 +46,25 @@
 
 namespace fixposition {
 
+/**
+ * @brief Feed one more byte into a running CRC32
+ *
+ * @param[in] crc CRC of the bytes so far, 0 at the start of a message
+ * @param[in] byte next byte
+ * @return uint32_t CRC including byte
+ */
+inline uint32_t nov_crc32_update(uint32_t crc, const uint8_t byte) {
+    crc ^= byte;
+    for (int j = 0; j < 8; j++) {
+        if (crc & 1) {
+            crc = (crc >> 1) ^ 0xedb88320u;
+        } else {
+            crc >>= 1;
+        }
+    }
+    return crc;
+}
+
 /**
  * @brief CRC32 calculation
  *
@@ -56,14 +75,7 @@ namespace fixposition {
 inline uint32_t nov_crc32(const uint8_t* data, const int size) {
     uint32_t crc = 0;
     for (int i = 0; i < size; i++) {
-        crc ^= data[i];
-        for (int j = 0; j < 8; j++) {
-            if (crc & 1) {
-                crc = (crc >> 1) ^ 0xedb88320u;
-            } else {
-                crc >>= 1;
-            }
-        }
+        crc = nov_crc32_update(crc, data[i]);
     }
     return crc;
 }
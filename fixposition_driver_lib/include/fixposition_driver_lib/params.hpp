@@ -16,6 +16,7 @@
 #define __FIXPOSITION_DRIVER_LIB_PARAMS_HPP__
 
 /* SYSTEM / STL */
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -25,25 +26,164 @@
 
 namespace fixposition {
 
-enum class INPUT_TYPE { TCP = 1, SERIAL = 2 };
+//! NONE: no connection, recorded data is fed with FixpositionDriver::Process()
+enum class INPUT_TYPE { NONE = 0, TCP = 1, SERIAL = 2 };
+
+/**
+ * @brief How the main loop waits for data, trading latency against wakeups and CPU
+ *
+ */
+enum class READ_STRATEGY {
+    RATE = 0,       //!< poll the connection at the loop rate
+    BLOCKING = 1,   //!< sleep until data arrives
+    BUSY_POLL = 2,  //!< spin for a bounded time, then sleep until data arrives
+    COALESCED = 3,  //!< sleep until a minimum batch of data arrived or the batch timer expired
+};
+
+struct ReadStrategyParams {
+    READ_STRATEGY strategy = READ_STRATEGY::RATE;
+    double spin_time = 0.0005;       //!< BUSY_POLL: time in [s] to spin before sleeping
+    int min_batch = 512;             //!< COALESCED: bytes to wait for before waking up
+    double max_batch_delay = 0.005;  //!< COALESCED: max time in [s] data waits for the batch to fill up
+};
 
 struct FpOutputParams {
-    int rate;                          //!< loop rate of the main read loop
+    int rate;                          //!< loop rate of the main read loop, minimum rate for the other strategies
     double reconnect_delay;            //!< wait time in [s] until retry connection
     INPUT_TYPE type;                   //!< TCP or SERIAL
     std::vector<std::string> formats;  //!< data formats to convert, support "FP" and "LLH" for now
 
-    std::string ip;    //!< IP address for TCP connection
-    std::string port;  //!< Port for TCP connection
-    int baudrate;      //!< baudrate of serial connection
+    std::string ip;                 //!< IP address for TCP connection
+    std::string port;               //!< Port for TCP connection
+    int baudrate;                   //!< baudrate of serial connection
+    bool auto_baud = false;         //!< detect the baudrate of the sensor, starting with baudrate
+    double auto_baud_window = 0.1;  //!< max time in [s] to listen for frames at each candidate baudrate
+
+    double stats_period = 0.0;       //!< period in [s] to report message stream statistics, 0 to disable
+    bool llh_from_odometry = false;  //!< derive NavSatFix from ODOMETRY instead of converting FP,LLH
+    double status_heartbeat = 1.0;   //!< period in [s] to republish an unchanged status, 0 to disable
+
+    ReadStrategyParams read;  //!< how to wait for data
 };
+
+/**
+ * @brief Location and scaling of one wheel speed signal inside a CAN frame, DBC conventions
+ *
+ */
+struct CanSignalParams {
+    uint32_t can_id = 0;      //!< CAN identifier of the frame carrying the signal, > 0x7FF for extended frames
+    int start_bit = 0;        //!< start bit, LSB for little endian (Intel), MSB for big endian (Motorola) signals
+    int length = 16;          //!< signal length in bits
+    bool big_endian = false;  //!< Motorola byte order
+    bool is_signed = false;   //!< two's complement signal
+    double scale = 1.0;       //!< speed in [mm/s] or [mrad/s] = raw * scale + offset
+    double offset = 0.0;      //!< see scale
+};
+
+struct CanInputParams {
+    std::string interface;                 //!< SocketCAN interface, e.g. "can0" or "vcan0", empty to disable
+    std::vector<CanSignalParams> signals;  //!< 1, 2 or 4 signals, in the same order as the speed message
+};
+
+/**
+ * @brief RTCM3 corrections to forward to the sensor, see Rtcm3Input
+ *
+ */
+struct Rtcm3InputParams {
+    std::string host = "127.0.0.1";  //!< IPv4 address of the local caster or NTRIP client
+    int port = 0;                    //!< its TCP port, 0 to disable
+    std::string topic;               //!< ROS topic with rtcm_msgs/Message corrections, empty to disable
+};
+
 struct CustomerInputParams {
     std::string speed_topic;
+    CanInputParams can;      //!< optional wheel speed input directly from CAN
+    Rtcm3InputParams rtcm3;  //!< optional corrections for the sensor
+};
+
+/**
+ * @brief Priorities and budgets for dropping low-value messages under overload, see LoadShedder
+ *
+ */
+struct LoadSheddingParams {
+    bool enabled = false;        //!< enable load shedding
+    double time_budget = 0.002;  //!< max processing time for the data of one read in [s]
+    int backlog_budget = 4096;   //!< max bytes still waiting on the connection after a read
+    int decimation = 4;          //!< keep one of this many messages of a type that is decimated
+    //! message types (FP_A header, NOV_B name or output name), same order as priorities
+    std::vector<std::string> types = {"ODOMETRY", "CORRIMU", "RAWIMU", "BESTGNSSPOS", "LLH", "TF", "YPR"};
+    //! priority per type, 0 is never shed, higher numbers are shed first. Types not listed have priority 1.
+    std::vector<int> priorities = {0, 0, 1, 1, 2, 2, 2};
+};
+
+/**
+ * @brief Static transform from the sensor's POI to a vehicle frame, see StaticExtrinsic
+ *
+ */
+struct ExtrinsicParams {
+    std::string frame_id;                                 //!< vehicle frame, e.g. "base_link", empty to disable
+    std::vector<double> translation = {0.0, 0.0, 0.0};    //!< position of the vehicle frame in the POI frame [m]
+    std::vector<double> rotation = {1.0, 0.0, 0.0, 0.0};  //!< orientation of the vehicle frame in the POI frame (wxyz)
+};
+
+/**
+ * @brief Compact odometry telemetry, see TelemetryEncoder
+ *
+ */
+struct TelemetryParams {
+    bool enabled = false;        //!< encode telemetry packets from ODOMETRY
+    int keyframe_interval = 10;  //!< every n-th packet is a keyframe, the others are deltas
+};
+
+/**
+ * @brief Host to GPS clock model, see ClockModel
+ *
+ */
+struct ClockModelParams {
+    bool enabled = false;                         //!< estimate the host to GPS time mapping
+    std::string stream = "ODOMETRY";              //!< stream to learn from, as in the stream statistics
+    double delay = 0.0;                           //!< known minimum output delay of the stream in [s]
+    double window = 1.0;                          //!< the lowest delay sample of each window of this length in [s]...
+    int num_windows = 30;                         //!< ...of the latest windows are fitted
+    std::string shm_name = "/fixposition_clock";  //!< shared memory object for other processes, empty to disable
+};
+
+/**
+ * @brief Hand the sensor connection to a new driver instance, see HotRestart
+ *
+ */
+struct HotRestartParams {
+    std::string socket;    //!< Unix socket path to meet the previous/next instance, empty to disable
+    double timeout = 1.0;  //!< max time to wait for the previous instance to hand over in [s]
+};
+
+/**
+ * @brief Black-box recording of the latest decoded samples, see FlightRecorder
+ *
+ */
+struct FlightRecorderParams {
+    std::string file;  //!< ring file, e.g. "/var/lib/fixposition/flight_recorder.bin", empty to disable
+    int size = 32;     //!< size of the ring in [MiB], 128 bytes per sample
+};
+
+/**
+ * @brief Counters of the driver in shared memory, see DriverStatsWriter and fixposition_top
+ *
+ */
+struct StatsParams {
+    std::string shm_name;  //!< shared memory object, e.g. "/fixposition_stats", empty to disable
 };
 
 struct FixpositionDriverParams {
     FpOutputParams fp_output;
     CustomerInputParams customer_input;
+    LoadSheddingParams load_shedding;
+    ExtrinsicParams extrinsic;
+    TelemetryParams telemetry;
+    ClockModelParams clock;
+    HotRestartParams hot_restart;
+    FlightRecorderParams flight_recorder;
+    StatsParams stats;
 };
 
 }  // namespace fixposition
@@ -16,6 +16,7 @@
 #define __FIXPOSITION_DRIVER_LIB_PARSER__
 
 /* SYSTEM / STL */
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -43,5 +44,33 @@ int IsNmeaMessage(const char* buf, const int size);
  */
 int IsNovMessage(const uint8_t* buf, const int size);
 
+/**
+ * @brief CRC-24Q of RTCM3 frames (and SBAS/Qualcomm), as in RTCM 10403.3 section 4.2
+ *
+ * @param[in] data
+ * @param[in] size
+ * @return uint32_t CRC in the lower 24 bits
+ */
+uint32_t rtcm3_crc24q(const uint8_t* data, const int size);
+
+/**
+ * @brief Check If msg is RTCM3
+ *
+ * @param[in] buf buffer ptr
+ * @param[in] size size
+ * @return int the length of the RTCM3 frame found, incl. header and CRC. If no RTCM3 found then 0. If size argument is
+ * too small then -1
+ */
+int IsRtcm3Message(const uint8_t* buf, const int size);
+
+/**
+ * @brief Get the message type of a FP_A sentence without splitting it, e.g. "ODOMETRY" for $FP,ODOMETRY,...
+ *
+ * @param[in] buf start of the sentence
+ * @param[in] size size of the sentence
+ * @return std::string message type, empty if it is not a FP_A sentence
+ */
+std::string GetFpaHeader(const char* buf, const int size);
+
 }  // namespace fixposition
 #endif  // __FIXPOSITION_DRIVER_LIB_HELPER__
@@ -0,0 +1,106 @@
+/**
+ *  @file
+ *  @brief Declaration of PerfCounters class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+#ifndef __FIXPOSITION_DRIVER_LIB_PERF_COUNTERS__
+#define __FIXPOSITION_DRIVER_LIB_PERF_COUNTERS__
+
+/* SYSTEM / STL */
+#include <array>
+#include <cstdint>
+
+/* EXTERNAL */
+
+/* PACKAGE */
+
+namespace fixposition {
+
+/**
+ * @brief Hardware performance counters of the calling thread (Linux perf_event_open), for the benchmarks
+ *
+ * Each counter is opened on its own, so counters the CPU or the VM does not provide are left out instead of failing
+ * all of them. If the kernel multiplexes the counters, the values are scaled to the full measuring time. Only user
+ * space is counted, which works with the default kernel.perf_event_paranoid of 2.
+ */
+class PerfCounters {
+   public:
+    enum Counter {
+        CYCLES,
+        INSTRUCTIONS,
+        BRANCH_MISSES,
+        L1D_MISSES,  //!< L1 data cache read misses
+        LLC_MISSES,  //!< last level cache misses
+        NUM_COUNTERS,
+    };
+
+    using Values = std::array<double, NUM_COUNTERS>;
+
+    /**
+     * @brief Construct a new PerfCounters object, does not open the counters yet
+     *
+     */
+    PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * @brief Destroy the PerfCounters object, closes the counters
+     *
+     */
+    ~PerfCounters();
+
+    /**
+     * @brief Open the counters, disabled
+     *
+     * @return true
+     * @return false none of them is available
+     */
+    bool Open();
+
+    /**
+     * @brief Check if a counter is available
+     *
+     * @param[in] counter
+     * @return true
+     * @return false
+     */
+    bool Available(const Counter counter) const { return fds_[counter] >= 0; }
+
+    /**
+     * @brief Reset and enable the counters
+     *
+     */
+    void Start();
+
+    /**
+     * @brief Disable the counters and read them
+     *
+     * @return const Values& counts since Start(), 0 for counters not available
+     */
+    const Values& Stop();
+
+    /**
+     * @brief Short name of a counter, e.g. for a table header
+     *
+     * @param[in] counter
+     * @return const char*
+     */
+    static const char* Name(const Counter counter);
+
+   private:
+    std::array<int, NUM_COUNTERS> fds_;  //!< counter file descriptors, -1 if not available
+    Values values_;                      //!< counts of the last measurement
+};
+
+}  // namespace fixposition
+#endif  // __FIXPOSITION_DRIVER_LIB_PERF_COUNTERS__
@@ -0,0 +1,130 @@
+/**
+ *  @file
+ *  @brief Declaration of Rtcm3Input class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+#ifndef __FIXPOSITION_DRIVER_LIB_RTCM3_INPUT__
+#define __FIXPOSITION_DRIVER_LIB_RTCM3_INPUT__
+
+/* SYSTEM / STL */
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/* EXTERNAL */
+
+/* PACKAGE */
+#include <fixposition_driver_lib/params.hpp>
+
+namespace fixposition {
+
+/**
+ * @brief Receive RTCM3 corrections from a local TCP source (caster, NTRIP client) or from the application
+ *
+ * The stream is split into frames, each validated with its CRC-24Q. Bytes outside valid frames are skipped, the framing
+ * resynchronizes at the next preamble. The observers get every valid frame, unmodified.
+ */
+class Rtcm3Input {
+   public:
+    //! frame is the RTCM3 frame incl. header and CRC, only valid during the call. arrival is the host monotonic time
+    //! in [s] of the data that completed the frame.
+    using Rtcm3Observer = std::function<void(const uint8_t* frame, const int size, const double arrival)>;
+
+    /**
+     * @brief Construct a new Rtcm3Input object, does not connect yet
+     *
+     * @param[in] params
+     */
+    Rtcm3Input(const Rtcm3InputParams& params);
+
+    /**
+     * @brief Destroy the Rtcm3Input object, close the connection
+     *
+     */
+    ~Rtcm3Input();
+
+    /**
+     * @brief Connect to the configured TCP source. Blocks until the connection is established or failed.
+     *
+     * @return true success
+     * @return false cannot connect
+     */
+    bool Open();
+
+    /**
+     * @brief Close the connection, a partial frame is dropped
+     *
+     */
+    void Close();
+
+    /**
+     * @brief Read all pending data without blocking and call the observers for every complete frame
+     *
+     * @return true data read or nothing to read
+     * @return false connection closed or failed, reopen it
+     */
+    bool Read();
+
+    /**
+     * @brief Frame corrections received by other means, e.g. from a ROS topic. Frames may be split across calls.
+     *
+     * @param[in] data
+     * @param[in] size
+     * @param[in] arrival host monotonic time in [s] when the data was received
+     */
+    void Process(const uint8_t* data, const int size, const double arrival);
+
+    /**
+     * @brief Socket file descriptor, -1 if not connected
+     *
+     * @return int
+     */
+    int GetFd() const { return fd_; }
+
+    /**
+     * @brief Number of frames with a wrong CRC since the start, they are dropped
+     *
+     * @return uint64_t
+     */
+    uint64_t GetCrcErrors() const { return crc_errors_; }
+
+    /**
+     * @brief Add Observer to call for every valid frame
+     *
+     * @param[in] ob
+     */
+    void AddObserver(Rtcm3Observer ob) { obs_.push_back(ob); }
+
+   private:
+    Rtcm3InputParams params_;
+    int fd_ = -1;
+    std::vector<uint8_t> buf_;  //!< data not framed yet: a partial frame
+    uint64_t crc_errors_ = 0;   //!< frames with a wrong CRC
+    std::vector<Rtcm3Observer> obs_;
+};
+
+/**
+ * @brief Get the epoch time of the observations in a RTCM3 frame, to measure the age of corrections
+ *
+ * Supported are the GPS RTK observables (1001-1004) and the MSM of GPS, Galileo, SBAS, QZSS, BeiDou and NavIC. GLONASS
+ * observations carry UTC(SU) time of day and station messages (e.g. 1005) no time at all, they return false.
+ *
+ * @param[in] frame RTCM3 frame incl. header and CRC
+ * @param[in] size
+ * @param[out] tow GPS time of week in [s]
+ * @return true
+ * @return false no observations with a GPS time of week
+ */
+bool GetRtcm3EpochTow(const uint8_t* frame, const int size, double& tow);
+
+}  // namespace fixposition
+#endif  // __FIXPOSITION_DRIVER_LIB_RTCM3_INPUT__
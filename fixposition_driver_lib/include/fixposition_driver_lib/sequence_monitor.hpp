@@ -0,0 +1,78 @@
+/**
+ *  @file
+ *  @brief Declaration of SequenceMonitor class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+#ifndef __FIXPOSITION_DRIVER_LIB_SEQUENCE_MONITOR__
+#define __FIXPOSITION_DRIVER_LIB_SEQUENCE_MONITOR__
+
+/* SYSTEM / STL */
+#include <cstdint>
+
+/* EXTERNAL */
+
+/* PACKAGE */
+#include <fixposition_driver_lib/time_conversions.hpp>
+
+namespace fixposition {
+
+/**
+ * @brief Statistics of one message stream
+ *
+ */
+struct SequenceStats {
+    uint64_t count = 0;         //!< messages seen
+    double nominal_step = 0.0;  //!< learned GPS time step between epochs in [s], 0 while still learning
+    uint64_t gaps = 0;          //!< number of times one or more epochs were missing
+    uint64_t missing = 0;       //!< estimated number of missing epochs
+    uint64_t duplicates = 0;    //!< messages with the same GPS time as the previous one
+    uint64_t out_of_order = 0;  //!< messages with an earlier GPS time than the latest one
+    double jitter = 0.0;        //!< smoothed inter-arrival jitter in [s], as in RFC 3550
+    double max_jitter = 0.0;    //!< largest single inter-arrival deviation in [s]
+};
+
+/**
+ * @brief Track the GPS time of consecutive messages of one stream
+ *
+ * The nominal step is learned as the smallest step of the first epochs (dropped epochs only make steps larger), and
+ * learned again if the rate changes. Arrival jitter compares the spacing of the arrival times with the spacing of the
+ * GPS times.
+ */
+class SequenceMonitor {
+   public:
+    /**
+     * @brief Account for the next message of the stream
+     *
+     * @param[in] stamp GPS time of the message
+     * @param[in] arrival host arrival time of the message in [s], monotonic clock
+     */
+    void Update(const times::GpsTime& stamp, const double arrival);
+
+    /**
+     * @brief Get the statistics
+     *
+     * @return const SequenceStats&
+     */
+    const SequenceStats& GetStats() const { return stats_; }
+
+   private:
+    static constexpr const int kLearnSteps = 10;  //!< steps to (re-)learn the nominal step from
+
+    SequenceStats stats_;
+    double last_gps_ = 0.0;      //!< latest GPS time in [s] since GPS epoch
+    double last_arrival_ = 0.0;  //!< arrival time of that message
+    double learn_min_ = 0.0;     //!< smallest step of the current (re-)learning run
+    int learn_count_ = 0;        //!< length of the current (re-)learning run
+};
+
+}  // namespace fixposition
+#endif  // __FIXPOSITION_DRIVER_LIB_SEQUENCE_MONITOR__
@@ -0,0 +1,206 @@
+/**
+ *  @file
+ *  @brief Declaration of StreamFramer class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+#ifndef __FIXPOSITION_DRIVER_LIB_STREAM_FRAMER__
+#define __FIXPOSITION_DRIVER_LIB_STREAM_FRAMER__
+
+/* SYSTEM / STL */
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/* EXTERNAL */
+
+/* PACKAGE */
+
+namespace fixposition {
+
+/**
+ * @brief Incremental framer for a byte stream containing NMEA (incl. FP_A) and NOV_B messages
+ *
+ * Unlike IsNmeaMessage() and IsNovMessage(), the parse state (position in the frame, running checksum, expected
+ * length, running CRC) is kept across calls of Process(), so a frame arriving in several reads is examined byte by byte
+ * exactly once. Only if a partial frame turns out to be invalid, its bytes after the first one are scanned again, which
+ * gives the same resynchronisation behaviour as the stateless functions.
+ *
+ * Frames are not copied: the observers get a pointer into the chunk passed to Process(). Only the bytes of a partial
+ * frame at the end of a chunk are kept, and a frame spanning chunks is assembled from them for the observers.
+ */
+class StreamFramer {
+   public:
+    enum class FrameType { NMEA, NOV_B };
+    enum class FrameError {
+        NMEA_CHECKSUM,  //!< complete NMEA sentence with a wrong checksum
+        NOV_CRC,        //!< complete NOV_B message with a wrong CRC
+    };
+
+    //! frame points into the chunk passed to Process(), or into the framer for a frame spanning chunks, and is only
+    //! valid during the call. offset is the stream position of the first byte of the frame, counted since construction
+    //! or the last Reset().
+    using FrameObserver =
+        std::function<void(const FrameType type, const uint8_t* frame, const int size, const uint64_t offset)>;
+    //! offset and size of the rejected frame, counted like for FrameObserver. Its bytes after the first are scanned
+    //! again, so a rejected frame may still contain valid ones.
+    using ErrorObserver = std::function<void(const FrameError error, const uint64_t offset, const int size)>;
+
+    /**
+     * @brief Construct a new StreamFramer object
+     *
+     */
+    StreamFramer();
+
+    /**
+     * @brief Feed the next chunk of the stream, observers are called for every complete and valid frame
+     *
+     * @param[in] data pointer to the received bytes
+     * @param[in] size number of received bytes
+     */
+    void Process(const uint8_t* data, const int size);
+
+    /**
+     * @brief Drop any partial frame and restart counting the stream offset, e.g. after a reconnect
+     *
+     */
+    void Reset();
+
+    /**
+     * @brief Add Observer to call for every complete frame
+     *
+     * @param[in] ob
+     */
+    void AddObserver(FrameObserver ob) { obs_.push_back(ob); }
+
+    /**
+     * @brief Add Observer to call for every frame failing its checksum or CRC
+     *
+     * @param[in] ob
+     */
+    void AddErrorObserver(ErrorObserver ob) { error_obs_.push_back(ob); }
+
+    /**
+     * @brief Number of bytes of the partial frame currently held
+     *
+     * @return int
+     */
+    int PendingSize() const { return static_cast<int>(pending_.size()); }
+
+    /**
+     * @brief Bytes of the partial frame currently held
+     *
+     * @return const std::vector<uint8_t>&
+     */
+    const std::vector<uint8_t>& GetPending() const { return pending_; }
+
+    /**
+     * @brief Stream offset of the next byte, i.e. the number of bytes fed since the last Reset()
+     *
+     * @return uint64_t
+     */
+    uint64_t GetOffset() const { return fed_; }
+
+    /**
+     * @brief Continue a stream of another framer, from its GetPending() and GetOffset()
+     *
+     * @param[in] pending bytes of the partial frame
+     * @param[in] size number of bytes
+     * @param[in] offset stream offset of the next byte
+     */
+    void Restore(const uint8_t* pending, const int size, const uint64_t offset);
+
+   private:
+    enum class State {
+        IDLE,       //!< searching for a preamble
+        NMEA_BODY,  //!< between '$' and '*'
+        NMEA_CK1,   //!< first checksum digit
+        NMEA_CK2,   //!< second checksum digit
+        NMEA_CR,    //!< '\r'
+        NMEA_LF,    //!< '\n'
+        NOV_SYNC2,  //!< second sync byte
+        NOV_SYNC3,  //!< third sync byte, long or short header
+        NOV_DATA,   //!< header, payload and CRC
+    };
+
+    enum class Result { CONTINUE, FAIL };
+
+    /**
+     * @brief Advance the state machine by one byte
+     *
+     * @param[in] byte
+     * @return Result FAIL if the partial frame (including byte) is not valid
+     */
+    Result Step(const uint8_t byte);
+
+    /**
+     * @brief Process one byte and resynchronise on failure
+     *
+     * @param[in] byte
+     */
+    void Feed(const uint8_t byte);
+
+    /**
+     * @brief Drop the partial frame and go back to IDLE
+     *
+     */
+    void ResetFrame();
+
+    /**
+     * @brief Byte of the stream, from the current chunk or from the bytes kept of the previous ones
+     *
+     * @param[in] offset stream offset, at least pending_start_ and less than fed_
+     * @return uint8_t
+     */
+    uint8_t ByteAt(const uint64_t offset) const;
+
+    /**
+     * @brief Byte of the current frame
+     *
+     * @param[in] idx index in the frame, less than frame_size_
+     * @return uint8_t
+     */
+    uint8_t FrameByte(const int idx) const { return ByteAt(frame_start_ + idx); }
+
+    /**
+     * @brief Call the observers for the current frame and go back to IDLE
+     *
+     * @param[in] type
+     */
+    void Emit(const FrameType type);
+
+    /**
+     * @brief Call the error observers for the current frame
+     *
+     * @param[in] error
+     */
+    void EmitError(const FrameError error);
+
+    State state_;
+    const uint8_t* data_;            //!< chunk being processed
+    uint64_t data_start_;            //!< stream offset of data_[0]
+    std::vector<uint8_t> pending_;   //!< bytes of the partial frame at the end of the previous chunks
+    uint64_t pending_start_;         //!< stream offset of pending_[0]
+    std::vector<uint8_t> spanning_;  //!< a frame spanning chunks, assembled for the observers
+    uint64_t frame_start_;           //!< stream offset of the first byte of the current frame
+    int frame_size_;                 //!< bytes of the current frame stepped so far
+    uint8_t nmea_ck_;                //!< running XOR checksum of the NMEA sentence
+    int nov_len_;                    //!< expected NOV_B length incl. CRC, 0 if not yet known
+    uint32_t nov_crc_;               //!< running CRC32 of the NOV_B message
+    uint64_t fed_;                   //!< number of bytes fed since the last Reset()
+    uint64_t pos_;                   //!< stream offset of the byte being stepped
+
+    std::vector<FrameObserver> obs_;
+    std::vector<ErrorObserver> error_obs_;
+};
+
+}  // namespace fixposition
+#endif  // __FIXPOSITION_DRIVER_LIB_STREAM_FRAMER__
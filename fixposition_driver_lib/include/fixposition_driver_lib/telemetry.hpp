@@ -0,0 +1,108 @@
+/**
+ *  @file
+ *  @brief Declaration of TelemetryEncoder and TelemetryDecoder classes
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+#ifndef __FIXPOSITION_DRIVER_LIB_TELEMETRY__
+#define __FIXPOSITION_DRIVER_LIB_TELEMETRY__
+
+/* SYSTEM / STL */
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/* EXTERNAL */
+
+/* PACKAGE */
+#include <fixposition_driver_lib/msg_data.hpp>
+#include <fixposition_driver_lib/params.hpp>
+
+namespace fixposition {
+
+static constexpr const int kTelemetryNumValues = 11;           //!< values per packet
+static constexpr const double kTelemetryQuatScale = 1e5;       //!< quaternion component resolution is 1e-5
+static constexpr const uint8_t kTelemetryKeyframeFlag = 0x80;  //!< flags bit of keyframes
+static constexpr const int kTelemetryMaxPacketSize = 2 + kTelemetryNumValues * 10;  //!< a varint has max 10 bytes
+
+/**
+ * @brief Quantize odometry and encode it as keyframes or deltas to the previous sample, for low-bandwidth links
+ *
+ * Packet layout:
+ *
+ *     | flags (1) | sequence (1) | 11 zigzag varints |
+ *
+ * flags bit 7 marks a keyframe. The values are the GPS time in [ms], the ECEF position in [mm], the orientation
+ * quaternion w, x, y, z in units of 1 / kTelemetryQuatScale and the velocity in [mm/s]. Keyframes carry the quantized
+ * values, other packets the difference to the previous packet, so a lost packet invalidates everything up to the next
+ * keyframe. Quantization errors do not accumulate, the deltas are taken between quantized values.
+ */
+class TelemetryEncoder {
+   public:
+    /**
+     * @brief Construct a new TelemetryEncoder object
+     *
+     * @param[in] params
+     */
+    TelemetryEncoder(const TelemetryParams& params);
+
+    /**
+     * @brief Encode the next sample
+     *
+     * @param[in] odometry pose in ECEF, velocity in the body frame
+     * @param[out] packet encoded packet, replaces the content
+     */
+    void Encode(const OdometryData& odometry, std::vector<uint8_t>& packet);
+
+    /**
+     * @brief Send a keyframe next, e.g. when the receiver reported a lost packet
+     *
+     */
+    void ForceKeyframe() { since_keyframe_ = -1; }
+
+   private:
+    TelemetryParams params_;
+    int since_keyframe_;                             //!< packets since the last keyframe, -1 to force one
+    uint8_t seq_;                                    //!< sequence number of the next packet
+    std::array<int64_t, kTelemetryNumValues> prev_;  //!< quantized values of the previous packet
+};
+
+/**
+ * @brief Decode the packets of TelemetryEncoder
+ *
+ */
+class TelemetryDecoder {
+   public:
+    /**
+     * @brief Construct a new TelemetryDecoder object
+     *
+     */
+    TelemetryDecoder() : synced_(false), seq_(0) {}
+
+    /**
+     * @brief Decode one packet
+     *
+     * @param[in] packet
+     * @param[in] size
+     * @param[out] odometry decoded sample, covariances are not transmitted and set to zero
+     * @return true sample decoded
+     * @return false malformed packet, or a delta packet after a lost packet (wait for the next keyframe)
+     */
+    bool Decode(const uint8_t* packet, const int size, OdometryData& odometry);
+
+   private:
+    bool synced_;                                    //!< prev_ holds the values of the previous packet
+    uint8_t seq_;                                    //!< sequence number of the previous packet
+    std::array<int64_t, kTelemetryNumValues> prev_;  //!< quantized values of the previous packet
+};
+
+}  // namespace fixposition
+#endif  // __FIXPOSITION_DRIVER_LIB_TELEMETRY__
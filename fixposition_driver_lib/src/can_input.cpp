@@ -0,0 +1,183 @@
+/**
+ *  @file
+ *  @brief Implementation of CanWheelSpeedInput class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <errno.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <iostream>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/can_input.hpp>
+
+namespace fixposition {
+
+static constexpr const uint32_t kCanMaxStandardId = 0x7ff;
+
+bool ExtractCanSignal(const CanSignalParams& signal, const uint8_t* data, const int dlc, int64_t& raw) {
+    if ((signal.length < 1) || (signal.length > 64) || (signal.start_bit < 0)) {
+        return false;
+    }
+
+    uint64_t value = 0;
+    if (signal.big_endian) {
+        // Motorola: start bit is the MSB, walk towards the LSB, continuing at bit 7 of the next byte
+        int bit = signal.start_bit;
+        for (int i = 0; i < signal.length; i++) {
+            if (bit / 8 >= dlc) {
+                return false;
+            }
+            value = (value << 1) | ((data[bit / 8] >> (bit % 8)) & 1u);
+            bit = (bit % 8 == 0) ? bit + 15 : bit - 1;
+        }
+    } else {
+        // Intel: start bit is the LSB, bits counted upwards through the bytes
+        if ((signal.start_bit + signal.length + 7) / 8 > dlc) {
+            return false;
+        }
+        for (int i = signal.length - 1; i >= 0; i--) {
+            const int bit = signal.start_bit + i;
+            value = (value << 1) | ((data[bit / 8] >> (bit % 8)) & 1u);
+        }
+    }
+
+    if (signal.is_signed && (signal.length < 64) && (value & (1ull << (signal.length - 1)))) {
+        value |= ~0ull << signal.length;  // sign extension
+    }
+    raw = static_cast<int64_t>(value);
+    return true;
+}
+
+CanWheelSpeedInput::CanWheelSpeedInput(const CanInputParams& params)
+    : params_(params), speeds_(params.signals.size(), 0), fresh_(params.signals.size(), false) {}
+
+CanWheelSpeedInput::~CanWheelSpeedInput() { Close(); }
+
+bool CanWheelSpeedInput::Open() {
+    Close();
+
+    fd_ = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK, CAN_RAW);
+    if (fd_ < 0) {
+        std::cerr << "Error in CAN socket creation: " << strerror(errno) << "\n";
+        return false;
+    }
+
+    // Only wake up for the frames carrying the configured signals
+    std::vector<struct can_filter> filters;
+    for (const auto& signal : params_.signals) {
+        struct can_filter filter;
+        if (signal.can_id > kCanMaxStandardId) {
+            filter.can_id = signal.can_id | CAN_EFF_FLAG;
+            filter.can_mask = CAN_EFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG;
+        } else {
+            filter.can_id = signal.can_id;
+            filter.can_mask = CAN_SFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG;
+        }
+        filters.push_back(filter);
+    }
+    if (!filters.empty()) {
+        setsockopt(fd_, SOL_CAN_RAW, CAN_RAW_FILTER, filters.data(), filters.size() * sizeof(struct can_filter));
+    }
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, params_.interface.c_str(), IFNAMSIZ - 1);
+    if (ioctl(fd_, SIOCGIFINDEX, &ifr) < 0) {
+        std::cerr << "Unknown CAN interface " << params_.interface << ": " << strerror(errno) << "\n";
+        Close();
+        return false;
+    }
+
+    struct sockaddr_can addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    if (bind(fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        std::cerr << "Error on binding CAN socket to " << params_.interface << ": " << strerror(errno) << "\n";
+        Close();
+        return false;
+    }
+
+    std::cout << "CAN wheelspeed input on " << params_.interface << ".\n";
+    return true;
+}
+
+void CanWheelSpeedInput::Close() {
+    if (fd_ != -1) {
+        close(fd_);
+        fd_ = -1;
+    }
+    fresh_.assign(fresh_.size(), false);
+}
+
+bool CanWheelSpeedInput::Read() {
+    if (fd_ < 0) {
+        return false;
+    }
+
+    struct can_frame frame;
+    while (true) {
+        const ssize_t rv = read(fd_, &frame, sizeof(frame));
+        if (rv < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            /* all pending frames processed */
+            return true;
+        }
+        if (rv < 0) {
+            std::cerr << "CAN read error: " << strerror(errno) << "\n";
+            return false;
+        }
+        if (rv != sizeof(frame) || (frame.can_id & (CAN_RTR_FLAG | CAN_ERR_FLAG))) {
+            continue;
+        }
+        const uint32_t can_id = frame.can_id & ((frame.can_id & CAN_EFF_FLAG) ? CAN_EFF_MASK : CAN_SFF_MASK);
+        ProcessFrame(can_id, frame.data, frame.can_dlc);
+    }
+}
+
+void CanWheelSpeedInput::ProcessFrame(const uint32_t can_id, const uint8_t* data, const int dlc) {
+    bool updated = false;
+    for (std::size_t i = 0; i < params_.signals.size(); i++) {
+        const auto& signal = params_.signals[i];
+        int64_t raw = 0;
+        if (signal.can_id != can_id || !ExtractCanSignal(signal, data, dlc, raw)) {
+            continue;
+        }
+        speeds_[i] = static_cast<int>(std::lround(raw * signal.scale + signal.offset));
+        fresh_[i] = true;
+        updated = true;
+    }
+
+    // Only output complete sets, so that all values in one RAWDMI belong to the same time
+    if (!updated) {
+        return;
+    }
+    for (const bool fresh : fresh_) {
+        if (!fresh) {
+            return;
+        }
+    }
+    fresh_.assign(fresh_.size(), false);
+    for (auto& ob : obs_) {
+        ob(speeds_);
+    }
+}
+
+}  // namespace fixposition
@@ -0,0 +1,448 @@
+/**
+ *  @file
+ *  @brief Offline analysis of a recorded sensor output (optionally with its RTKLIB .tag file)
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/nov_type.hpp>
+#include <fixposition_driver_lib/sequence_monitor.hpp>
+#include <fixposition_driver_lib/stream_framer.hpp>
+
+using fixposition::StreamFramer;
+
+static constexpr const int kTagHeaderSize = 64;     //!< "TIMETAG RTKLIB ..." and the tick frequency
+static constexpr const int kTagTimeSize = 16;       //!< start time: time_t (int64) and fractional seconds (double)
+static constexpr const int kTagRecordSize = 12;     //!< tick in [ms] (uint32) and file position (uint64)
+static constexpr const int kChunkSize = 1 << 20;    //!< chunk size without .tag file
+static constexpr const double kBitsPerByte = 10.0;  //!< 8N1: start bit, 8 data bits, stop bit
+
+/**
+ * @brief Chunk of the capture and the time it was received, from the .tag file
+ *
+ */
+struct TagRecord {
+    uint32_t tick;  //!< [ms] since the start of the recording
+    uint64_t pos;   //!< file position of the first byte received at tick
+};
+
+/**
+ * @brief Statistics of one message type
+ *
+ */
+struct TypeStats {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+    double last_arrival = 0.0;
+    double dt_mean = 0.0;  //!< mean inter-arrival time in [s]
+    double dt_m2 = 0.0;    //!< sum of squared deviations from dt_mean (Welford)
+    double dt_max = 0.0;
+    fixposition::SequenceMonitor gps;  //!< GPS time sequence, only for types carrying a GPS time
+    double gps_first = 0.0;            //!< first GPS time in [s] since the GPS epoch
+    double gps_last = 0.0;             //!< latest GPS time in [s] since the GPS epoch
+};
+
+/**
+ * @brief A byte range of the capture
+ *
+ */
+struct Region {
+    uint64_t offset;
+    uint64_t size;
+};
+
+/**
+ * @brief Read the .tag file written next to the capture by RTKLIB (str2str/strsvr with -t)
+ *
+ * @param[in] path
+ * @param[out] start recording start time in [s] since 1970
+ * @param[out] records
+ * @return true
+ * @return false no usable .tag file
+ */
+static bool ReadTagFile(const std::string& path, double& start, std::vector<TagRecord>& records) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    uint8_t header[kTagHeaderSize + kTagTimeSize];
+    bool ok = (fread(header, 1, sizeof(header), file) == sizeof(header)) && (memcmp(header, "TIMETAG", 7) == 0);
+    if (ok) {
+        int64_t sec;
+        double frac;
+        memcpy(&sec, header + kTagHeaderSize, sizeof(sec));
+        memcpy(&frac, header + kTagHeaderSize + sizeof(sec), sizeof(frac));
+        start = sec + frac;
+        uint8_t rec[kTagRecordSize];
+        while (fread(rec, 1, sizeof(rec), file) == sizeof(rec)) {
+            TagRecord record;
+            memcpy(&record.tick, rec, sizeof(record.tick));
+            memcpy(&record.pos, rec + sizeof(record.tick), sizeof(record.pos));
+            records.push_back(record);
+        }
+        ok = !records.empty();
+    }
+    fclose(file);
+    return ok;
+}
+
+/**
+ * @brief Name of a message type: FP_A message name, NMEA talker and formatter or NOV_B message name (or id)
+ *
+ * @param[in] type
+ * @param[in] frame
+ * @param[in] size
+ * @return std::string
+ */
+static std::string TypeName(const StreamFramer::FrameType type, const uint8_t* frame, const int size) {
+    if (type == StreamFramer::FrameType::NOV_B) {
+        fixposition::Oem7MessageCommonHeaderMem header;
+        memcpy(&header, frame, sizeof(header));
+        switch (static_cast<fixposition::MessageId>(header.message_id)) {
+            case fixposition::MessageId::BESTGNSSPOS:
+                return "BESTGNSSPOS";
+            case fixposition::MessageId::BESTPOS:
+                return "BESTPOS";
+            case fixposition::MessageId::BESTVEL:
+                return "BESTVEL";
+            case fixposition::MessageId::RAWIMU:
+                return "NOV_RAWIMU";
+            case fixposition::MessageId::INSPVAX:
+                return "INSPVAX";
+            case fixposition::MessageId::HEADING2:
+                return "HEADING2";
+            default:
+                return "NOV_B_" + std::to_string(header.message_id);
+        }
+    }
+
+    // "$FP,NAME,..." -> NAME, "$GPGGA,..." -> GPGGA
+    const char* begin = reinterpret_cast<const char*>(frame) + 1;
+    const char* end = reinterpret_cast<const char*>(frame) + size;
+    const char* comma = std::find(begin, end, ',');
+    if ((comma - begin == 2) && (memcmp(begin, "FP", 2) == 0) && (comma != end)) {
+        begin = comma + 1;
+        comma = std::find(begin, end, ',');
+    }
+    return std::string(begin, std::find(begin, comma, '*'));
+}
+
+/**
+ * @brief GPS time of a frame: fields 3 and 4 of FP_A messages, header of NOV_B messages with a long header
+ *
+ * @param[in] type
+ * @param[in] frame
+ * @param[in] size
+ * @param[out] stamp
+ * @return true
+ * @return false the message has no (valid) GPS time
+ */
+static bool FrameGpsTime(const StreamFramer::FrameType type, const uint8_t* frame, const int size,
+                         fixposition::times::GpsTime& stamp) {
+    if (type == StreamFramer::FrameType::NOV_B) {
+        if ((frame[2] != fixposition::SYNC_CHAR_3_LONG) ||
+            (size < static_cast<int>(sizeof(fixposition::Oem7MessageHeaderMem)))) {
+            return false;
+        }
+        fixposition::Oem7MessageHeaderMem header;
+        memcpy(&header, frame, sizeof(header));
+        stamp = fixposition::times::GpsTime(header.gps_week, header.gps_milliseconds * 1e-3);
+        return header.gps_week > 0;
+    }
+
+    if ((size < 4) || (memcmp(frame, "$FP,", 4) != 0)) {
+        return false;
+    }
+    // The sentence ends with "*CK\r\n", so strtol() and strtod() cannot run past it
+    const char* field = reinterpret_cast<const char*>(frame);
+    const char* end = field + size;
+    for (int i = 0; i < 3; i++) {
+        field = std::find(field, end, ',');
+        if (field == end) {
+            return false;
+        }
+        field++;
+    }
+    char* next;
+    const long week = strtol(field, &next, 10);
+    if ((next == field) || (*next != ',')) {
+        return false;
+    }
+    field = next + 1;
+    const double tow = strtod(field, &next);
+    if ((next == field) || (week <= 0)) {
+        return false;
+    }
+    stamp = fixposition::times::GpsTime(static_cast<int>(week), tow);
+    return true;
+}
+
+static void PrintUsage(const char* name) {
+    printf("Usage: %s [-b baud] [-t tag file] [-n max listed] <recorded sensor output>\n", name);
+    printf("  -b  baud rate of the link, for the utilization (default 115200)\n");
+    printf("  -t  RTKLIB .tag file with the arrival times (default <recorded sensor output>.tag, if it exists)\n");
+    printf("  -n  number of failures and garbage regions listed with their offsets (default 20)\n");
+}
+
+int main(int argc, char** argv) {
+    double baud = 115200.0;
+    std::string tag_path;
+    std::size_t max_listed = 20;
+    int opt;
+    while ((opt = getopt(argc, argv, "b:t:n:h")) != -1) {
+        switch (opt) {
+            case 'b':
+                baud = atof(optarg);
+                break;
+            case 't':
+                tag_path = optarg;
+                break;
+            case 'n':
+                max_listed = static_cast<std::size_t>(std::max(0, atoi(optarg)));
+                break;
+            default:
+                PrintUsage(argv[0]);
+                return 1;
+        }
+    }
+    if ((optind >= argc) || (baud <= 0.0)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    const std::string path = argv[optind];
+
+    // Map the capture, the framer reads it in place
+    const int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if ((fd < 0) || (fstat(fd, &st) != 0)) {
+        printf("Cannot open %s\n", path.c_str());
+        return 1;
+    }
+    const uint64_t file_size = st.st_size;
+    const uint8_t* data = nullptr;
+    if (file_size > 0) {
+        void* addr = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            printf("Cannot map %s\n", path.c_str());
+            close(fd);
+            return 1;
+        }
+        madvise(addr, file_size, MADV_SEQUENTIAL);
+        data = static_cast<const uint8_t*>(addr);
+    }
+    close(fd);
+
+    // Arrival times from the .tag file, if any. Without it, only GPS times are available.
+    double tag_start = 0.0;
+    std::vector<TagRecord> tags;
+    const bool tag_given = !tag_path.empty();
+    if (!tag_given) {
+        tag_path = path + ".tag";
+    }
+    const bool have_tags = ReadTagFile(tag_path, tag_start, tags);
+    if (tag_given && !have_tags) {
+        printf("Cannot read %s\n", tag_path.c_str());
+        return 1;
+    }
+
+    std::unordered_map<std::string, TypeStats> types;
+    std::map<StreamFramer::FrameError, uint64_t> error_counts;
+    std::vector<std::pair<StreamFramer::FrameError, Region>> errors;
+    std::vector<Region> garbage;
+    uint64_t garbage_count = 0, garbage_bytes = 0, garbage_max = 0;
+    uint64_t frame_end = 0;  // end of the previous valid frame
+    double arrival = 0.0;    // arrival time of the current chunk in [s] since the start of the recording
+    std::vector<uint64_t> bytes_per_sec;
+
+    const auto add_garbage = [&](const uint64_t begin, const uint64_t end) {
+        if (end <= begin) {
+            return;
+        }
+        garbage_count++;
+        garbage_bytes += end - begin;
+        garbage_max = std::max(garbage_max, end - begin);
+        if (garbage.size() < max_listed) {
+            garbage.push_back({begin, end - begin});
+        }
+    };
+
+    StreamFramer framer;
+    framer.AddObserver(
+        [&](const StreamFramer::FrameType type, const uint8_t* frame, const int size, const uint64_t offset) {
+            add_garbage(frame_end, offset);
+            frame_end = offset + size;
+
+            TypeStats& stats = types[TypeName(type, frame, size)];
+            stats.count++;
+            stats.bytes += size;
+            if (have_tags) {
+                if (stats.count > 1) {
+                    const double dt = arrival - stats.last_arrival;
+                    const double delta = dt - stats.dt_mean;
+                    stats.dt_mean += delta / (stats.count - 1);
+                    stats.dt_m2 += delta * (dt - stats.dt_mean);
+                    stats.dt_max = std::max(stats.dt_max, dt);
+                }
+                stats.last_arrival = arrival;
+            }
+            fixposition::times::GpsTime stamp;
+            if (FrameGpsTime(type, frame, size, stamp)) {
+                const double gps = stamp.wno * static_cast<double>(fixposition::times::Constants::sec_per_week) +
+                                   stamp.tow;
+                if (stats.gps.GetStats().count == 0) {
+                    stats.gps_first = gps;
+                }
+                stats.gps_last = std::max(stats.gps_last, gps);
+                // Without arrival times, GPS time stands in for it: gaps are found, jitter is meaningless
+                stats.gps.Update(stamp, have_tags ? arrival : gps);
+            }
+        });
+    framer.AddErrorObserver([&](const StreamFramer::FrameError error, const uint64_t offset, const int size) {
+        error_counts[error]++;
+        if (errors.size() < max_listed) {
+            errors.push_back({error, {offset, static_cast<uint64_t>(size)}});
+        }
+    });
+
+    const auto t0 = std::chrono::steady_clock::now();
+    if (have_tags) {
+        for (std::size_t i = 0; i < tags.size(); i++) {
+            const uint64_t begin = std::min(tags[i].pos, file_size);
+            const uint64_t end = (i + 1 < tags.size()) ? std::min(tags[i + 1].pos, file_size) : file_size;
+            if (end <= begin) {
+                continue;
+            }
+            arrival = tags[i].tick * 1e-3;
+            const std::size_t sec = static_cast<std::size_t>(arrival);
+            if (sec >= bytes_per_sec.size()) {
+                bytes_per_sec.resize(sec + 1, 0);
+            }
+            bytes_per_sec[sec] += end - begin;
+            framer.Process(data + begin, static_cast<int>(end - begin));
+        }
+    } else {
+        for (uint64_t begin = 0; begin < file_size; begin += kChunkSize) {
+            framer.Process(data + begin, static_cast<int>(std::min<uint64_t>(kChunkSize, file_size - begin)));
+        }
+    }
+    add_garbage(frame_end, file_size - framer.PendingSize());
+    const double scan_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    // Duration of the recording: arrival times if known, otherwise the span of the GPS times
+    double duration = 0.0;
+    if (have_tags) {
+        duration = tags.back().tick * 1e-3 - tags.front().tick * 1e-3;
+    } else {
+        for (const auto& entry : types) {
+            const auto& stats = entry.second;
+            if (stats.gps.GetStats().count > 1) {
+                duration = std::max(duration, stats.gps_last - stats.gps_first);
+            }
+        }
+    }
+
+    // Report
+    printf("Capture:   %s, %.3f MB\n", path.c_str(), file_size * 1e-6);
+    if (have_tags) {
+        const time_t start_sec = static_cast<time_t>(tag_start);
+        char start_str[32];
+        strftime(start_str, sizeof(start_str), "%Y-%m-%d %H:%M:%S", gmtime(&start_sec));
+        printf("Tag file:  %s, %zu chunks, start %s UTC, duration %.3f s\n", tag_path.c_str(), tags.size(),
+               start_str, duration);
+    } else {
+        printf("Tag file:  none, duration %.3f s from GPS times, no arrival statistics\n", duration);
+    }
+    printf("Scan:      %.3f s, %.1f MB/s, %.2f GB/min\n\n", scan_time, file_size * 1e-6 / scan_time,
+           file_size * 1e-9 / scan_time * 60.0);
+
+    std::vector<std::pair<std::string, const TypeStats*>> sorted;
+    for (const auto& entry : types) {
+        sorted.push_back({entry.first, &entry.second});
+    }
+    std::sort(sorted.begin(), sorted.end());
+    printf("%-16s %9s %11s %9s %10s %10s %10s %9s %7s %7s %10s %10s\n", "type", "count", "bytes", "rate[Hz]",
+           "dt[ms]", "dt_std[ms]", "dt_max[ms]", "step[ms]", "gaps", "missing", "jitter[ms]", "jmax[ms]");
+    uint64_t frame_bytes = 0;
+    for (const auto& entry : sorted) {
+        const TypeStats& stats = *entry.second;
+        const fixposition::SequenceStats& gps = stats.gps.GetStats();
+        frame_bytes += stats.bytes;
+        const double rate = duration > 0.0 ? stats.count / duration : 0.0;
+        const double dt_std = stats.count > 2 ? std::sqrt(stats.dt_m2 / (stats.count - 2)) : 0.0;
+        printf("%-16s %9lu %11lu %9.2f ", entry.first.c_str(), stats.count, stats.bytes, rate);
+        if (have_tags && stats.count > 1) {
+            printf("%10.2f %10.2f %10.2f ", stats.dt_mean * 1e3, dt_std * 1e3, stats.dt_max * 1e3);
+        } else {
+            printf("%10s %10s %10s ", "-", "-", "-");
+        }
+        if (gps.count > 0) {
+            printf("%9.2f %7lu %7lu ", gps.nominal_step * 1e3, gps.gaps, gps.missing);
+            if (have_tags) {
+                printf("%10.2f %10.2f\n", gps.jitter * 1e3, gps.max_jitter * 1e3);
+            } else {
+                printf("%10s %10s\n", "-", "-");
+            }
+        } else {
+            printf("%9s %7s %7s %10s %10s\n", "-", "-", "-", "-", "-");
+        }
+    }
+
+    printf("\nFailures:  %lu NMEA checksum, %lu NOV_B CRC\n", error_counts[StreamFramer::FrameError::NMEA_CHECKSUM],
+           error_counts[StreamFramer::FrameError::NOV_CRC]);
+    for (const auto& error : errors) {
+        printf("  %-14s offset %12lu size %5lu\n",
+               error.first == StreamFramer::FrameError::NMEA_CHECKSUM ? "NMEA checksum" : "NOV_B CRC",
+               error.second.offset, error.second.size);
+    }
+    printf("Garbage:   %lu regions, %lu bytes (%.3f %%), largest %lu bytes\n", garbage_count, garbage_bytes,
+           file_size > 0 ? 100.0 * garbage_bytes / file_size : 0.0, garbage_max);
+    for (const auto& region : garbage) {
+        printf("  offset %12lu size %8lu\n", region.offset, region.size);
+    }
+    if (framer.PendingSize() > 0) {
+        printf("Truncated: %d bytes of a partial frame at the end\n", framer.PendingSize());
+    }
+
+    printf("\nLink:      %.0f baud, 8N1\n", baud);
+    if (duration > 0.0) {
+        const double util = file_size * kBitsPerByte / (baud * duration);
+        printf("  mean     %.1f B/s, %.1f %% (frames %.1f %%)\n", file_size / duration, 100.0 * util,
+               100.0 * frame_bytes * kBitsPerByte / (baud * duration));
+    }
+    if (!bytes_per_sec.empty()) {
+        const auto peak = std::max_element(bytes_per_sec.begin(), bytes_per_sec.end());
+        printf("  peak     %lu B/s, %.1f %% at %ld s\n", *peak, 100.0 * *peak * kBitsPerByte / baud,
+               static_cast<long>(peak - bytes_per_sec.begin()));
+    }
+
+    if (data != nullptr) {
+        munmap(const_cast<uint8_t*>(data), file_size);
+    }
+    return 0;
+}
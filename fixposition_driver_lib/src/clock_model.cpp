@@ -0,0 +1,152 @@
+/**
+ *  @file
+ *  @brief Implementation of ClockModel and ClockShmWriter classes
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <new>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/clock_model.hpp>
+
+namespace fixposition {
+
+ClockModel::ClockModel(const ClockModelParams& params) : params_(params), window_best_({0.0, 0.0}) {
+    params_.num_windows = std::max(static_cast<int>(kMinWindows), params_.num_windows);
+}
+
+bool ClockModel::Update(const double gps, const double arrival) {
+    const double host = arrival - params_.delay;
+    if (estimate_.valid && std::abs(gps - HostToGps(estimate_, host)) > kResetThreshold) {
+        std::cout << "Clock model: sample " << gps - HostToGps(estimate_, host) << " s off the estimate, restarting\n";
+        samples_.clear();
+        window_open_ = false;
+        estimate_ = ClockEstimate();
+    }
+
+    if (!window_open_) {
+        window_open_ = true;
+        window_start_ = host;
+        window_best_ = {gps, host};
+    } else if (host - gps < window_best_.host - window_best_.gps) {
+        window_best_ = {gps, host};
+    }
+    if (host - window_start_ < params_.window) {
+        return false;
+    }
+
+    window_open_ = false;
+    samples_.push_back(window_best_);
+    while (static_cast<int>(samples_.size()) > params_.num_windows) {
+        samples_.pop_front();
+    }
+    Fit();
+    return true;
+}
+
+void ClockModel::Fit() {
+    // Relative to the oldest sample, GPS times are too large to sum up directly
+    const Sample& origin = samples_.front();
+    const double n = samples_.size();
+    double mean_host = 0.0, mean_gps = 0.0;
+    for (const auto& s : samples_) {
+        mean_host += (s.host - origin.host) / n;
+        mean_gps += (s.gps - origin.gps) / n;
+    }
+    double shh = 0.0, shg = 0.0;
+    for (const auto& s : samples_) {
+        const double dh = s.host - origin.host - mean_host;
+        shh += dh * dh;
+        shg += dh * (s.gps - origin.gps - mean_gps);
+    }
+    const double rate = shh > 0.0 ? shg / shh : 1.0;
+
+    double sum_sq = 0.0;
+    for (const auto& s : samples_) {
+        const double res = (s.gps - origin.gps - mean_gps) - rate * (s.host - origin.host - mean_host);
+        sum_sq += res * res;
+    }
+
+    estimate_.host_ref = samples_.back().host;
+    estimate_.gps_ref = origin.gps + mean_gps + rate * (estimate_.host_ref - origin.host - mean_host);
+    estimate_.drift = rate - 1.0;
+    estimate_.uncertainty = std::sqrt(sum_sq / n);
+    estimate_.valid = static_cast<int>(samples_.size()) >= kMinWindows;
+}
+
+ClockShmWriter::~ClockShmWriter() {
+    // The object stays for the next driver, readers mapping it must not go on with a frozen estimate
+    if (page_ != nullptr) {
+        Write(ClockEstimate());
+        Detach();
+    }
+}
+
+void ClockShmWriter::Detach() {
+    if (page_ != nullptr) {
+        munmap(page_, sizeof(ClockShmPage));
+        page_ = nullptr;
+    }
+}
+
+bool ClockShmWriter::Open(const std::string& name) {
+    const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "Cannot create shared memory " << name << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    void* addr = MAP_FAILED;
+    if (ftruncate(fd, sizeof(ClockShmPage)) == 0) {
+        addr = mmap(nullptr, sizeof(ClockShmPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "Cannot map shared memory " << name << ": " << strerror(errno) << "\n";
+        return false;
+    }
+
+    // A page set up by another driver is left as it is, that driver may still write it until it hands over. Readers
+    // only trust a new page once magic and version are set.
+    page_ = static_cast<ClockShmPage*>(addr);
+    if (page_->magic != kClockShmMagic || page_->version != kClockShmVersion) {
+        page_ = new (addr) ClockShmPage();
+        page_->version = kClockShmVersion;
+        page_->seq.store(0, std::memory_order_relaxed);
+        page_->valid.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        page_->magic = kClockShmMagic;
+    }
+    return true;
+}
+
+void ClockShmWriter::Write(const ClockEstimate& estimate) {
+    if (page_ == nullptr) {
+        return;
+    }
+    const uint32_t seq = page_->seq.load(std::memory_order_relaxed);
+    page_->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    page_->valid.store(estimate.valid ? 1 : 0, std::memory_order_relaxed);
+    page_->host_ref.store(estimate.host_ref, std::memory_order_relaxed);
+    page_->gps_ref.store(estimate.gps_ref, std::memory_order_relaxed);
+    page_->drift.store(estimate.drift, std::memory_order_relaxed);
+    page_->uncertainty.store(estimate.uncertainty, std::memory_order_relaxed);
+    page_->seq.store(seq + 2, std::memory_order_release);
+}
+
+}  // namespace fixposition
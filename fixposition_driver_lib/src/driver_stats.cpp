@@ -0,0 +1,173 @@
+/**
+ *  @file
+ *  @brief Implementation of DriverStatsWriter class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <iostream>
+#include <new>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/driver_stats.hpp>
+#include <fixposition_driver_lib/nov_type.hpp>
+
+namespace fixposition {
+
+DriverStatsWriter::~DriverStatsWriter() { Detach(); }
+
+void DriverStatsWriter::Detach() {
+    if (page_ != nullptr) {
+        munmap(page_, sizeof(StatsShmPage));
+        page_ = nullptr;
+    }
+}
+
+bool DriverStatsWriter::Open(const std::string& name) {
+    const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "Cannot create shared memory " << name << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    void* addr = MAP_FAILED;
+    if (ftruncate(fd, sizeof(StatsShmPage)) == 0) {
+        addr = mmap(nullptr, sizeof(StatsShmPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "Cannot map shared memory " << name << ": " << strerror(errno) << "\n";
+        return false;
+    }
+
+    // A page set up by another driver is left as it is, that driver may still count in it until it hands over
+    page_ = static_cast<StatsShmPage*>(addr);
+    if (page_->magic != kStatsShmMagic || page_->version != kStatsShmVersion) {
+        Reset();
+    }
+    return true;
+}
+
+void DriverStatsWriter::Start() {
+    if (page_ != nullptr && page_->pid != static_cast<uint32_t>(getpid())) {
+        Reset();
+    }
+}
+
+void DriverStatsWriter::Reset() {
+    // Readers only trust the page once magic and version are set, the counters start at zero. A new pid tells them
+    // not to compare with what they saw before.
+    page_->magic = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    page_ = new (page_) StatsShmPage();
+    page_->version = kStatsShmVersion;
+    page_->pid = getpid();
+    std::atomic_thread_fence(std::memory_order_release);
+    page_->magic = kStatsShmMagic;
+}
+
+StatsShmType& DriverStatsWriter::Type(const char* name, const int size) {
+    const int len = size < kStatsTypeNameSize ? size : kStatsTypeNameSize - 1;
+    const uint32_t num_types = page_->num_types.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < num_types; i++) {
+        StatsShmType& type = page_->types[i];
+        if (memcmp(type.name, name, len) == 0 && type.name[len] == '\0') {
+            return type;
+        }
+    }
+    // The last slot collects the types that do not fit
+    if (num_types == kStatsMaxTypes - 1) {
+        StatsShmType& other = page_->types[num_types];
+        snprintf(other.name, sizeof(other.name), "OTHER");
+        page_->num_types.store(num_types + 1, std::memory_order_release);
+        return other;
+    } else if (num_types == kStatsMaxTypes) {
+        return page_->types[num_types - 1];
+    }
+    StatsShmType& type = page_->types[num_types];
+    memcpy(type.name, name, len);
+    type.name[len] = '\0';
+    page_->num_types.store(num_types + 1, std::memory_order_release);
+    return type;
+}
+
+void DriverStatsWriter::Frame(const StreamFramer::FrameType type, const uint8_t* frame, const int size) {
+    if (page_ == nullptr) {
+        return;
+    }
+    StatsShmType* slot;
+    if (type == StreamFramer::FrameType::NOV_B) {
+        const uint16_t id = reinterpret_cast<const Oem7MessageHeaderMem*>(frame)->message_id;
+        if (id == static_cast<uint16_t>(MessageId::BESTGNSSPOS)) {
+            slot = &Type("BESTGNSSPOS", 11);
+        } else {
+            char name[kStatsTypeNameSize];
+            slot = &Type(name, snprintf(name, sizeof(name), "NOV_B_%u", id));
+        }
+    } else {
+        // FP_A messages by their header ("$FP,ODOMETRY,..."), other NMEA sentences by their address ("$GPGGA,...")
+        const char* str = reinterpret_cast<const char*>(frame);
+        const int start = (size > 4 && memcmp(str, "$FP,", 4) == 0) ? 4 : 1;
+        int end = start;
+        while (end < size && str[end] != ',' && str[end] != '*') {
+            end++;
+        }
+        slot = &Type(str + start, end - start);
+    }
+    Add(slot->frames, 1);
+    Add(slot->bytes, size);
+}
+
+void DriverStatsWriter::FrameError(const StreamFramer::FrameError error) {
+    if (page_ == nullptr) {
+        return;
+    }
+    Add(error == StreamFramer::FrameError::NOV_CRC ? page_->nov_crc_errors : page_->nmea_checksum_errors, 1);
+}
+
+void DriverStatsWriter::DecodeError(const std::string& type) {
+    if (page_ == nullptr) {
+        return;
+    }
+    Add(Type(type.data(), static_cast<int>(type.size())).errors, 1);
+}
+
+void DriverStatsWriter::Read(const int bytes, const double rx_delay, const double processing, const int backlog,
+                             const int pending) {
+    if (page_ == nullptr) {
+        return;
+    }
+    Add(page_->reads, 1);
+    Add(page_->bytes, bytes);
+    if (rx_delay > 0.0) {
+        Add(page_->rx_delay[StatsLatencyBin(rx_delay)], 1);
+    }
+    Add(page_->processing[StatsLatencyBin(processing)], 1);
+    page_->backlog.store(backlog, std::memory_order_relaxed);
+    page_->pending.store(pending, std::memory_order_relaxed);
+}
+
+void DriverStatsWriter::Connection(const bool connected, const std::size_t write_queue, const uint64_t write_dropped) {
+    if (page_ == nullptr) {
+        return;
+    }
+    page_->connected.store(connected ? 1 : 0, std::memory_order_relaxed);
+    page_->write_queue.store(write_queue, std::memory_order_relaxed);
+    page_->write_dropped.store(write_dropped, std::memory_order_relaxed);
+}
+
+}  // namespace fixposition
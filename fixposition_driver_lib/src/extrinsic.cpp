@@ -0,0 +1,85 @@
+/**
+ *  @file
+ *  @brief Implementation of StaticExtrinsic class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <iostream>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/extrinsic.hpp>
+
+namespace fixposition {
+
+/**
+ * @brief Skew symmetric matrix, [v]x * u = v x u
+ *
+ * @param[in] v
+ * @return Eigen::Matrix3d
+ */
+static Eigen::Matrix3d Skew(const Eigen::Vector3d& v) {
+    Eigen::Matrix3d m;
+    m << 0.0, -v.z(), v.y(), v.z(), 0.0, -v.x(), -v.y(), v.x(), 0.0;
+    return m;
+}
+
+StaticExtrinsic::StaticExtrinsic(const ExtrinsicParams& params) : enabled_(false), frame_id_(params.frame_id) {
+    t_poi_base_.setZero();
+    q_poi_base_.setIdentity();
+    if (!frame_id_.empty()) {
+        if (params.translation.size() == 3 && params.rotation.size() == 4) {
+            t_poi_base_ = Eigen::Vector3d(params.translation[0], params.translation[1], params.translation[2]);
+            q_poi_base_ = Eigen::Quaterniond(params.rotation[0], params.rotation[1], params.rotation[2],
+                                             params.rotation[3])
+                              .normalized();
+            enabled_ = true;
+        } else {
+            std::cerr << "Extrinsic to " << frame_id_ << " needs 3 translation and 4 rotation values (w, x, y, z)!\n";
+        }
+    }
+
+    rot_base_poi_ = q_poi_base_.toRotationMatrix().transpose();
+    t_base_ = rot_base_poi_ * t_poi_base_;
+    skew_t_ = Skew(t_poi_base_);
+    twist_jac_.setZero();
+    twist_jac_.topLeftCorner(3, 3) = rot_base_poi_;
+    twist_jac_.topRightCorner(3, 3) = -rot_base_poi_ * skew_t_;
+    twist_jac_.bottomRightCorner(3, 3) = rot_base_poi_;
+}
+
+void StaticExtrinsic::TransformPose(Eigen::Vector3d& position, Eigen::Quaterniond& orientation,
+                                    Eigen::Matrix<double, 6, 6>& cov) const {
+    // An orientation error d in ECEF moves the vehicle frame by d x (R_ecef_poi * t)
+    const Eigen::Matrix3d rot_ecef_poi = orientation.toRotationMatrix();
+    Eigen::Matrix<double, 6, 6> jac = Eigen::Matrix<double, 6, 6>::Identity();
+    jac.topRightCorner(3, 3) = -rot_ecef_poi * skew_t_ * rot_ecef_poi.transpose();
+
+    position += rot_ecef_poi * t_poi_base_;
+    orientation = orientation * q_poi_base_;
+    cov = jac * cov * jac.transpose();
+}
+
+void StaticExtrinsic::TransformTwist(Eigen::Vector3d& linear, Eigen::Vector3d& angular,
+                                     Eigen::Matrix<double, 6, 6>& cov) const {
+    Eigen::Matrix<double, 6, 1> twist;
+    twist << linear, angular;
+    twist = twist_jac_ * twist;
+    linear = twist.head<3>();
+    angular = twist.tail<3>();
+    cov = twist_jac_ * cov * twist_jac_.transpose();
+}
+
+void StaticExtrinsic::TransformAcceleration(Eigen::Vector3d& acc, const Eigen::Vector3d& angular) const {
+    acc = rot_base_poi_ * acc + angular.cross(angular.cross(t_base_));
+}
+
+}  // namespace fixposition
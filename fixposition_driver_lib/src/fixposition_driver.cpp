@@ -16,6 +16,14 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+
+#include <algorithm>
+#include <cmath>
 
 /* PACKAGE */
 #include <fixposition_driver_lib/converter/imu.hpp>
@@ -40,8 +48,58 @@
 #endif
 
 namespace fixposition {
-FixpositionDriver::FixpositionDriver(const FixpositionDriverParams& params) : params_(params) {
-    Connect();
+FixpositionDriver::FixpositionDriver(const FixpositionDriverParams& params)
+    : params_(params), load_shedder_(params.load_shedding), clock_model_(params.clock) {
+    framer_.AddObserver([this](const StreamFramer::FrameType type, const uint8_t* frame, const int size,
+                               const uint64_t offset) {
+        stats_.Frame(type, frame, size);
+        NotifyFrameObservers(type, frame, size, offset);
+
+        if (type == StreamFramer::FrameType::NOV_B) {
+            if (load_shedder_.Shedding()) {
+                const auto* header = reinterpret_cast<const Oem7MessageHeaderMem*>(frame);
+                if (!load_shedder_.Accept(header->message_id == static_cast<uint16_t>(MessageId::BESTGNSSPOS)
+                                              ? "BESTGNSSPOS"
+                                              : "NOV_B")) {
+                    stats_.Shed();
+                    return;
+                }
+            }
+            NovConvertAndPublish(frame, size);
+        } else {
+            // Drop before splitting into tokens, that is where most of the time goes
+            if (load_shedder_.Shedding() &&
+                !load_shedder_.Accept(GetFpaHeader(reinterpret_cast<const char*>(frame), size))) {
+                stats_.Shed();
+                return;
+            }
+            const std::string msg(reinterpret_cast<const char*>(frame), size);
+            NmeaConvertAndPublish(msg);
+        }
+    });
+
+    if (!params_.customer_input.can.interface.empty()) {
+        can_input_ = std::unique_ptr<CanWheelSpeedInput>(new CanWheelSpeedInput(params_.customer_input.can));
+        can_input_->AddObserver([this](const std::vector<int>& speeds) { WsCallback(speeds); });
+    }
+
+    const Rtcm3InputParams& rtcm3 = params_.customer_input.rtcm3;
+    if (rtcm3.port > 0 || !rtcm3.topic.empty()) {
+        rtcm3_input_ = std::unique_ptr<Rtcm3Input>(new Rtcm3Input(rtcm3));
+        rtcm3_input_->AddObserver([this](const uint8_t* frame, const int size, const double arrival) {
+            QueueRtcm3(frame, size, arrival);
+        });
+    }
+
+    if (params_.clock.enabled && !params_.clock.shm_name.empty()) {
+        clock_shm_.Open(params_.clock.shm_name);
+    }
+
+    if (!params_.stats.shm_name.empty() && stats_.Open(params_.stats.shm_name)) {
+        framer_.AddErrorObserver([this](const StreamFramer::FrameError error, const uint64_t, const int) {
+            stats_.FrameError(error);
+        });
+    }
 
     // static headers
     rawdmi_.head1 = 0xaa;
@@ -62,6 +120,37 @@ FixpositionDriver::FixpositionDriver(const FixpositionDriverParams& params) : pa
     if (!InitializeConverters()) {
         std::cerr << "Could not initialize output converter!\n";
     }
+
+    // Black-box recording of the decoded samples, the driver's observers run first
+    if (!params_.flight_recorder.file.empty() && flight_recorder_.Open(params_.flight_recorder)) {
+        AddOdometryObserver([this](const OdometryConverter::Msgs& msgs) { flight_recorder_.Record(msgs); });
+        AddRawImuObserver([this](const ImuData& imu) { flight_recorder_.Record(imu, false); });
+        AddCorrImuObserver([this](const ImuData& imu) { flight_recorder_.Record(imu, true); });
+        bestgnsspos_obs_.push_back([this](const Oem7MessageHeaderMem* header, const BESTGNSSPOSMem* bestgnsspos) {
+            flight_recorder_.Record(header, bestgnsspos);
+        });
+    }
+
+    // Continue where a running instance is, the ENU0 origin needs the converters
+    if (!params_.hot_restart.socket.empty()) {
+        hot_restart_ = std::unique_ptr<HotRestart>(new HotRestart(params_.hot_restart));
+    }
+    const bool taken_over = hot_restart_ && TakeOver();
+    if (handoff_refused_) {
+        // The shared pages and the socket stay with the running instance as well
+        clock_shm_.Detach();
+        stats_.Detach();
+        return;
+    }
+    stats_.Start();
+    if (!taken_over) {
+        // Drop the estimate a driver that did not exit cleanly may have left
+        clock_shm_.Write(ClockEstimate());
+        Connect();
+    }
+    if (hot_restart_) {
+        hot_restart_->Listen();
+    }
 }
 
 FixpositionDriver::~FixpositionDriver() {
@@ -74,7 +163,27 @@ FixpositionDriver::~FixpositionDriver() {
 }
 
 bool FixpositionDriver::Connect() {
+    // Two instances reading the same connection would split the stream between them
+    if (handoff_refused_) {
+        return false;
+    }
+
+    // A new connection starts a new stream, partial frames from the old one are useless
+    Disconnect();
+    framer_.Reset();
+
+    if (can_input_ && can_input_->GetFd() < 0) {
+        can_input_->Open();
+    }
+    if (rtcm3_input_ && params_.customer_input.rtcm3.port > 0 && rtcm3_input_->GetFd() < 0) {
+        rtcm3_connect_time_ = std::chrono::steady_clock::now();
+        rtcm3_input_->Open();
+    }
+    stats_.Connect();
+
     switch (params_.fp_output.type) {
+        case INPUT_TYPE::NONE:
+            return true;  // fed with Process()
         case INPUT_TYPE::TCP:
             return CreateTCPSocket();
             break;
@@ -113,33 +222,145 @@ void FixpositionDriver::WsCallback(const std::vector<int>& speeds) {
     memcpy(&message[0], &rawdmi_, sizeof(rawdmi_));
     memcpy(&message[sizeof(rawdmi_)], &checksum, sizeof(checksum));
 
-    switch (params_.fp_output.type) {
-        case INPUT_TYPE::TCP:
-            send(this->client_fd_, &message[0], sizeof(message), MSG_DONTWAIT);
-            break;
-        case INPUT_TYPE::SERIAL:
-            write(this->client_fd_, &message[0], sizeof(message));
-            break;
-        default:
-            std::cerr << "Unknown connection type!\n";
-            break;
+    QueueWrite(message, sizeof(message));
+}
+
+void FixpositionDriver::QueueWrite(const uint8_t* data, const std::size_t size) {
+    AppendWrite(data, size);
+    FlushWriteQueue();
+}
+
+void FixpositionDriver::AppendWrite(const uint8_t* data, const std::size_t size) {
+    if (write_queue_.size() + size > kMaxWriteQueue) {
+        DropWriteQueue();
+    }
+    write_queue_.insert(write_queue_.end(), data, data + size);
+}
+
+void FixpositionDriver::DropWriteQueue() {
+    read_stats_.write_dropped += write_queue_.size();
+    write_sent_ += write_queue_.size();
+    write_queue_.clear();
+    // A frame already partly sent is incomplete for the sensor, it discards it
+    rtcm3_stats_.dropped += rtcm3_pending_.size();
+    rtcm3_pending_.clear();
+}
+
+bool FixpositionDriver::FlushWriteQueue() {
+    if (client_fd_ < 0) {
+        // Stale by the time we are connected again
+        DropWriteQueue();
+        return true;
+    }
+    while (!write_queue_.empty()) {
+        const ssize_t n = params_.fp_output.type == INPUT_TYPE::TCP
+                              ? send(client_fd_, write_queue_.data(), write_queue_.size(), MSG_DONTWAIT | MSG_NOSIGNAL)
+                              : write(client_fd_, write_queue_.data(), write_queue_.size());
+        if (n > 0) {
+            write_queue_.erase(write_queue_.begin(), write_queue_.begin() + n);
+            write_sent_ += n;
+            if (!rtcm3_pending_.empty()) {
+                CompleteRtcm3();
+            }
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            break;  // the rest goes out once the connection is writable again
+        } else {
+            std::cerr << "Write error: " << strerror(errno) << "\n";
+            DropWriteQueue();
+            return false;
+        }
+    }
+    return true;
+}
+
+void FixpositionDriver::ForwardRtcm3(const uint8_t* data, const int size) {
+    if (rtcm3_input_) {
+        rtcm3_input_->Process(
+            data, size, std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
+
+void FixpositionDriver::QueueRtcm3(const uint8_t* frame, const int size, const double arrival) {
+    PendingRtcm3 pending;
+    pending.size = size;
+    pending.arrival = arrival;
+    pending.epoch_valid = GetRtcm3EpochTow(frame, size, pending.tow);
+    AppendWrite(frame, size);
+    pending.end = write_sent_ + write_queue_.size();
+    rtcm3_pending_.push_back(pending);
+    FlushWriteQueue();
+}
+
+void FixpositionDriver::CompleteRtcm3() {
+    const double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    const ClockEstimate& clock = clock_model_.GetEstimate();
+    static constexpr const double kSecPerWeek = times::Constants::sec_per_week;
+    while (!rtcm3_pending_.empty() && rtcm3_pending_.front().end <= write_sent_) {
+        const PendingRtcm3& pending = rtcm3_pending_.front();
+        rtcm3_stats_.frames++;
+        rtcm3_stats_.bytes += pending.size;
+        const double latency = now - pending.arrival;
+        rtcm3_stats_.latency_sum += latency;
+        rtcm3_stats_.latency_max = std::max(rtcm3_stats_.latency_max, latency);
+        // The age includes the transport from the base station, it is what the sensor's RTK solution sees
+        if (pending.epoch_valid && clock.valid) {
+            double age = std::fmod(HostToGps(clock, now), kSecPerWeek) - pending.tow;
+            if (age < -kSecPerWeek / 2) {
+                age += kSecPerWeek;
+            } else if (age >= kSecPerWeek / 2) {
+                age -= kSecPerWeek;
+            }
+            rtcm3_stats_.age_count++;
+            rtcm3_stats_.age_sum += age;
+            rtcm3_stats_.age_max = std::max(rtcm3_stats_.age_max, age);
+        }
+        rtcm3_pending_.pop_front();
+    }
+}
+
+Rtcm3Stats FixpositionDriver::GetRtcm3Stats() const {
+    Rtcm3Stats stats = rtcm3_stats_;
+    if (rtcm3_input_) {
+        stats.crc_errors = rtcm3_input_->GetCrcErrors();
+    }
+    return stats;
+}
+
+void FixpositionDriver::ReopenRtcm3Input() {
+    if (rtcm3_input_ && params_.customer_input.rtcm3.port > 0 && rtcm3_input_->GetFd() < 0 &&
+        std::chrono::steady_clock::now() - rtcm3_connect_time_ >
+            std::chrono::duration<double>(params_.fp_output.reconnect_delay)) {
+        rtcm3_connect_time_ = std::chrono::steady_clock::now();
+        rtcm3_input_->Open();
     }
 }
 
 bool FixpositionDriver::InitializeConverters() {
     for (const auto& format : params_.fp_output.formats) {
         if (format == "ODOMETRY") {
-            a_converters_["ODOMETRY"] = std::unique_ptr<OdometryConverter>(new OdometryConverter());
-            a_converters_["TF"] = std::unique_ptr<TfConverter>(new TfConverter());
+            odometry_converter_ = new OdometryConverter(params_.fp_output.llh_from_odometry, params_.extrinsic);
+            a_converters_["ODOMETRY"] = std::unique_ptr<OdometryConverter>(odometry_converter_);
+            if (tf_converter_ == nullptr) {
+                tf_converter_ = new TfConverter();
+                a_converters_["TF"] = std::unique_ptr<TfConverter>(tf_converter_);
+            }
         } else if (format == "LLH") {
-            a_converters_["LLH"] = std::unique_ptr<LlhConverter>(new LlhConverter());
+            if (params_.fp_output.llh_from_odometry) {
+                std::cout << "NavSatFix is derived from ODOMETRY, ignoring FP,LLH messages\n";
+                continue;
+            }
+            llh_converter_ = new LlhConverter();
+            a_converters_["LLH"] = std::unique_ptr<LlhConverter>(llh_converter_);
         } else if (format == "RAWIMU") {
-            a_converters_["RAWIMU"] = std::unique_ptr<ImuConverter>(new ImuConverter(false));
+            rawimu_converter_ = new ImuConverter(false);
+            a_converters_["RAWIMU"] = std::unique_ptr<ImuConverter>(rawimu_converter_);
         } else if (format == "CORRIMU") {
-            a_converters_["CORRIMU"] = std::unique_ptr<ImuConverter>(new ImuConverter(true));
+            corrimu_converter_ = new ImuConverter(true);
+            a_converters_["CORRIMU"] = std::unique_ptr<ImuConverter>(corrimu_converter_);
         } else if (format == "TF") {
-            if (a_converters_.find("TF") == a_converters_.end()) {
-                a_converters_["TF"] = std::unique_ptr<TfConverter>(new TfConverter());
+            if (tf_converter_ == nullptr) {
+                tf_converter_ = new TfConverter();
+                a_converters_["TF"] = std::unique_ptr<TfConverter>(tf_converter_);
             }
         } else {
             std::cerr << "Unknown input format: " << format << "\n";
@@ -148,21 +369,379 @@ bool FixpositionDriver::InitializeConverters() {
     return !a_converters_.empty();
 }
 bool FixpositionDriver::RunOnce() {
-    if ((client_fd_ > 0) && (connection_status_ == 0) && ReadAndPublish()) {
+    if (hot_restart_ && ServeHandoff()) {
+        return false;
+    }
+
+    const bool connected = (client_fd_ > 0) && (connection_status_ == 0);
+    bool readable = true;
+    if (connected && params_.fp_output.read.strategy != READ_STRATEGY::RATE) {
+        readable = WaitForData(1.0 / std::max(1, params_.fp_output.rate));
+    } else if (connected) {
+        WaitForInputs();
+    }
+
+    // Wheelspeeds and corrections first, they go out to the sensor with the lowest possible delay
+    if (can_input_ && can_input_->GetFd() >= 0 && !can_input_->Read()) {
+        can_input_->Close();  // reopened on the next Connect()
+    }
+    if (rtcm3_input_ && rtcm3_input_->GetFd() >= 0 && !rtcm3_input_->Read()) {
+        rtcm3_input_->Close();
+    }
+    ReopenRtcm3Input();
+
+    if (connected && (!readable || ReadAndPublish()) && FlushWriteQueue()) {
         return true;
     } else {
+        Disconnect();
+        return false;
+    }
+}
+
+void FixpositionDriver::FlushInput() {
+    if (client_fd_ >= 0) {
+        if (params_.fp_output.type == INPUT_TYPE::SERIAL) {
+            tcflush(client_fd_, TCIFLUSH);
+        } else {
+            // Stops at EOF or error as well, the next read detects those
+            uint8_t buf[4096];
+            while (recv(client_fd_, buf, sizeof(buf), MSG_DONTWAIT) > 0) {
+            }
+        }
+    }
+    framer_.Reset();
+}
+
+void FixpositionDriver::Process(const uint8_t* data, const int size) {
+    read_stats_.bytes += size;
+    read_time_ = std::chrono::steady_clock::now();
+    framer_.Process(data, size);
+    if (stats_.IsOpen()) {
+        stats_.Read(size, 0.0, std::chrono::duration<double>(std::chrono::steady_clock::now() - read_time_).count(), 0,
+                    framer_.PendingSize());
+        stats_.Connection(true, write_queue_.size(), read_stats_.write_dropped);
+    }
+}
+
+void FixpositionDriver::Disconnect() {
+    if (client_fd_ >= 0) {
+        close(client_fd_);
+        client_fd_ = -1;
+    }
+    stats_.Connection(false, write_queue_.size(), read_stats_.write_dropped);
+}
+
+/**
+ * @brief Kernel receive timestamps for the latency statistics, and the batch size for coalesced wakeups
+ *
+ * @param[in] fd TCP socket
+ * @param[in] read
+ */
+static void SetTcpReadOptions(const int fd, const ReadStrategyParams& read) {
+    const int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));
+    const int lowat = read.strategy == READ_STRATEGY::COALESCED ? std::max(1, read.min_batch) : 1;
+    setsockopt(fd, SOL_SOCKET, SO_RCVLOWAT, &lowat, sizeof(lowat));
+}
+
+static constexpr const int kHandoffAttempts = 3;  //!< handoff requests before giving up on a running driver
+
+bool FixpositionDriver::TakeOver() {
+    // A running instance that does not hand over keeps reading, it may just have been busy
+    int fd = -1;
+    HandoffState state;
+    HotRestart::Handoff result = HotRestart::Handoff::REFUSED;
+    for (int i = 0; i < kHandoffAttempts && result == HotRestart::Handoff::REFUSED; i++) {
+        result = hot_restart_->Receive(fd, state);
+    }
+    if (result == HotRestart::Handoff::NONE) {
+        return false;
+    } else if (result == HotRestart::Handoff::REFUSED) {
+        std::cerr << "The running driver keeps the sensor connection, not connecting\n";
+        handoff_refused_ = true;
+        return false;
+    }
+
+    // The previous driver has stopped, its ENU0 origin is valid with or without a connection
+    if (state.enu0_set && odometry_converter_ != nullptr) {
+        odometry_converter_->SetEnu0(state.t_ecef_enu0);
+    }
+    if (fd < 0) {
+        std::cout << "The previous driver had no connection, connecting anew\n";
+        return false;
+    }
+    if (state.type != params_.fp_output.type) {
+        std::cerr << "The previous driver used another connection type, connecting anew\n";
+        close(fd);
+        return false;
+    }
+
+    client_fd_ = fd;
+    connection_status_ = 0;
+    if (state.termios_set) {
+        options_save_ = state.termios;
+    }
+    if (params_.fp_output.type == INPUT_TYPE::TCP) {
+        SetTcpReadOptions(client_fd_, params_.fp_output.read);
+    }
+    framer_.Restore(state.pending.data(), state.pending.size(), state.stream_offset);
+    if (can_input_ && can_input_->GetFd() < 0) {
+        can_input_->Open();
+    }
+    std::cout << "Took over the sensor connection from the previous driver at stream offset " << state.stream_offset
+              << "\n";
+    return true;
+}
+
+bool FixpositionDriver::ServeHandoff() {
+    const int conn = hot_restart_->Accept();
+    if (conn < 0) {
+        return false;
+    }
+    // Without a connection (e.g. reconnecting) we still stop, the successor connects by itself. Leaving both to
+    // connect would split the stream between them.
+    const bool connected = client_fd_ >= 0 && connection_status_ == 0;
+
+    HandoffState state;
+    state.type = params_.fp_output.type;
+    state.stream_offset = framer_.GetOffset();
+    state.pending = framer_.GetPending();
+    state.enu0_set = odometry_converter_ != nullptr && odometry_converter_->GetEnu0(state.t_ecef_enu0);
+    state.termios_set = connected && params_.fp_output.type == INPUT_TYPE::SERIAL;
+    state.termios = options_save_;
+    if (!hot_restart_->Send(conn, connected ? client_fd_ : -1, state)) {
+        return false;
+    }
+
+    // Close without restoring the serial port options, the port is still in use. The successor writes the shared pages
+    // from now on.
+    if (client_fd_ >= 0) {
         close(client_fd_);
         client_fd_ = -1;
+    }
+    DropWriteQueue();
+    clock_shm_.Detach();
+    stats_.Detach();
+    handed_over_ = true;
+    std::cout << "Handed the sensor connection over to the new driver\n";
+    return true;
+}
+
+std::vector<PollFd> FixpositionDriver::GetPollFds() const {
+    std::vector<PollFd> fds;
+    if (client_fd_ >= 0 && connection_status_ == 0) {
+        fds.push_back({client_fd_, static_cast<short>(write_queue_.empty() ? POLLIN : POLLIN | POLLOUT)});
+    }
+    if (can_input_ && can_input_->GetFd() >= 0) {
+        fds.push_back({can_input_->GetFd(), POLLIN});
+    }
+    if (rtcm3_input_ && rtcm3_input_->GetFd() >= 0) {
+        fds.push_back({rtcm3_input_->GetFd(), POLLIN});
+    }
+    if (hot_restart_ && hot_restart_->GetFd() >= 0) {
+        fds.push_back({hot_restart_->GetFd(), POLLIN});
+    }
+    return fds;
+}
+
+bool FixpositionDriver::OnReadable(const int fd) {
+    if (hot_restart_ && fd == hot_restart_->GetFd()) {
+        return !ServeHandoff();
+    }
+    if (can_input_ && fd == can_input_->GetFd()) {
+        if (!can_input_->Read()) {
+            can_input_->Close();  // reopened on the next Connect()
+        }
+        return true;
+    }
+    ReopenRtcm3Input();
+    if (rtcm3_input_ && fd == rtcm3_input_->GetFd()) {
+        if (!rtcm3_input_->Read()) {
+            rtcm3_input_->Close();  // reopened after fp_output.reconnect_delay
+        }
+        return true;
+    }
+    if (fd != client_fd_ || client_fd_ < 0) {
+        return true;
+    }
+    if (!ReadAndPublish()) {
+        Disconnect();
         return false;
     }
+    return true;
+}
+
+bool FixpositionDriver::OnWritable(const int fd) {
+    if (fd != client_fd_ || client_fd_ < 0) {
+        return true;
+    }
+    if (!FlushWriteQueue()) {
+        Disconnect();
+        return false;
+    }
+    return true;
+}
+
+static struct timespec ToTimespec(const double sec) {
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(sec);
+    ts.tv_nsec = static_cast<long>((sec - ts.tv_sec) * 1e9);
+    return ts;
+}
+
+bool FixpositionDriver::WaitForData(const double timeout) {
+    struct pollfd fds[3];
+    nfds_t nfds = 1;
+    fds[0].fd = client_fd_;
+    fds[0].events = POLLIN;
+    fds[0].revents = 0;
+    if (can_input_ && can_input_->GetFd() >= 0) {
+        fds[nfds].fd = can_input_->GetFd();
+        fds[nfds].events = POLLIN;
+        fds[nfds].revents = 0;
+        nfds++;
+    }
+    if (rtcm3_input_ && rtcm3_input_->GetFd() >= 0) {
+        fds[nfds].fd = rtcm3_input_->GetFd();
+        fds[nfds].events = POLLIN;
+        fds[nfds].revents = 0;
+        nfds++;
+    }
+
+    const auto& read = params_.fp_output.read;
+    int n = 0;
+    switch (read.strategy) {
+        case READ_STRATEGY::BUSY_POLL: {
+            // Spin without giving up the CPU, sleep only if nothing came within the spin time
+            const struct timespec zero = {0, 0};
+            const auto spin_end = std::chrono::steady_clock::now() + std::chrono::duration<double>(read.spin_time);
+            do {
+                n = ppoll(fds, nfds, &zero, nullptr);
+            } while (n == 0 && std::chrono::steady_clock::now() < spin_end);
+            if (n == 0) {
+                const struct timespec ts = ToTimespec(std::max(0.0, timeout - read.spin_time));
+                n = ppoll(fds, nfds, &ts, nullptr);
+            }
+            break;
+        }
+        case READ_STRATEGY::COALESCED: {
+            if (params_.fp_output.type == INPUT_TYPE::TCP) {
+                // SO_RCVLOWAT holds the wakeup until min_batch bytes arrived, the timeout bounds the wait for a batch
+                // that does not fill up
+                const struct timespec ts = ToTimespec(std::min(timeout, read.max_batch_delay));
+                n = ppoll(fds, nfds, &ts, nullptr);
+                int available = 0;
+                if (n == 0 && ioctl(client_fd_, FIONREAD, &available) == 0 && available > 0) {
+                    return true;
+                }
+            } else {
+                // No low watermark on ttys, give the batch one timer period to fill up after the first data
+                const struct timespec ts = ToTimespec(timeout);
+                n = ppoll(fds, nfds, &ts, nullptr);
+                int available = 0;
+                if (n > 0 && fds[0].revents != 0 && ioctl(client_fd_, FIONREAD, &available) == 0 &&
+                    available < read.min_batch) {
+                    const struct timespec delay = ToTimespec(read.max_batch_delay);
+                    nanosleep(&delay, nullptr);
+                }
+            }
+            break;
+        }
+        case READ_STRATEGY::BLOCKING:
+        default: {
+            const struct timespec ts = ToTimespec(timeout);
+            n = ppoll(fds, nfds, &ts, nullptr);
+            break;
+        }
+    }
+
+    if (n < 0) {
+        // Interrupted by a signal: nothing to read. Anything else: let the read report the error
+        return errno != EINTR;
+    }
+    return n > 0 && fds[0].revents != 0;
+}
+
+void FixpositionDriver::WaitForInputs() {
+    const int can_fd = can_input_ ? can_input_->GetFd() : -1;
+    const int rtcm3_fd = rtcm3_input_ ? rtcm3_input_->GetFd() : -1;
+    if (can_fd < 0 && rtcm3_fd < 0) {
+        return;  // the caller sleeps for the loop period
+    }
+
+    // The periods follow each other, unless the loop fell behind or did not run for a while
+    const auto now = std::chrono::steady_clock::now();
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / std::max(1, params_.fp_output.rate)));
+    cycle_end_ += period;
+    if (cycle_end_ < now || cycle_end_ > now + period) {
+        cycle_end_ = now + period;
+    }
+
+    struct pollfd fds[2];
+    fds[0] = {can_fd, POLLIN, 0};  // negative fds are ignored by poll
+    fds[1] = {rtcm3_fd, POLLIN, 0};
+    while (true) {
+        const double remaining = std::chrono::duration<double>(cycle_end_ - std::chrono::steady_clock::now()).count();
+        const struct timespec ts = ToTimespec(std::max(0.0, remaining));
+        if (remaining <= 0.0 || ppoll(fds, 2, &ts, nullptr) <= 0) {
+            return;
+        }
+        if (fds[0].revents != 0 && !can_input_->Read()) {
+            can_input_->Close();  // reopened on the next Connect()
+            fds[0].fd = -1;
+        }
+        if (fds[1].revents != 0 && !rtcm3_input_->Read()) {
+            rtcm3_input_->Close();  // reopened after fp_output.reconnect_delay
+            fds[1].fd = -1;
+        }
+    }
+}
+
+ReadStats FixpositionDriver::GetReadStats() const {
+    ReadStats stats = read_stats_;
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        stats.cpu_time = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 + usage.ru_stime.tv_sec +
+                         usage.ru_stime.tv_usec * 1e-6;
+    }
+    return stats;
 }
 
 bool FixpositionDriver::ReadAndPublish() {
     char readBuf[8192];
 
+    read_stats_.wakeups++;
     ssize_t rv;
     if (params_.fp_output.type == INPUT_TYPE::TCP) {
-        rv = recv(client_fd_, (void*)&readBuf, sizeof(readBuf), MSG_DONTWAIT);
+        // Read with the kernel receive timestamp of the data, to measure how long it waited for us
+        struct iovec iov;
+        iov.iov_base = readBuf;
+        iov.iov_len = sizeof(readBuf);
+        char control[CMSG_SPACE(sizeof(struct timespec))];
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        rv = recvmsg(client_fd_, &msg, MSG_DONTWAIT);
+        read_rx_delay_ = 0.0;
+        if (rv > 0) {
+            for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+                if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                    struct timespec kernel_ts, now_ts;
+                    memcpy(&kernel_ts, CMSG_DATA(cmsg), sizeof(kernel_ts));
+                    clock_gettime(CLOCK_REALTIME, &now_ts);
+                    const double latency =
+                        (now_ts.tv_sec - kernel_ts.tv_sec) + (now_ts.tv_nsec - kernel_ts.tv_nsec) * 1e-9;
+                    read_stats_.latency_count++;
+                    read_stats_.latency_sum += latency;
+                    read_stats_.latency_max = std::max(read_stats_.latency_max, latency);
+                    read_rx_delay_ = latency;
+                }
+            }
+        }
     } else if (params_.fp_output.type == INPUT_TYPE::SERIAL) {
         rv = read(client_fd_, (void*)&readBuf, sizeof(readBuf));
     } else {
@@ -176,51 +755,62 @@ bool FixpositionDriver::ReadAndPublish() {
 
     if (rv < 0 && errno == EAGAIN) {
         /* no data for now, call back when the socket is readable */
+        read_stats_.empty_reads++;
         return true;
     }
     if (rv < 0) {
         std::cerr << "Connection error.\n";
         return false;
     }
+    read_stats_.bytes += rv;
 
-    ssize_t start_id = 0;
-    while (start_id < rv) {
-        int msg_size = 0;
-        // Nov B
-        msg_size = IsNovMessage((uint8_t*)&readBuf[start_id], rv - start_id);
-        if (msg_size > 0) {
-            NovConvertAndPublish((uint8_t*)&readBuf[start_id], msg_size);
-            start_id += msg_size;
-            continue;
-        }
-        if (msg_size == 0) {
-            // do nothing
-        }
-        if (msg_size < 0) {
-            break;
+    read_time_ = std::chrono::steady_clock::now();
+
+    // Frames split across reads are kept in the framer and completed with the next read
+    framer_.Process(reinterpret_cast<const uint8_t*>(readBuf), rv);
+
+    if (params_.load_shedding.enabled || stats_.IsOpen()) {
+        const double processing_time =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - read_time_).count();
+        int backlog = 0;
+        ioctl(client_fd_, FIONREAD, &backlog);
+        if (params_.load_shedding.enabled) {
+            load_shedder_.Update(processing_time, backlog);
         }
+        stats_.Read(rv, read_rx_delay_, processing_time, backlog, framer_.PendingSize());
+        stats_.Connection(true, write_queue_.size(), read_stats_.write_dropped);
+    }
 
-        // Nmea (incl. FP_A)
-        msg_size = IsNmeaMessage(&readBuf[start_id], rv - start_id);
-        if (msg_size > 0) {
-            // NovConvertAndPublish(start, msg_size);
-            std::string msg(&readBuf[start_id], msg_size);
-            NmeaConvertAndPublish(msg);
-            start_id += msg_size;
-            continue;
+    return true;
+}
+
+void FixpositionDriver::NotifyFrameObservers(const StreamFramer::FrameType type, const uint8_t* frame, const int size,
+                                             const uint64_t offset) {
+    const RawFrameInfo info = {ReadTimeSec(), offset};
+    if (type == StreamFramer::FrameType::NOV_B) {
+        if (nov_frame_obs_.empty()) {
+            return;
         }
-        if (msg_size == 0) {
-            // do nothing
+        const auto it = nov_frame_obs_.find(reinterpret_cast<const Oem7MessageHeaderMem*>(frame)->message_id);
+        if (it != nov_frame_obs_.end()) {
+            for (auto& ob : it->second) {
+                ob(frame, size, info);
+            }
         }
-        if (msg_size < 0) {
-            break;
+    } else {
+        // Compare the header in place: "$FP," + header + ","
+        static constexpr const int kFpaPrefixSize = 4;
+        for (auto& ob : fpa_frame_obs_) {
+            const std::string& header = ob.first;
+            const int header_size = static_cast<int>(header.size());
+            if (header.empty() ||
+                ((size > kFpaPrefixSize + header_size) && (memcmp(frame, "$FP,", kFpaPrefixSize) == 0) &&
+                 (memcmp(frame + kFpaPrefixSize, header.data(), header_size) == 0) &&
+                 (frame[kFpaPrefixSize + header_size] == ','))) {
+                ob.second(frame, size, info);
+            }
         }
-
-        // No Match, increment by 1
-        ++start_id;
     }
-
-    return true;
 }
 
 void FixpositionDriver::NmeaConvertAndPublish(const std::string& msg) {
@@ -230,16 +820,47 @@ void FixpositionDriver::NmeaConvertAndPublish(const std::string& msg) {
     SplitMessage(tokens, msg.substr(1, star_pos - 1), ",");
 
     // if it doesn't start with FP then do nothing
-    if (tokens.at(0) != "FP") {
+    if (tokens.size() < 2 || tokens[0] != "FP") {
         return;
     }
 
     // Get the header of the sentence
-    const std::string header = tokens.at(1);
+    const std::string& header = tokens[1];
+
+    // Track the epochs of each stream, all FP_A messages have the GPS time in fields 3 and 4. TF comes as several
+    // streams, one per pair of frames. A message without a valid time is left out of the tracking only, it is still
+    // converted below.
+    if (tokens.size() > 6 || (tokens.size() > 4 && header != "TF")) {
+        bool time_ok = true;
+        const times::GpsTime stamp = ConvertGpsTime(tokens[3], tokens[4], time_ok);
+        if (time_ok) {
+            UpdateStream(header == "TF" ? header + "_" + tokens[5] + "_" + tokens[6] : header, stamp);
+        }
+    }
 
     // If we have a converter available, convert to ros. Currently supported are "FP", "LLH", "TF", "RAWIMU", "CORRIMU"
-    if (a_converters_[header] != nullptr) {
-        a_converters_[header]->ConvertTokens(tokens);
+    bool ok = true;
+    const auto converter = a_converters_.find(header);
+    if (converter != a_converters_.end()) {
+        ok = converter->second->ConvertTokens(tokens);
+    }
+    if (!ok) {
+        decode_errors_[header]++;
+        stats_.DecodeError(header);
+    }
+}
+
+void FixpositionDriver::UpdateStream(const std::string& stream, const times::GpsTime& stamp) {
+    seq_monitors_[stream].Update(stamp, ReadTimeSec());
+
+    // Use the kernel receive time where available, the time waiting for the read is not part of the transport delay
+    if (params_.clock.enabled && stream == params_.clock.stream &&
+        clock_model_.Update(stamp.wno * static_cast<double>(times::Constants::sec_per_week) + stamp.tow,
+                            ReadTimeSec() - read_rx_delay_)) {
+        clock_shm_.Write(clock_model_.GetEstimate());
+        for (auto& ob : clock_obs_) {
+            ob(clock_model_.GetEstimate());
+        }
     }
 }
 
@@ -248,6 +869,11 @@ void FixpositionDriver::NovConvertAndPublish(const uint8_t* msg, int size) {
     const auto msg_id = header->message_id;
 
     if (msg_id == static_cast<uint16_t>(MessageId::BESTGNSSPOS)) {
+        const bool secondary =
+            (header->message_type & static_cast<uint8_t>(MessageTypeSource::_MASK)) ==
+            static_cast<uint8_t>(MessageTypeSource::SECONDARY);
+        UpdateStream(secondary ? "BESTGNSSPOS_GNSS2" : "BESTGNSSPOS_GNSS1",
+                     times::GpsTime(header->gps_week, header->gps_milliseconds * 1e-3));
         for (auto& ob : bestgnsspos_obs_) {
             auto* payload = reinterpret_cast<const BESTGNSSPOSMem*>(msg + sizeof(Oem7MessageHeaderMem));
             ob(header, payload);
@@ -258,6 +884,13 @@ void FixpositionDriver::NovConvertAndPublish(const uint8_t* msg, int size) {
 
 bool FixpositionDriver::CreateTCPSocket() {
     struct sockaddr_in server_address;
+    bool port_ok = true;
+    const int port = StringToInt(params_.fp_output.port, port_ok);
+    if (!port_ok || port <= 0 || port > 65535) {
+        std::cerr << "Invalid TCP port " << params_.fp_output.port << "\n";
+        return false;
+    }
+
     client_fd_ = socket(AF_INET, SOCK_STREAM, 0);
 
     if (client_fd_ < 0) {
@@ -269,9 +902,11 @@ bool FixpositionDriver::CreateTCPSocket() {
 
     server_address.sin_family = AF_INET;
     server_address.sin_addr.s_addr = INADDR_ANY;
-    server_address.sin_port = htons(std::stoi(params_.fp_output.port));
+    server_address.sin_port = htons(port);
     server_address.sin_addr.s_addr = inet_addr(params_.fp_output.ip.c_str());
 
+    SetTcpReadOptions(client_fd_, params_.fp_output.read);
+
     connection_status_ = connect(client_fd_, (struct sockaddr*)&server_address, sizeof server_address);
 
     if (connection_status_ != 0) {
@@ -281,80 +916,196 @@ bool FixpositionDriver::CreateTCPSocket() {
     return true;
 }
 
-bool FixpositionDriver::CreateSerialConnection() {
-    client_fd_ = open(params_.fp_output.port.c_str(), O_RDWR | O_NOCTTY);
-
-    struct termios options;
-    speed_t speed;
-
-    switch (params_.fp_output.baudrate) {
+/**
+ * @brief Termios speed of a baudrate
+ *
+ * @param[in] baudrate
+ * @param[out] speed
+ * @return true
+ * @return false baudrate not supported
+ */
+static bool BaudrateToSpeed(const int baudrate, speed_t& speed) {
+    switch (baudrate) {
         case 9600:
             speed = B9600;
-            break;
-
+            return true;
+        case 19200:
+            speed = B19200;
+            return true;
         case 38400:
             speed = B38400;
-            break;
-
+            return true;
         case 57600:
             speed = B57600;
-            break;
-
+            return true;
         case 115200:
             speed = B115200;
-            break;
-
+            return true;
         case 230400:
             speed = B230400;
-            break;
-
+            return true;
         case 460800:
             speed = B460800;
-            break;
-
+            return true;
         case 500000:
             speed = B500000;
-            break;
-
+            return true;
         case 921600:
             speed = B921600;
-            break;
-
+            return true;
         case 1000000:
             speed = B1000000;
-            break;
-
+            return true;
         default:
-            speed = B115200;
-            std::cerr << "Unsupported baudrate: " << params_.fp_output.baudrate
-                      << "\n\tsupported examples:\n\t9600, "
-                         "19200, "
-                         "38400, "
-                         "57600\t\n115200\n230400\n460800\n500000\n921600\n1000000\n";
+            return false;
+    }
+}
+
+//! Candidates of DetectBaudrate() after the configured one, the most common sensor settings first
+static constexpr const int kAutoBaudrates[] = {115200, 921600, 460800, 230400, 57600, 38400, 19200, 9600};
+
+/**
+ * @brief Count the NMEA and NOV_B frames with a valid checksum, skipping anything else
+ *
+ * @param[in] buf
+ * @param[in,out] pos where to continue, the start of an incomplete frame when returning
+ * @return int number of frames
+ */
+static int CountValidFrames(const std::vector<uint8_t>& buf, std::size_t& pos) {
+    int frames = 0;
+    while (pos < buf.size()) {
+        const uint8_t* start = buf.data() + pos;
+        const int available = static_cast<int>(buf.size() - pos);
+        int len = IsNmeaMessage(reinterpret_cast<const char*>(start), available);
+        if (len == 0) {
+            len = IsNovMessage(start, available);
+        }
+        if (len > 0) {
+            frames++;
+            pos += len;
+        } else if (len < 0) {
+            break;  // completed by the next data
+        } else {
+            pos++;
+        }
+    }
+    return frames;
+}
+
+int FixpositionDriver::DetectBaudrate(struct termios& options) {
+    std::vector<int> candidates;
+    for (const int baudrate : {serial_baudrate_, params_.fp_output.baudrate}) {
+        speed_t speed = B0;
+        if (BaudrateToSpeed(baudrate, speed) &&
+            std::find(candidates.begin(), candidates.end(), baudrate) == candidates.end()) {
+            candidates.push_back(baudrate);
+        }
+    }
+    for (const int baudrate : kAutoBaudrates) {
+        if (std::find(candidates.begin(), candidates.end(), baudrate) == candidates.end()) {
+            candidates.push_back(baudrate);
+        }
     }
 
+    int best_baudrate = 0;
+    int best_frames = 0;
+    std::vector<uint8_t> buf;
+    for (const int baudrate : candidates) {
+        speed_t speed = B0;
+        if (!BaudrateToSpeed(baudrate, speed)) {
+            continue;
+        }
+        cfsetispeed(&options, speed);
+        cfsetospeed(&options, speed);
+        tcsetattr(client_fd_, TCSANOW, &options);
+        tcflush(client_fd_, TCIFLUSH);  // received at the previous baudrate
+
+        // Valid frames are as good as impossible at a wrong baudrate, a few of them end the search
+        buf.clear();
+        std::size_t pos = 0;
+        int frames = 0;
+        const auto end =
+            std::chrono::steady_clock::now() + std::chrono::duration<double>(params_.fp_output.auto_baud_window);
+        while (frames < kAutoBaudFrames) {
+            const auto remaining = end - std::chrono::steady_clock::now();
+            const int timeout_ms = std::chrono::duration_cast<std::chrono::milliseconds>(remaining).count();
+            struct pollfd pfd = {client_fd_, POLLIN, 0};
+            if (timeout_ms <= 0 || poll(&pfd, 1, timeout_ms) <= 0) {
+                break;
+            }
+            uint8_t data[512];
+            const ssize_t n = read(client_fd_, data, sizeof(data));
+            if (n <= 0) {
+                break;
+            }
+            buf.insert(buf.end(), data, data + n);
+            frames += CountValidFrames(buf, pos);
+        }
+
+        if (frames >= kAutoBaudFrames) {
+            return baudrate;
+        } else if (frames > best_frames) {
+            best_baudrate = baudrate;
+            best_frames = frames;
+        }
+    }
+
+    speed_t speed = B0;
+    if (best_baudrate > 0 && BaudrateToSpeed(best_baudrate, speed)) {
+        cfsetispeed(&options, speed);
+        cfsetospeed(&options, speed);
+        tcsetattr(client_fd_, TCSANOW, &options);
+    }
+    return best_baudrate;
+}
+
+bool FixpositionDriver::CreateSerialConnection() {
+    speed_t speed = B115200;
+    if (!BaudrateToSpeed(params_.fp_output.baudrate, speed) && !params_.fp_output.auto_baud) {
+        std::cerr << "Unsupported baudrate: " << params_.fp_output.baudrate
+                  << "\n\tsupported: 9600, 19200, 38400, 57600, 115200, 230400, 460800, 500000, 921600, 1000000"
+                     "\n\tor enable fp_output.auto_baud to detect it\n";
+        return false;
+    }
+
+    client_fd_ = open(params_.fp_output.port.c_str(), O_RDWR | O_NOCTTY);
     if (client_fd_ == -1) {
         // Could not open the port.
         std::cerr << "Failed to open serial port " << strerror(errno) << "\n";
         return false;
-    } else {
-        // Get current serial port options:
-        tcgetattr(client_fd_, &options);
-        options_save_ = options;
-        char speed_buf[10];
-        snprintf(speed_buf, sizeof(speed_buf), "0%06o", (int)cfgetispeed(&options));
-
-        options.c_iflag &= ~(IXOFF | IXON | ICRNL);
-        options.c_oflag &= ~(OPOST | ONLCR);
-        options.c_lflag &= ~(ISIG | ICANON | ECHO | ECHOE | ECHOK | ECHOCTL | ECHOKE | IEXTEN);
-        options.c_cc[VEOL] = 0;
-        options.c_cc[VMIN] = 0;
-        options.c_cc[VTIME] = 50;
+    }
+
+    // Get current serial port options:
+    struct termios options;
+    tcgetattr(client_fd_, &options);
+    options_save_ = options;
+
+    options.c_iflag &= ~(IXOFF | IXON | ICRNL);
+    options.c_oflag &= ~(OPOST | ONLCR);
+    options.c_lflag &= ~(ISIG | ICANON | ECHO | ECHOE | ECHOK | ECHOCTL | ECHOKE | IEXTEN);
+    options.c_cc[VEOL] = 0;
+    options.c_cc[VMIN] = 0;
+    options.c_cc[VTIME] = 50;
 
+    if (params_.fp_output.auto_baud) {
+        const int baudrate = DetectBaudrate(options);
+        if (baudrate == 0) {
+            std::cerr << "No valid data from the sensor at any baudrate\n";
+            tcsetattr(client_fd_, TCSANOW, &options_save_);
+            close(client_fd_);
+            client_fd_ = -1;
+            return false;
+        }
+        if (baudrate != serial_baudrate_) {
+            std::cout << "Detected baudrate " << baudrate << "\n";
+        }
+        serial_baudrate_ = baudrate;
+    } else {
+        cfsetispeed(&options, speed);
         cfsetospeed(&options, speed); /* baud rate */
         tcsetattr(client_fd_, TCSANOW, &options);
-        connection_status_ = 0;  // not used for serial, set to 0 (success)
-        return true;
     }
+    connection_status_ = 0;  // not used for serial, set to 0 (success)
+    return true;
 }
 }  // namespace fixposition
@@ -0,0 +1,351 @@
+/**
+ *  @file
+ *  @brief Live view of the counters a running driver publishes in shared memory (parameter stats.shm_name)
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/driver_stats.hpp>
+
+using fixposition::StatsShmPage;
+using fixposition::kStatsLatencyBins;
+
+struct TypeSnapshot {
+    std::string name;
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    uint64_t errors = 0;
+};
+
+/**
+ * @brief Copy of the page at one point in time
+ *
+ */
+struct Snapshot {
+    double time = 0.0;  //!< monotonic clock in [s]
+    uint32_t pid = 0;
+    uint32_t connected = 0;
+    uint32_t write_queue = 0;
+    uint32_t backlog = 0;
+    uint32_t pending = 0;
+    uint64_t connects = 0;
+    uint64_t reads = 0;
+    uint64_t bytes = 0;
+    uint64_t nmea_checksum_errors = 0;
+    uint64_t nov_crc_errors = 0;
+    uint64_t shed = 0;
+    uint64_t write_dropped = 0;
+    uint64_t rx_delay[kStatsLatencyBins] = {};
+    uint64_t processing[kStatsLatencyBins] = {};
+    std::vector<TypeSnapshot> types;
+};
+
+static double Now() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Map the page read-only, see DriverStatsWriter
+ *
+ */
+class StatsReader {
+   public:
+    ~StatsReader() { Close(); }
+
+    /**
+     * @brief Map the page unless the mapped one is still the current one. A restarted driver resets the page and sets
+     * its pid, a new page only comes after the object was removed.
+     *
+     * @param[in] name
+     * @return true
+     * @return false no driver publishes under this name
+     */
+    bool Open(const std::string& name) {
+        const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            Close();
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(StatsShmPage)) {
+            close(fd);
+            Close();
+            return false;
+        }
+        if (page_ != nullptr && st.st_ino == ino_) {
+            close(fd);
+            return page_->magic == fixposition::kStatsShmMagic;
+        }
+        Close();
+        void* addr = mmap(nullptr, sizeof(StatsShmPage), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            return false;
+        }
+        page_ = static_cast<const StatsShmPage*>(addr);
+        ino_ = st.st_ino;
+        if (page_->magic != fixposition::kStatsShmMagic || page_->version != fixposition::kStatsShmVersion) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Unmap the page
+     *
+     */
+    void Close() {
+        if (page_ != nullptr) {
+            munmap(const_cast<StatsShmPage*>(page_), sizeof(StatsShmPage));
+            page_ = nullptr;
+        }
+    }
+
+    /**
+     * @brief Copy the counters
+     *
+     * @param[out] snapshot
+     */
+    void Take(Snapshot& snapshot) const {
+        const auto relaxed = std::memory_order_relaxed;
+        snapshot.time = Now();
+        snapshot.pid = page_->pid;
+        snapshot.connected = page_->connected.load(relaxed);
+        snapshot.write_queue = page_->write_queue.load(relaxed);
+        snapshot.backlog = page_->backlog.load(relaxed);
+        snapshot.pending = page_->pending.load(relaxed);
+        snapshot.connects = page_->connects.load(relaxed);
+        snapshot.reads = page_->reads.load(relaxed);
+        snapshot.bytes = page_->bytes.load(relaxed);
+        snapshot.nmea_checksum_errors = page_->nmea_checksum_errors.load(relaxed);
+        snapshot.nov_crc_errors = page_->nov_crc_errors.load(relaxed);
+        snapshot.shed = page_->shed.load(relaxed);
+        snapshot.write_dropped = page_->write_dropped.load(relaxed);
+        for (int i = 0; i < kStatsLatencyBins; i++) {
+            snapshot.rx_delay[i] = page_->rx_delay[i].load(relaxed);
+            snapshot.processing[i] = page_->processing[i].load(relaxed);
+        }
+        // The names of the slots up to num_types are complete
+        const uint32_t num_types =
+            std::min<uint32_t>(page_->num_types.load(std::memory_order_acquire), fixposition::kStatsMaxTypes);
+        snapshot.types.resize(num_types);
+        for (uint32_t i = 0; i < num_types; i++) {
+            const auto& type = page_->types[i];
+            snapshot.types[i].name.assign(type.name, strnlen(type.name, sizeof(type.name)));
+            snapshot.types[i].frames = type.frames.load(relaxed);
+            snapshot.types[i].bytes = type.bytes.load(relaxed);
+            snapshot.types[i].errors = type.errors.load(relaxed);
+        }
+    }
+
+   private:
+    const StatsShmPage* page_ = nullptr;
+    ino_t ino_ = 0;
+};
+
+/**
+ * @brief Increase of a counter, the driver may have reset its page in between
+ *
+ */
+static uint64_t Delta(const uint64_t now, const uint64_t before) {
+    return now >= before ? now - before : now;
+}
+
+static std::string FormatBytes(const double bytes) {
+    char str[32];
+    if (bytes >= 1e6) {
+        snprintf(str, sizeof(str), "%.2f MB", bytes * 1e-6);
+    } else if (bytes >= 1e3) {
+        snprintf(str, sizeof(str), "%.1f kB", bytes * 1e-3);
+    } else {
+        snprintf(str, sizeof(str), "%.0f B", bytes);
+    }
+    return str;
+}
+
+static std::string FormatDuration(const double sec) {
+    char str[32];
+    if (sec >= 1.0) {
+        snprintf(str, sizeof(str), "%.2f s", sec);
+    } else if (sec >= 1e-3) {
+        snprintf(str, sizeof(str), "%.2f ms", sec * 1e3);
+    } else {
+        snprintf(str, sizeof(str), "%.0f us", sec * 1e6);
+    }
+    return str;
+}
+
+/**
+ * @brief One line of percentiles of the samples that came in between two snapshots
+ *
+ * @param[in] label
+ * @param[in] now
+ * @param[in] before
+ */
+static void PrintLatency(const char* label, const uint64_t* now, const uint64_t* before) {
+    uint64_t delta[kStatsLatencyBins];
+    uint64_t total = 0;
+    for (int i = 0; i < kStatsLatencyBins; i++) {
+        delta[i] = Delta(now[i], before[i]);
+        total += delta[i];
+    }
+    if (total == 0) {
+        printf("%-14s %10s %10s %10s %10s %10d\n", label, "-", "-", "-", "-", 0);
+        return;
+    }
+    // Percentiles are the upper ends of the bins, i.e. at most 25% too high
+    const double quantiles[] = {0.5, 0.9, 0.99, 1.0};
+    std::string values[4];
+    uint64_t sum = 0;
+    int q = 0;
+    for (int i = 0; i < kStatsLatencyBins && q < 4; i++) {
+        sum += delta[i];
+        while (q < 4 && sum > 0 && sum >= quantiles[q] * total) {
+            values[q++] = FormatDuration(fixposition::StatsLatencyBinLimit(i));
+        }
+    }
+    printf("%-14s %10s %10s %10s %10s %10" PRIu64 "\n", label, values[0].c_str(), values[1].c_str(),
+           values[2].c_str(), values[3].c_str(), total);
+}
+
+/**
+ * @brief Print the rates and percentiles between two snapshots
+ *
+ * @param[in] name
+ * @param[in] now
+ * @param[in] before
+ */
+static void Print(const std::string& name, const Snapshot& now, const Snapshot& before) {
+    const double dt = std::max(1e-3, now.time - before.time);
+    printf("fixposition_top - %s, driver pid %u, %s, %" PRIu64 " connection attempts\n\n", name.c_str(), now.pid,
+           now.connected ? "connected" : "NOT CONNECTED", now.connects);
+    printf("input   %10s/s %8.0f reads/s   backlog %s   partial frame %s\n",
+           FormatBytes(Delta(now.bytes, before.bytes) / dt).c_str(), Delta(now.reads, before.reads) / dt,
+           FormatBytes(now.backlog).c_str(), FormatBytes(now.pending).c_str());
+    printf("output  write queue %s   dropped %s (+%s)\n", FormatBytes(now.write_queue).c_str(),
+           FormatBytes(now.write_dropped).c_str(),
+           FormatBytes(Delta(now.write_dropped, before.write_dropped)).c_str());
+    printf("errors  NMEA checksum %" PRIu64 " (+%" PRIu64 ")   NOV_B CRC %" PRIu64 " (+%" PRIu64 ")   shed %" PRIu64
+           " (+%" PRIu64 ")\n\n",
+           now.nmea_checksum_errors, Delta(now.nmea_checksum_errors, before.nmea_checksum_errors),
+           now.nov_crc_errors, Delta(now.nov_crc_errors, before.nov_crc_errors), now.shed,
+           Delta(now.shed, before.shed));
+
+    printf("%-14s %10s %10s %10s %10s %10s\n", "LATENCY", "p50", "p90", "p99", "max", "samples");
+    PrintLatency("kernel->read", now.rx_delay, before.rx_delay);
+    PrintLatency("processing", now.processing, before.processing);
+    printf("\n");
+
+    printf("%-24s %10s %12s %12s %10s\n", "TYPE", "RATE [Hz]", "BYTES/s", "FRAMES", "ERRORS");
+    std::vector<const TypeSnapshot*> types;
+    for (const auto& type : now.types) {
+        types.push_back(&type);
+    }
+    std::sort(types.begin(), types.end(),
+              [](const TypeSnapshot* a, const TypeSnapshot* b) { return a->name < b->name; });
+    for (const auto* type : types) {
+        uint64_t frames = type->frames;
+        uint64_t bytes = type->bytes;
+        uint64_t errors = type->errors;
+        for (const auto& prev : before.types) {
+            if (prev.name == type->name) {
+                frames = Delta(type->frames, prev.frames);
+                bytes = Delta(type->bytes, prev.bytes);
+                errors = Delta(type->errors, prev.errors);
+                break;
+            }
+        }
+        printf("%-24s %10.1f %12s %12" PRIu64 " %10" PRIu64 "%s\n", type->name.c_str(), frames / dt,
+               FormatBytes(bytes / dt).c_str(), type->frames, type->errors, errors > 0 ? " !" : "");
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    std::string name = "/fixposition_stats";
+    double interval = 1.0;
+    bool once = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:i:1h")) != -1) {
+        switch (opt) {
+            case 'n':
+                name = optarg;
+                break;
+            case 'i':
+                interval = atof(optarg);
+                break;
+            case '1':
+                once = true;
+                break;
+            default:
+                optind = argc + 1;
+                break;
+        }
+    }
+    if (optind != argc || interval <= 0.0) {
+        printf("Usage: %s [-n shm_name] [-i interval] [-1]\n", argv[0]);
+        printf("  -n  shared memory object of the driver, parameter stats.shm_name (default /fixposition_stats)\n");
+        printf("  -i  refresh interval in [s] (default 1.0)\n");
+        printf("  -1  print one interval and exit\n");
+        return 1;
+    }
+
+    StatsReader reader;
+    Snapshot before;
+    Snapshot now;
+    bool have_before = false;
+    const struct timespec sleep_time = {static_cast<time_t>(interval),
+                                        static_cast<long>((interval - static_cast<time_t>(interval)) * 1e9)};
+    while (true) {
+        if (!reader.Open(name)) {
+            if (once) {
+                fprintf(stderr, "No driver publishes its counters in %s, set parameter stats.shm_name\n",
+                        name.c_str());
+                return 1;
+            }
+            printf("\033[H\033[2Jfixposition_top - waiting for the driver to publish in %s\n", name.c_str());
+            fflush(stdout);
+            have_before = false;
+        } else {
+            reader.Take(now);
+            if (have_before && now.pid == before.pid) {
+                if (!once) {
+                    printf("\033[H\033[2J");
+                }
+                Print(name, now, before);
+                if (once) {
+                    return 0;
+                }
+            }
+            before = now;
+            have_before = true;
+        }
+        nanosleep(&sleep_time, nullptr);
+    }
+}
@@ -0,0 +1,201 @@
+/**
+ *  @file
+ *  @brief Implementation of FlightRecorder class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <new>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/flight_recorder.hpp>
+
+namespace fixposition {
+
+FlightRecorder::~FlightRecorder() {
+    if (header_ != nullptr) {
+        munmap(header_, map_size_);
+    }
+}
+
+bool FlightRecorder::Open(const FlightRecorderParams& params) {
+    const uint64_t capacity = static_cast<uint64_t>(params.size) * 1024 * 1024 / sizeof(FlightRecord);
+    if (capacity < 2) {
+        std::cerr << "Flight recorder size must be at least 1 MiB\n";
+        return false;
+    }
+    const std::size_t size = kFlightRecorderHeaderSize + capacity * sizeof(FlightRecord);
+
+    const int fd = open(params.file.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "Cannot open flight recorder " << params.file << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    // A ring of another size is started over, the file is allocated up front so that writing never fails later
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    if (ok && static_cast<std::size_t>(st.st_size) != size) {
+        ok = (ftruncate(fd, 0) == 0) && (posix_fallocate(fd, 0, size) == 0);
+    }
+    void* addr = ok ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "Cannot map flight recorder " << params.file << ": " << strerror(errno) << "\n";
+        return false;
+    }
+
+    header_ = static_cast<FlightRecorderHeader*>(addr);
+    records_ = reinterpret_cast<FlightRecord*>(static_cast<uint8_t*>(addr) + kFlightRecorderHeaderSize);
+    map_size_ = size;
+    if (header_->magic == kFlightRecorderMagic && header_->version == kFlightRecorderVersion &&
+        header_->record_size == sizeof(FlightRecord) && header_->capacity == capacity) {
+        return true;  // continue the ring, keeping what was recorded before
+    }
+
+    // Readers only trust the file once magic and version are set
+    header_ = new (addr) FlightRecorderHeader();
+    header_->version = kFlightRecorderVersion;
+    header_->record_size = sizeof(FlightRecord);
+    header_->reserved = 0;
+    header_->capacity = capacity;
+    header_->head.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = kFlightRecorderMagic;
+    return true;
+}
+
+void FlightRecorder::Record(const OdometryConverter::Msgs& msgs) {
+    FlightRecord record{};
+    record.type = static_cast<uint8_t>(FlightRecordType::ODOMETRY);
+    record.wno = msgs.odometry.stamp.wno;
+    record.tow = msgs.odometry.stamp.tow;
+    FlightOdometry& odometry = record.odometry;
+    const PoseWithCovData& pose = msgs.odometry.pose;
+    for (int i = 0; i < 3; i++) {
+        odometry.position[i] = pose.position(i);
+        odometry.velocity[i] = msgs.odometry.twist.linear(i);
+        odometry.angular_velocity[i] = msgs.odometry.twist.angular(i);
+        odometry.acceleration[i] = msgs.vrtk.acceleration(i);
+    }
+    odometry.orientation[0] = pose.orientation.w();
+    odometry.orientation[1] = pose.orientation.x();
+    odometry.orientation[2] = pose.orientation.y();
+    odometry.orientation[3] = pose.orientation.z();
+    odometry.fusion_status = msgs.vrtk.fusion_status;
+    odometry.imu_bias_status = msgs.vrtk.imu_bias_status;
+    odometry.gnss1_status = msgs.vrtk.gnss1_status;
+    odometry.gnss2_status = msgs.vrtk.gnss2_status;
+    odometry.wheelspeed_status = msgs.vrtk.wheelspeed_status;
+    Append(record);
+}
+
+void FlightRecorder::Record(const ImuData& imu, const bool corrected) {
+    FlightRecord record{};
+    record.type = static_cast<uint8_t>(corrected ? FlightRecordType::CORRIMU : FlightRecordType::RAWIMU);
+    record.wno = imu.stamp.wno;
+    record.tow = imu.stamp.tow;
+    for (int i = 0; i < 3; i++) {
+        record.imu.linear_acceleration[i] = imu.linear_acceleration(i);
+        record.imu.angular_velocity[i] = imu.angular_velocity(i);
+    }
+    Append(record);
+}
+
+void FlightRecorder::Record(const Oem7MessageHeaderMem* header, const BESTGNSSPOSMem* bestgnsspos) {
+    FlightRecord record{};
+    record.type = static_cast<uint8_t>(FlightRecordType::BESTGNSSPOS);
+    record.wno = header->gps_week;
+    record.tow = header->gps_milliseconds * 1e-3;
+    FlightBestGnssPos& gnss = record.gnss;
+    gnss.lat = bestgnsspos->lat;
+    gnss.lon = bestgnsspos->lon;
+    gnss.hgt = bestgnsspos->hgt;
+    gnss.undulation = bestgnsspos->undulation;
+    gnss.lat_stdev = bestgnsspos->lat_stdev;
+    gnss.lon_stdev = bestgnsspos->lon_stdev;
+    gnss.hgt_stdev = bestgnsspos->hgt_stdev;
+    gnss.sol_stat = bestgnsspos->sol_stat;
+    gnss.pos_type = bestgnsspos->pos_type;
+    gnss.num_svs = bestgnsspos->num_svs;
+    gnss.num_sol_svs = bestgnsspos->num_sol_svs;
+    gnss.secondary = (header->message_type & static_cast<uint8_t>(MessageTypeSource::_MASK)) ==
+                     static_cast<uint8_t>(MessageTypeSource::SECONDARY);
+    Append(record);
+}
+
+void FlightRecorder::Append(FlightRecord& record) {
+    if (header_ == nullptr) {
+        return;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    record.host_time = now.tv_sec + now.tv_nsec * 1e-9;
+    record.seq = header_->head.load(std::memory_order_relaxed);
+    memcpy(&records_[record.seq % header_->capacity], &record, sizeof(record));
+    header_->head.store(record.seq + 1, std::memory_order_release);
+}
+
+bool FlightRecorder::ReadFile(const std::string& path, std::vector<FlightRecord>& records) {
+    records.clear();
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    void* addr = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) > kFlightRecorderHeaderSize) {
+        addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    const auto* header = static_cast<const FlightRecorderHeader*>(addr);
+    const auto* ring =
+        reinterpret_cast<const FlightRecord*>(static_cast<const uint8_t*>(addr) + kFlightRecorderHeaderSize);
+    const bool ok = header->magic == kFlightRecorderMagic && header->version == kFlightRecorderVersion &&
+                    header->record_size == sizeof(FlightRecord) && header->capacity > 1 &&
+                    kFlightRecorderHeaderSize + header->capacity * sizeof(FlightRecord) ==
+                        static_cast<std::size_t>(st.st_size);
+    if (ok) {
+        // Copy first, then drop what the writer may have overwritten meanwhile (and the slot it was writing to)
+        const uint64_t capacity = header->capacity;
+        const uint64_t head = header->head.load(std::memory_order_acquire);
+        const uint64_t first = head >= capacity ? head - capacity + 1 : 0;
+        records.reserve(head - first);
+        for (uint64_t seq = first; seq < head; seq++) {
+            records.push_back(ring[seq % capacity]);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t new_head = header->head.load(std::memory_order_relaxed);
+        const uint64_t valid_from = new_head >= capacity ? new_head - capacity + 1 : 0;
+        std::size_t num_valid = 0;
+        for (std::size_t i = 0; i < records.size(); i++) {
+            if (records[i].seq == first + i && first + i >= valid_from) {
+                records[num_valid++] = records[i];
+            }
+        }
+        records.resize(num_valid);
+    }
+    munmap(addr, st.st_size);
+    return ok;
+}
+
+}  // namespace fixposition
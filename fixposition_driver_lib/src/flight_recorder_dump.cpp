@@ -0,0 +1,133 @@
+/**
+ *  @file
+ *  @brief Print the samples of a flight recorder ring file as CSV
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <unistd.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/flight_recorder.hpp>
+
+using fixposition::FlightRecord;
+using fixposition::FlightRecordType;
+
+static const char* TypeName(const uint8_t type) {
+    switch (static_cast<FlightRecordType>(type)) {
+        case FlightRecordType::ODOMETRY:
+            return "ODOMETRY";
+        case FlightRecordType::RAWIMU:
+            return "RAWIMU";
+        case FlightRecordType::CORRIMU:
+            return "CORRIMU";
+        case FlightRecordType::BESTGNSSPOS:
+            return "BESTGNSSPOS";
+        default:
+            return "";
+    }
+}
+
+/**
+ * @brief One CSV line, the columns after the common ones depend on the type
+ *
+ * @param[in] out
+ * @param[in] record
+ */
+static void PrintRecord(FILE* out, const FlightRecord& record) {
+    fprintf(out, "%" PRIu64 ",%.6f,%s,%u,%.6f", record.seq, record.host_time, TypeName(record.type), record.wno,
+            record.tow);
+    switch (static_cast<FlightRecordType>(record.type)) {
+        case FlightRecordType::ODOMETRY: {
+            const auto& o = record.odometry;
+            fprintf(out,
+                    ",%.4f,%.4f,%.4f,%.6f,%.6f,%.6f,%.6f,%.4f,%.4f,%.4f,%.5f,%.5f,%.5f,%.4f,%.4f,%.4f"
+                    ",%d,%d,%d,%d,%d",
+                    o.position[0], o.position[1], o.position[2], o.orientation[0], o.orientation[1], o.orientation[2],
+                    o.orientation[3], o.velocity[0], o.velocity[1], o.velocity[2], o.angular_velocity[0],
+                    o.angular_velocity[1], o.angular_velocity[2], o.acceleration[0], o.acceleration[1],
+                    o.acceleration[2], o.fusion_status, o.imu_bias_status, o.gnss1_status, o.gnss2_status,
+                    o.wheelspeed_status);
+            break;
+        }
+        case FlightRecordType::RAWIMU:
+        case FlightRecordType::CORRIMU: {
+            const auto& i = record.imu;
+            fprintf(out, ",%.6f,%.6f,%.6f,%.6f,%.6f,%.6f", i.linear_acceleration[0], i.linear_acceleration[1],
+                    i.linear_acceleration[2], i.angular_velocity[0], i.angular_velocity[1], i.angular_velocity[2]);
+            break;
+        }
+        case FlightRecordType::BESTGNSSPOS: {
+            const auto& g = record.gnss;
+            fprintf(out, ",%.9f,%.9f,%.4f,%.4f,%.4f,%.4f,%.4f,%u,%u,%u,%u,%u", g.lat, g.lon, g.hgt, g.undulation,
+                    g.lat_stdev, g.lon_stdev, g.hgt_stdev, g.sol_stat, g.pos_type, g.num_svs, g.num_sol_svs,
+                    g.secondary + 1);
+            break;
+        }
+    }
+    fprintf(out, "\n");
+}
+
+int main(int argc, char** argv) {
+    std::string type;
+    double last = 0.0;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:s:h")) != -1) {
+        switch (opt) {
+            case 't':
+                type = optarg;
+                break;
+            case 's':
+                last = atof(optarg);
+                break;
+            default:
+                optind = argc;
+                break;
+        }
+    }
+    if (optind != argc - 1) {
+        printf("Usage: %s [-t type] [-s seconds] <flight recorder file>\n", argv[0]);
+        printf("  -t  only ODOMETRY, RAWIMU, CORRIMU or BESTGNSSPOS samples\n");
+        printf("  -s  only the last seconds before the newest sample\n");
+        return 1;
+    }
+    std::vector<FlightRecord> records;
+    if (!fixposition::FlightRecorder::ReadFile(argv[optind], records)) {
+        fprintf(stderr, "%s is not a flight recorder file\n", argv[optind]);
+        return 1;
+    }
+    if (records.empty()) {
+        fprintf(stderr, "%s: no samples\n", argv[optind]);
+        return 0;
+    }
+    const double newest = records.back().host_time;
+    fprintf(stderr, "%s: %zu samples, %.1f s, newest %" PRIu64 "\n", argv[optind], records.size(),
+            newest - records.front().host_time, records.back().seq);
+
+    // Columns after tow per type:
+    // - ODOMETRY: x,y,z (ECEF),qw,qx,qy,qz,vx,vy,vz,wx,wy,wz,ax,ay,az,fusion,imu_bias,gnss1,gnss2,wheelspeed status
+    // - RAWIMU, CORRIMU: ax,ay,az,wx,wy,wz
+    // - BESTGNSSPOS: lat,lon,hgt,undulation,lat_std,lon_std,hgt_std,sol_stat,pos_type,svs,sol_svs,gnss (1 or 2)
+    printf("seq,host_time,type,wno,tow,...\n");
+    for (const auto& record : records) {
+        if ((!type.empty() && type != TypeName(record.type)) || (last > 0.0 && record.host_time < newest - last)) {
+            continue;
+        }
+        PrintRecord(stdout, record);
+    }
+    return 0;
+}
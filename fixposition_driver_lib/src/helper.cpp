@@ -12,6 +12,14 @@
  *
  */
 
+/* SYSTEM / STL */
+#include <cstdlib>
+#include <iostream>
+
+/* EXTERNAL */
+#include <boost/throw_exception.hpp>
+#include <boost/version.hpp>
+
 /* PACKAGE */
 #include <fixposition_driver_lib/helper.hpp>
 #include <fixposition_driver_lib/nov_type.hpp>
@@ -82,3 +90,20 @@ void NovToData<BESTGNSSPOSMem, NavSatFixData>(const Oem7MessageHeaderMem* const
 }
 
 }  // namespace fixposition
+
+#ifdef BOOST_NO_EXCEPTIONS
+// Built with -fno-exceptions: Boost calls these instead of throwing. The driver does not use Boost in ways that fail on
+// bad input, so getting here is a bug.
+namespace boost {
+void throw_exception(const std::exception& e) {
+    std::cerr << "Fatal Boost error: " << e.what() << "\n";
+    std::abort();
+}
+#if BOOST_VERSION >= 107300
+void throw_exception(const std::exception& e, const boost::source_location& loc) {
+    std::cerr << "Fatal Boost error: " << e.what() << " at " << loc.file_name() << ":" << loc.line() << "\n";
+    std::abort();
+}
+#endif
+}  // namespace boost
+#endif
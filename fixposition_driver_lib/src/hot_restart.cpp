@@ -0,0 +1,326 @@
+/**
+ *  @file
+ *  @brief Implementation of HotRestart class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <iostream>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/hot_restart.hpp>
+
+namespace fixposition {
+
+static constexpr const uint32_t kHandoffMagic = 0x46504852;  //!< "FPHR"
+static constexpr const uint32_t kHandoffVersion = 2;
+static constexpr const uint8_t kHandoffAck = 'A';
+static constexpr const uint8_t kHandoffConfirm = 'C';
+static constexpr const std::size_t kMaxStateSize = 8192;
+
+/**
+ * @brief Append the bytes of a value
+ *
+ * @param[in] value
+ * @param[out] buf
+ */
+template <typename T>
+static void Put(const T& value, std::vector<uint8_t>& buf) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    buf.insert(buf.end(), bytes, bytes + sizeof(T));
+}
+
+/**
+ * @brief Read a value and advance, if enough bytes are left
+ *
+ * @param[in,out] buf
+ * @param[in,out] size bytes left
+ * @param[out] value
+ * @return true
+ * @return false not enough bytes
+ */
+template <typename T>
+static bool Get(const uint8_t*& buf, std::size_t& size, T& value) {
+    if (size < sizeof(T)) {
+        return false;
+    }
+    memcpy(&value, buf, sizeof(T));
+    buf += sizeof(T);
+    size -= sizeof(T);
+    return true;
+}
+
+static std::vector<uint8_t> Serialize(const HandoffState& state) {
+    std::vector<uint8_t> buf;
+    Put(kHandoffMagic, buf);
+    Put(kHandoffVersion, buf);
+    Put(static_cast<uint8_t>(state.type), buf);
+    Put(state.stream_offset, buf);
+    Put(static_cast<uint8_t>(state.enu0_set), buf);
+    Put(state.t_ecef_enu0.x(), buf);
+    Put(state.t_ecef_enu0.y(), buf);
+    Put(state.t_ecef_enu0.z(), buf);
+    Put(static_cast<uint8_t>(state.termios_set), buf);
+    Put(state.termios, buf);
+    Put(static_cast<uint32_t>(state.pending.size()), buf);
+    buf.insert(buf.end(), state.pending.begin(), state.pending.end());
+    return buf;
+}
+
+static bool Deserialize(const uint8_t* buf, std::size_t size, HandoffState& state) {
+    uint32_t magic = 0, version = 0, pending_size = 0;
+    uint8_t type = 0, enu0_set = 0, termios_set = 0;
+    if (!Get(buf, size, magic) || !Get(buf, size, version) || magic != kHandoffMagic || version != kHandoffVersion) {
+        return false;
+    }
+    if (!Get(buf, size, type) || !Get(buf, size, state.stream_offset) || !Get(buf, size, enu0_set) ||
+        !Get(buf, size, state.t_ecef_enu0.x()) || !Get(buf, size, state.t_ecef_enu0.y()) ||
+        !Get(buf, size, state.t_ecef_enu0.z()) || !Get(buf, size, termios_set) || !Get(buf, size, state.termios) ||
+        !Get(buf, size, pending_size) || size != pending_size) {
+        return false;
+    }
+    state.type = static_cast<INPUT_TYPE>(type);
+    state.enu0_set = enu0_set != 0;
+    state.termios_set = termios_set != 0;
+    state.pending.assign(buf, buf + pending_size);
+    return true;
+}
+
+/**
+ * @brief Wait until fd is readable
+ *
+ * @param[in] fd
+ * @param[in] timeout in [s]
+ * @return true
+ * @return false timeout or error
+ */
+static bool WaitReadable(const int fd, const double timeout) {
+    struct pollfd pfd = {fd, POLLIN, 0};
+    return poll(&pfd, 1, static_cast<int>(timeout * 1000)) > 0 && (pfd.revents & POLLIN);
+}
+
+static bool MakeAddress(const std::string& path, struct sockaddr_un& addr) {
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Hot restart socket path too long: " << path << "\n";
+        return false;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    return true;
+}
+
+HotRestart::HotRestart(const HotRestartParams& params) : params_(params) {}
+
+HotRestart::~HotRestart() {
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+    }
+    struct stat st;
+    if (owner_ && stat(params_.socket.c_str(), &st) == 0 && st.st_ino == inode_) {
+        unlink(params_.socket.c_str());
+    }
+}
+
+/**
+ * @brief Connect to the socket of a running driver, without blocking on a driver that does not accept
+ *
+ * @param[in] addr
+ * @param[out] busy a driver listens but its backlog is full
+ * @return int connected (blocking) socket, -1 if not connected
+ */
+static int ConnectTo(const struct sockaddr_un& addr, bool& busy) {
+    busy = false;
+    const int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        return -1;
+    }
+    if (connect(sock, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+        busy = errno == EAGAIN;
+        close(sock);
+        return -1;
+    }
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) & ~O_NONBLOCK);
+    return sock;
+}
+
+HotRestart::Handoff HotRestart::Receive(int& fd, HandoffState& state) {
+    fd = -1;
+    struct sockaddr_un addr;
+    if (!MakeAddress(params_.socket, addr)) {
+        return Handoff::NONE;
+    }
+    bool busy = false;
+    const int sock = ConnectTo(addr, busy);
+    if (sock < 0) {
+        // Nobody to take over from, the normal case for the first instance
+        return busy ? Handoff::REFUSED : Handoff::NONE;
+    }
+
+    const uint32_t request[2] = {kHandoffMagic, kHandoffVersion};
+    if (send(sock, request, sizeof(request), MSG_NOSIGNAL) != sizeof(request) || !WaitReadable(sock, params_.timeout)) {
+        std::cerr << "Previous driver did not hand over within " << params_.timeout << " s\n";
+        close(sock);
+        return Handoff::REFUSED;
+    }
+
+    std::vector<uint8_t> buf(kMaxStateSize);
+    struct iovec iov = {buf.data(), buf.size()};
+    char control[CMSG_SPACE(sizeof(int))];
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    const ssize_t size = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); size > 0 && cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            memcpy(&fd, CMSG_DATA(cmsg), sizeof(fd));
+        }
+    }
+    // Without a descriptor the previous driver had no connection, the state is still valid
+    if (size <= 0 || !Deserialize(buf.data(), size, state)) {
+        std::cerr << "Invalid handoff from the previous driver\n";
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+        close(sock);
+        return Handoff::REFUSED;
+    }
+
+    // The previous driver may have given up waiting for the ack and carried on. Only its confirm says it stopped for
+    // good, without it the connection stays with the previous driver.
+    uint8_t confirm = 0;
+    const bool ok = send(sock, &kHandoffAck, sizeof(kHandoffAck), MSG_NOSIGNAL) == sizeof(kHandoffAck) &&
+                    WaitReadable(sock, params_.timeout) &&
+                    recv(sock, &confirm, sizeof(confirm), 0) == sizeof(confirm) && confirm == kHandoffConfirm;
+    close(sock);
+    if (!ok) {
+        std::cerr << "Previous driver did not confirm the handoff\n";
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+        return Handoff::REFUSED;
+    }
+    return Handoff::RECEIVED;
+}
+
+bool HotRestart::Listen() {
+    struct sockaddr_un addr;
+    if (!MakeAddress(params_.socket, addr)) {
+        return false;
+    }
+    listen_fd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "Cannot create hot restart socket: " << strerror(errno) << "\n";
+        return false;
+    }
+    // Only replace a socket nobody accepts on anymore, e.g. the one of the driver that handed over
+    bool bound = bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0;
+    if (!bound && errno == EADDRINUSE) {
+        bool busy = false;
+        const int sock = ConnectTo(addr, busy);
+        if (sock >= 0 || busy) {
+            if (sock >= 0) {
+                close(sock);
+            }
+            std::cerr << "Another driver listens on " << params_.socket << "\n";
+            close(listen_fd_);
+            listen_fd_ = -1;
+            return false;
+        }
+        unlink(params_.socket.c_str());
+        bound = bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0;
+    }
+    struct stat st;
+    if (!bound || listen(listen_fd_, 1) != 0 || stat(params_.socket.c_str(), &st) != 0) {
+        std::cerr << "Cannot listen on " << params_.socket << ": " << strerror(errno) << "\n";
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    inode_ = st.st_ino;
+    owner_ = true;
+    return true;
+}
+
+int HotRestart::Accept() {
+    return listen_fd_ < 0 ? -1 : accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+}
+
+bool HotRestart::Send(const int conn, const int fd, const HandoffState& state) {
+    uint32_t request[2] = {0, 0};
+    const ssize_t size = WaitReadable(conn, params_.timeout) ? recv(conn, request, sizeof(request), 0) : -1;
+    if (size == 0) {
+        // Another driver checking whether we still listen, see Listen()
+        close(conn);
+        return false;
+    }
+    if (size != sizeof(request) || request[0] != kHandoffMagic || request[1] != kHandoffVersion) {
+        std::cerr << "Ignoring invalid hot restart request\n";
+        close(conn);
+        return false;
+    }
+
+    std::vector<uint8_t> buf = Serialize(state);
+    struct iovec iov = {buf.data(), buf.size()};
+    char control[CMSG_SPACE(sizeof(int))];
+    memset(control, 0, sizeof(control));
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    if (fd >= 0) {
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &fd, sizeof(fd));
+    }
+
+    // Keep the connection until the successor acks, so a successor dying halfway does not lose it. The decision is
+    // ours: the successor uses the connection only after the confirm, and a closed socket without it tells it that we
+    // carry on.
+    uint8_t ack = 0;
+    const bool ok = sendmsg(conn, &msg, MSG_NOSIGNAL) == static_cast<ssize_t>(buf.size()) &&
+                    WaitReadable(conn, params_.timeout) && recv(conn, &ack, sizeof(ack), 0) == sizeof(ack) &&
+                    ack == kHandoffAck;
+    if (!ok) {
+        close(conn);
+        std::cerr << "Successor did not take over, carrying on\n";
+        return false;
+    }
+    // Stop listening first, the successor replaces the socket as soon as it has the confirm. Once sent, the connection
+    // is not ours anymore. If the confirm is lost, the successor asks again, finds nobody and connects anew.
+    close(listen_fd_);
+    listen_fd_ = -1;
+    owner_ = false;
+    send(conn, &kHandoffConfirm, sizeof(kHandoffConfirm), MSG_NOSIGNAL);
+    close(conn);
+    return true;
+}
+
+}  // namespace fixposition
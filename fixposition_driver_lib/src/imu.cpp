@@ -32,7 +32,7 @@ static constexpr const int rot_x_idx = 8;
 static constexpr const int rot_y_idx = 9;
 static constexpr const int rot_z_idx = 10;
 
-void ImuConverter::ConvertTokens(const std::vector<std::string>& tokens) {
+bool ImuConverter::ConvertTokens(const std::vector<std::string>& tokens) {
     bool ok = tokens.size() == kSize_;
     if (!ok) {
         // Size is wrong
@@ -40,9 +40,9 @@ void ImuConverter::ConvertTokens(const std::vector<std::string>& tokens) {
 
     } else {
         // If size is ok, check version
-        const int version = std::stoi(tokens.at(msg_version_idx));
+        const int version = StringToInt(tokens[msg_version_idx], ok);
 
-        ok = version == kVersion_;
+        ok = ok && version == kVersion_;
         if (!ok) {
             // Version is wrong
             std::cout << "Error in parsing IMU string with verion " << version << " ! IMU message will be empty.\n";
@@ -52,18 +52,25 @@ void ImuConverter::ConvertTokens(const std::vector<std::string>& tokens) {
     if (!ok) {
         // Reset message and return
         msg_ = ImuData();
-        return;
+        return false;
     }
     // header stamps
-    msg_.stamp = ConvertGpsTime(tokens.at(gps_week_idx), tokens.at(gps_tow_idx));
-    msg_.linear_acceleration = Vector3ToEigen(tokens.at(acc_x_idx), tokens.at(acc_y_idx), tokens.at(acc_z_idx));
-    msg_.angular_velocity = Vector3ToEigen(tokens.at(rot_x_idx), tokens.at(rot_y_idx), tokens.at(rot_z_idx));
+    msg_.stamp = ConvertGpsTime(tokens[gps_week_idx], tokens[gps_tow_idx], ok);
+    msg_.linear_acceleration = Vector3ToEigen(tokens[acc_x_idx], tokens[acc_y_idx], tokens[acc_z_idx], ok);
+    msg_.angular_velocity = Vector3ToEigen(tokens[rot_x_idx], tokens[rot_y_idx], tokens[rot_z_idx], ok);
     msg_.frame_id = "FP_VRTK";
     
+    if (!ok) {
+        // Malformed number
+        msg_ = ImuData();
+        return false;
+    }
+
     // process all observers
     for (auto& ob : obs_) {
         ob(msg_);
     }
+    return true;
 }
 
 }  // namespace fixposition
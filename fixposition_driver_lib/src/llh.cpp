@@ -32,7 +32,7 @@ static constexpr const int pos_cov_en_idx = 11;
 static constexpr const int pos_cov_nu_idx = 12;
 static constexpr const int pos_cov_eu_idx = 13;
 
-void LlhConverter::ConvertTokens(const std::vector<std::string>& tokens) {
+bool LlhConverter::ConvertTokens(const std::vector<std::string>& tokens) {
     bool ok = tokens.size() == kSize_;
     if (!ok) {
         // Size is wrong
@@ -41,9 +41,9 @@ void LlhConverter::ConvertTokens(const std::vector<std::string>& tokens) {
 
     } else {
         // If size is ok, check version
-        const int version = std::stoi(tokens.at(msg_version_idx));
+        const int version = StringToInt(tokens[msg_version_idx], ok);
 
-        ok = version == kVersion_;
+        ok = ok && version == kVersion_;
         if (!ok) {
             // Version is wrong
             std::cout << "Error in parsing LLH string with verion " << version
@@ -54,32 +54,39 @@ void LlhConverter::ConvertTokens(const std::vector<std::string>& tokens) {
     if (!ok) {
         // Reset message and return
         msg_ = NavSatFixData();
-        return;
+        return false;
     }
 
     // header stamps
-    msg_.stamp = ConvertGpsTime(tokens.at(gps_week_idx), tokens.at(gps_tow_idx));
+    msg_.stamp = ConvertGpsTime(tokens[gps_week_idx], tokens[gps_tow_idx], ok);
 
     msg_.frame_id = "FP_POI";
-    msg_.latitude = StringToDouble(tokens.at(latitude_idx));
-    msg_.longitude = StringToDouble(tokens.at(longitude_idx));
-    msg_.altitude = StringToDouble(tokens.at(height_idx));
+    msg_.latitude = StringToDouble(tokens[latitude_idx], ok);
+    msg_.longitude = StringToDouble(tokens[longitude_idx], ok);
+    msg_.altitude = StringToDouble(tokens[height_idx], ok);
 
     // Covariance diagonals
-    msg_.cov(0, 0) = StringToDouble(tokens.at(pos_cov_ee_idx));
-    msg_.cov(1, 1) = StringToDouble(tokens.at(pos_cov_nn_idx));
-    msg_.cov(2, 2) = StringToDouble(tokens.at(pos_cov_uu_idx));
+    msg_.cov(0, 0) = StringToDouble(tokens[pos_cov_ee_idx], ok);
+    msg_.cov(1, 1) = StringToDouble(tokens[pos_cov_nn_idx], ok);
+    msg_.cov(2, 2) = StringToDouble(tokens[pos_cov_uu_idx], ok);
 
     // Rest of covariance fields
-    msg_.cov(0, 1) = msg_.cov(1, 0) = StringToDouble(tokens.at(pos_cov_en_idx));
-    msg_.cov(0, 2) = msg_.cov(2, 0) = StringToDouble(tokens.at(pos_cov_nu_idx));
-    msg_.cov(1, 2) = msg_.cov(2, 1) = StringToDouble(tokens.at(pos_cov_eu_idx));
+    msg_.cov(0, 1) = msg_.cov(1, 0) = StringToDouble(tokens[pos_cov_en_idx], ok);
+    msg_.cov(1, 2) = msg_.cov(2, 1) = StringToDouble(tokens[pos_cov_nu_idx], ok);
+    msg_.cov(0, 2) = msg_.cov(2, 0) = StringToDouble(tokens[pos_cov_eu_idx], ok);
     msg_.position_covariance_type = 3;
 
+    if (!ok) {
+        // Malformed number
+        msg_ = NavSatFixData();
+        return false;
+    }
+
     // process all observers
     for (auto& ob : obs_) {
         ob(msg_);
     }
+    return true;
 }
 
 }  // namespace fixposition
@@ -0,0 +1,79 @@
+/**
+ *  @file
+ *  @brief Implementation of LoadShedder class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <algorithm>
+#include <iostream>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/load_shedder.hpp>
+
+namespace fixposition {
+
+LoadShedder::LoadShedder(const LoadSheddingParams& params) : params_(params) {
+    for (std::size_t i = 0; i < params_.types.size() && i < params_.priorities.size(); i++) {
+        priority_[params_.types[i]] = std::max(0, params_.priorities[i]);
+        max_priority_ = std::max(max_priority_, params_.priorities[i]);
+    }
+    params_.decimation = std::max(1, params_.decimation);
+}
+
+int LoadShedder::Priority(const std::string& type) const {
+    const auto it = priority_.find(type);
+    return it == priority_.end() ? 1 : it->second;
+}
+
+bool LoadShedder::Accept(const std::string& type) {
+    const int priority = Priority(type);
+    if (level_ == 0 || priority == 0) {
+        return true;
+    }
+
+    // How deep into this priority we are: <= 0 untouched, 1 decimated, >= 2 dropped
+    const int stage = level_ - (max_priority_ - priority);
+    if (stage <= 0) {
+        return true;
+    }
+    if (stage == 1 && (passed_[type]++ % params_.decimation) == 0) {
+        return true;
+    }
+    shed_[type]++;
+    return false;
+}
+
+void LoadShedder::Update(const double processing_time, const int backlog) {
+    if (!params_.enabled) {
+        return;
+    }
+
+    const int old_level = level_;
+    if (processing_time > params_.time_budget || backlog > params_.backlog_budget) {
+        level_ = std::min(level_ + 1, max_priority_ + 1);
+        calm_reads_ = 0;
+    } else if (processing_time < 0.5 * params_.time_budget && backlog < params_.backlog_budget / 2) {
+        if (++calm_reads_ >= kCalmReads && level_ > 0) {
+            level_--;
+            calm_reads_ = 0;
+        }
+    } else {
+        calm_reads_ = 0;
+    }
+
+    if (level_ != old_level) {
+        std::cout << "Load shedding level " << level_ << " (processing " << processing_time * 1e3 << " ms, backlog "
+                  << backlog << " bytes)\n";
+    }
+}
+
+}  // namespace fixposition
@@ -12,6 +12,9 @@
  *
  */
 
+/* SYSTEM / STL */
+#include <cmath>
+
 /* EXTERNAL */
 #include <eigen3/Eigen/Core>
 #include <eigen3/Eigen/Geometry>
@@ -71,22 +74,25 @@ static constexpr const int vel_cov_yz_idx = 42;
 static constexpr const int vel_cov_xz_idx = 43;
 static constexpr const int sw_version_idx = 44;
 
+static const std::string kUnknownVersion = "UNKNOWN";
+
 /**
  * @brief Parse status flag field
  *
  * @param[in] tokens list of tokens
  * @param[in] idx status flag index
- * @return int
+ * @param[in,out] ok set to false if the field is malformed
+ * @return int -1 if the field is empty
  */
-int ParseStatusFlag(const std::vector<std::string>& tokens, const int idx) {
-    if (tokens.at(idx).empty()) {
+int ParseStatusFlag(const std::vector<std::string>& tokens, const int idx, bool& ok) {
+    if (tokens[idx].empty()) {
         return -1;
     } else {
-        return std::stoi(tokens.at(idx));
+        return StringToInt(tokens[idx], ok);
     }
 }
 
-void OdometryConverter::ConvertTokens(const std::vector<std::string>& tokens) {
+bool OdometryConverter::ConvertTokens(const std::vector<std::string>& tokens) {
     bool ok = tokens.size() == kSize_;
     if (!ok) {
         // Size is wrong
@@ -95,9 +101,9 @@ void OdometryConverter::ConvertTokens(const std::vector<std::string>& tokens) {
 
     } else {
         // If size is ok, check version
-        const int version = std::stoi(tokens.at(msg_version_idx));
+        const int version = StringToInt(tokens[msg_version_idx], ok);
 
-        ok = version == kVersion_;
+        ok = ok && version == kVersion_;
         if (!ok) {
             // Version is wrong
             std::cout << "Error in parsing Odometry string with verion " << version
@@ -108,26 +114,67 @@ void OdometryConverter::ConvertTokens(const std::vector<std::string>& tokens) {
     if (!ok) {
         // Reset message and return
         msgs_ = Msgs();
-        return;
+        return false;
     }
 
-    const int fusion_status = ParseStatusFlag(tokens, fusion_status_idx);
+    // Parse all numbers before anything is updated, a malformed message leaves the converter as it was
+    const int fusion_status = ParseStatusFlag(tokens, fusion_status_idx, ok);
+    const int imu_bias_status = ParseStatusFlag(tokens, imu_bias_status_idx, ok);
+    const int gnss1_status = ParseStatusFlag(tokens, gnss1_fix_type_idx, ok);
+    const int gnss2_status = ParseStatusFlag(tokens, gnss2_fix_type_idx, ok);
+    const int wheelspeed_status = ParseStatusFlag(tokens, wheelspeed_status_idx, ok);
 
     const bool fusion_init = fusion_status >= 3;
 
     // common data
-    const auto stamp = ConvertGpsTime(tokens.at(gps_week_idx), tokens.at(gps_tow_idx));
-    const Eigen::Vector3d t_ecef_body =
-        Vector3ToEigen(tokens.at(pos_x_idx), tokens.at(pos_y_idx), tokens.at(pos_z_idx));
-    const Eigen::Quaterniond q_ecef_body = Vector4ToEigen(tokens.at(orientation_w_idx), tokens.at(orientation_x_idx),
-                                                          tokens.at(orientation_y_idx), tokens.at(orientation_z_idx));
+    const auto stamp = ConvertGpsTime(tokens[gps_week_idx], tokens[gps_tow_idx], ok);
+    Eigen::Vector3d t_ecef_body = Vector3ToEigen(tokens[pos_x_idx], tokens[pos_y_idx], tokens[pos_z_idx], ok);
+    Eigen::Quaterniond q_ecef_body = Vector4ToEigen(tokens[orientation_w_idx], tokens[orientation_x_idx],
+                                                    tokens[orientation_y_idx], tokens[orientation_z_idx], ok);
+    const Eigen::Vector3d acc = Vector3ToEigen(tokens[acc_x_idx], tokens[acc_y_idx], tokens[acc_z_idx], ok);
+    if (!ok) {
+        return false;
+    }
+
+    msgs_.llh_valid = false;
     if (fusion_init) {
+        // Pose & Cov
+        const Eigen::Matrix<double, 6, 6> pose_cov = BuildCovMat6D(
+            StringToDouble(tokens[pos_cov_xx_idx], ok), StringToDouble(tokens[pos_cov_yy_idx], ok),
+            StringToDouble(tokens[pos_cov_zz_idx], ok), StringToDouble(tokens[pos_cov_xy_idx], ok),
+            StringToDouble(tokens[pos_cov_yz_idx], ok), StringToDouble(tokens[pos_cov_xz_idx], ok),
+            StringToDouble(tokens[orientation_cov_xx_idx], ok), StringToDouble(tokens[orientation_cov_yy_idx], ok),
+            StringToDouble(tokens[orientation_cov_zz_idx], ok), StringToDouble(tokens[orientation_cov_xy_idx], ok),
+            StringToDouble(tokens[orientation_cov_yz_idx], ok), StringToDouble(tokens[orientation_cov_xz_idx], ok));
+
+        // Twist & Cov
+        const Eigen::Vector3d linear = Vector3ToEigen(tokens[vel_x_idx], tokens[vel_y_idx], tokens[vel_z_idx], ok);
+        const Eigen::Vector3d angular = Vector3ToEigen(tokens[rot_x_idx], tokens[rot_y_idx], tokens[rot_z_idx], ok);
+        const Eigen::Matrix<double, 6, 6> twist_cov = BuildCovMat6D(
+            StringToDouble(tokens[vel_cov_xx_idx], ok), StringToDouble(tokens[vel_cov_yy_idx], ok),
+            StringToDouble(tokens[vel_cov_zz_idx], ok), StringToDouble(tokens[vel_cov_xy_idx], ok),
+            StringToDouble(tokens[vel_cov_yz_idx], ok), StringToDouble(tokens[vel_cov_xz_idx], ok), 0, 0, 0, 0, 0, 0);
+        if (!ok) {
+            return false;
+        }
+        msgs_.odometry.pose.cov = pose_cov;
+        msgs_.odometry.twist.linear = linear;
+        msgs_.odometry.twist.angular = angular;
+        msgs_.odometry.twist.cov = twist_cov;
+
+        // Everything below is for the vehicle frame if configured
+        if (extrinsic_.Enabled()) {
+            extrinsic_.TransformPose(t_ecef_body, q_ecef_body, msgs_.odometry.pose.cov);
+            extrinsic_.TransformTwist(msgs_.odometry.twist.linear, msgs_.odometry.twist.angular,
+                                      msgs_.odometry.twist.cov);
+        }
+
         //  TFs
         msgs_.tf_ecef_enu.stamp = stamp;
         msgs_.tf_ecef_poi.stamp = stamp;
         msgs_.tf_ecef_enu.frame_id = "ECEF";
         msgs_.tf_ecef_poi.frame_id = "ECEF";
-        msgs_.tf_ecef_poi.child_frame_id = "gnss";
+        msgs_.tf_ecef_poi.child_frame_id = child_frame_id_;
         msgs_.tf_ecef_enu.child_frame_id = "FP_ENU";  // The ENU frame at the position of gnss
 
         // static TF ECEF ENU0
@@ -161,34 +208,19 @@ void OdometryConverter::ConvertTokens(const std::vector<std::string>& tokens) {
 
         msgs_.odometry.stamp = stamp;
         msgs_.odometry.frame_id = "ECEF";
-        msgs_.odometry.child_frame_id = "gnss";
+        msgs_.odometry.child_frame_id = child_frame_id_;
 
         msgs_.vrtk.stamp = stamp;
         msgs_.vrtk.frame_id = "ECEF";
-        msgs_.vrtk.pose_frame = "gnss";
-        msgs_.vrtk.kin_frame = "gnss";
+        msgs_.vrtk.pose_frame = child_frame_id_;
+        msgs_.vrtk.kin_frame = child_frame_id_;
 
-        // Pose & Cov
+        // Pose
         msgs_.odometry.pose.position = (t_ecef_body);
         msgs_.odometry.pose.orientation = (q_ecef_body);
-        msgs_.odometry.pose.cov = BuildCovMat6D(
-            StringToDouble(tokens.at(pos_cov_xx_idx)), StringToDouble(tokens.at(pos_cov_yy_idx)),
-            StringToDouble(tokens.at(pos_cov_zz_idx)), StringToDouble(tokens.at(pos_cov_xy_idx)),
-            StringToDouble(tokens.at(pos_cov_yz_idx)), StringToDouble(tokens.at(pos_cov_xz_idx)),
-            StringToDouble(tokens.at(orientation_cov_xx_idx)), StringToDouble(tokens.at(orientation_cov_yy_idx)),
-            StringToDouble(tokens.at(orientation_cov_zz_idx)), StringToDouble(tokens.at(orientation_cov_xy_idx)),
-            StringToDouble(tokens.at(orientation_cov_yz_idx)), StringToDouble(tokens.at(orientation_cov_xz_idx)));
         msgs_.vrtk.pose = msgs_.odometry.pose;
 
-        // Twist & Cov
-        // Linear
-        msgs_.odometry.twist.linear = Vector3ToEigen(tokens.at(vel_x_idx), tokens.at(vel_y_idx), tokens.at(vel_z_idx));
-        // Angular
-        msgs_.odometry.twist.angular = Vector3ToEigen(tokens.at(rot_x_idx), tokens.at(rot_y_idx), tokens.at(rot_z_idx));
-        msgs_.odometry.twist.cov = BuildCovMat6D(
-            StringToDouble(tokens.at(vel_cov_xx_idx)), StringToDouble(tokens.at(vel_cov_yy_idx)),
-            StringToDouble(tokens.at(vel_cov_zz_idx)), StringToDouble(tokens.at(vel_cov_xy_idx)),
-            StringToDouble(tokens.at(vel_cov_yz_idx)), StringToDouble(tokens.at(vel_cov_xz_idx)), 0, 0, 0, 0, 0, 0);
+        // Twist
         msgs_.vrtk.velocity = msgs_.odometry.twist;
 
         // Euler angle wrt. ENU frame in the order of Yaw Pitch Roll
@@ -197,7 +229,7 @@ void OdometryConverter::ConvertTokens(const std::vector<std::string>& tokens) {
         // Odmetry msg ENU0 - gnss
         msgs_.odometry_enu0.stamp = stamp;
         msgs_.odometry_enu0.frame_id = "FP_ENU0";
-        msgs_.odometry_enu0.child_frame_id = "gnss";
+        msgs_.odometry_enu0.child_frame_id = child_frame_id_;
         // Pose
         // convert position in ECEF into position in ENU0
         const Eigen::Vector3d t_enu0_body = gnss_tf::TfEnuEcef(t_ecef_body, gnss_tf::TfWgs84LlhEcef(t_ecef_enu0_));
@@ -215,6 +247,21 @@ void OdometryConverter::ConvertTokens(const std::vector<std::string>& tokens) {
 
         // Twist is the same as it is in the gnss frame
         msgs_.odometry_enu0.twist = msgs_.odometry.twist;
+
+        // LLH as in the FP,LLH message: degrees, ellipsoidal height and the position covariance in local ENU
+        if (derive_llh_) {
+            const Eigen::Vector3d llh = gnss_tf::TfWgs84LlhEcef(t_ecef_body);
+            const Eigen::Matrix3d rot_enu_ecef = gnss_tf::RotEnuEcef(llh(0), llh(1));
+            msgs_.llh.stamp = stamp;
+            // Same frame as FP,LLH unless the position was moved to the vehicle frame
+            msgs_.llh.frame_id = extrinsic_.Enabled() ? extrinsic_.FrameId() : "FP_POI";
+            msgs_.llh.latitude = llh(0) * 180.0 / M_PI;
+            msgs_.llh.longitude = llh(1) * 180.0 / M_PI;
+            msgs_.llh.altitude = llh(2);
+            msgs_.llh.cov = rot_enu_ecef * cov_ecef.topLeftCorner(3, 3) * rot_enu_ecef.transpose();
+            msgs_.llh.position_covariance_type = 3;
+            msgs_.llh_valid = true;
+        }
     }
 
     // Msgs
@@ -222,23 +269,48 @@ void OdometryConverter::ConvertTokens(const std::vector<std::string>& tokens) {
 
     // Status, regardless of fusion_init
     msgs_.vrtk.fusion_status = fusion_status;
-    msgs_.vrtk.imu_bias_status = ParseStatusFlag(tokens, imu_bias_status_idx);
-    msgs_.vrtk.gnss1_status = ParseStatusFlag(tokens, gnss1_fix_type_idx);
-    msgs_.vrtk.gnss2_status = ParseStatusFlag(tokens, gnss2_fix_type_idx);
-    msgs_.vrtk.wheelspeed_status = ParseStatusFlag(tokens, wheelspeed_status_idx);
-    msgs_.vrtk.version = tokens.at(sw_version_idx).empty() ? "UNKNOWN" : tokens.at(sw_version_idx);
+    msgs_.vrtk.imu_bias_status = imu_bias_status;
+    msgs_.vrtk.gnss1_status = gnss1_status;
+    msgs_.vrtk.gnss2_status = gnss2_status;
+    msgs_.vrtk.wheelspeed_status = wheelspeed_status;
+    // The version hardly ever changes, only copy it if it did
+    const std::string& version = tokens[sw_version_idx].empty() ? kUnknownVersion : tokens[sw_version_idx];
+    if (msgs_.vrtk.version != version) {
+        msgs_.vrtk.version = version;
+    }
 
     // POI IMU Message
     msgs_.imu.stamp = stamp;
-    msgs_.imu.frame_id = "gnss";
+    msgs_.imu.frame_id = child_frame_id_;
     // Omega
     msgs_.imu.angular_velocity = msgs_.odometry.twist.angular;
     // Acceleration
-    msgs_.imu.linear_acceleration = Vector3ToEigen(tokens.at(acc_x_idx), tokens.at(acc_y_idx), tokens.at(acc_z_idx));
+    msgs_.imu.linear_acceleration = acc;
+    if (extrinsic_.Enabled()) {
+        extrinsic_.TransformAcceleration(msgs_.imu.linear_acceleration, msgs_.imu.angular_velocity);
+    }
 
     // process all observers
     for (auto& ob : obs_) {
         ob(msgs_);
     }
+    return true;
 }
+
+bool OdometryConverter::GetEnu0(Eigen::Vector3d& t_ecef_enu0) const {
+    if (!tf_ecef_enu0_set_) {
+        return false;
+    }
+    t_ecef_enu0 = t_ecef_enu0_;
+    return true;
+}
+
+void OdometryConverter::SetEnu0(const Eigen::Vector3d& t_ecef_enu0) {
+    t_ecef_enu0_ = t_ecef_enu0;
+    q_ecef_enu0_ = Eigen::Quaterniond(gnss_tf::RotEnuEcef(t_ecef_enu0).transpose());
+    msgs_.tf_ecef_enu0.translation = t_ecef_enu0_;
+    msgs_.tf_ecef_enu0.rotation = q_ecef_enu0_;
+    tf_ecef_enu0_set_ = true;
+}
+
 }  // namespace fixposition
@@ -12,6 +12,9 @@
  *
  */
 
+/* SYSTEM / STL */
+#include <array>
+
 /* PACKAGE */
 #include <fixposition_driver_lib/helper.hpp>
 #include <fixposition_driver_lib/nov_type.hpp>
@@ -21,6 +24,9 @@ namespace fixposition {
 static constexpr const char kNmeaPreamble = '$';
 static constexpr const int kLibParserMaxNmeaSize = 400;
 static constexpr const int kLibParserMaxNovSize = 4096;
+static constexpr const uint8_t kRtcm3Preamble = 0xd3;
+static constexpr const int kRtcm3HeaderSize = 3;  //!< preamble, 6 reserved bits and the 10 bit payload length
+static constexpr const int kRtcm3CrcSize = 3;
 
 int IsNmeaMessage(const char* buf, const int size) {
     // Start of sentence
@@ -136,4 +142,53 @@ int IsNovMessage(const uint8_t* buf, const int size) {
     }
 }
 
+uint32_t rtcm3_crc24q(const uint8_t* data, const int size) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t;
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i << 16;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x800000) ? (crc << 1) ^ 0x1864cfb : crc << 1;
+            }
+            t[i] = crc & 0xffffff;
+        }
+        return t;
+    }();
+    uint32_t crc = 0;
+    for (int i = 0; i < size; i++) {
+        crc = ((crc << 8) & 0xffffff) ^ table[((crc >> 16) ^ data[i]) & 0xff];
+    }
+    return crc;
+}
+
+int IsRtcm3Message(const uint8_t* buf, const int size) {
+    if (buf[0] != kRtcm3Preamble) {
+        return 0;
+    }
+    if (size < kRtcm3HeaderSize) {
+        return -1;
+    }
+    if ((buf[1] & 0xfc) != 0) {
+        return 0;
+    }
+    const int len = kRtcm3HeaderSize + (((buf[1] & 0x03) << 8) | buf[2]) + kRtcm3CrcSize;
+    if (size < len) {
+        return -1;
+    }
+    const uint32_t crc = (buf[len - 3] << 16) | (buf[len - 2] << 8) | buf[len - 1];
+    return crc == rtcm3_crc24q(buf, len - kRtcm3CrcSize) ? len : 0;
+}
+
+std::string GetFpaHeader(const char* buf, const int size) {
+    static constexpr const int kFpaPrefixSize = 4;  // "$FP,"
+    if (size < kFpaPrefixSize || buf[0] != kNmeaPreamble || buf[1] != 'F' || buf[2] != 'P' || buf[3] != ',') {
+        return "";
+    }
+    int end = kFpaPrefixSize;
+    while (end < size && buf[end] != ',' && buf[end] != '*') {
+        end++;
+    }
+    return std::string(buf + kFpaPrefixSize, end - kFpaPrefixSize);
+}
+
 }  // namespace fixposition
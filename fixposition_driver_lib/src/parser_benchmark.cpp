@@ -0,0 +1,251 @@
+/**
+ *  @file
+ *  @brief Per-message cost of framing, tokenizing and converting a recorded sensor output
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/converter/imu.hpp>
+#include <fixposition_driver_lib/converter/llh.hpp>
+#include <fixposition_driver_lib/converter/odometry.hpp>
+#include <fixposition_driver_lib/converter/tf.hpp>
+#include <fixposition_driver_lib/helper.hpp>
+#include <fixposition_driver_lib/perf_counters.hpp>
+#include <fixposition_driver_lib/stream_framer.hpp>
+
+using fixposition::PerfCounters;
+
+static constexpr const int kReadSize = 1024;  //!< chunk size fed to the framer, like a read from the sensor
+
+/**
+ * @brief Result of one benchmark stage
+ *
+ */
+struct StageResult {
+    std::string name;
+    uint64_t messages = 0;  //!< messages per run
+    uint64_t ok = 0;        //!< messages per run the stage accepted
+    double time = 0.0;      //!< [s] over all runs
+    PerfCounters::Values counters = {};
+};
+
+/**
+ * @brief Run a stage several times, timing it and counting its events
+ *
+ * @param[in] name
+ * @param[in] messages number of messages one run processes
+ * @param[in] runs
+ * @param[in] perf counters, nullptr to only measure the time
+ * @param[in] run processes all messages once, returns the number of messages accepted
+ * @return StageResult
+ */
+template <typename RunT>
+static StageResult Measure(const std::string& name, const uint64_t messages, const int runs, PerfCounters* perf,
+                           RunT run) {
+    StageResult result;
+    result.name = name;
+    result.messages = messages;
+    result.ok = run();  // warm up caches and branch predictors
+    for (int i = 0; i < runs; i++) {
+        if (perf != nullptr) {
+            perf->Start();
+        }
+        const auto t0 = std::chrono::steady_clock::now();
+        run();
+        result.time += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (perf != nullptr) {
+            const PerfCounters::Values& values = perf->Stop();
+            for (int c = 0; c < PerfCounters::NUM_COUNTERS; c++) {
+                result.counters[c] += values[c];
+            }
+        }
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    bool use_perf = false;
+    int runs = 5;
+    int opt;
+    while ((opt = getopt(argc, argv, "pr:h")) != -1) {
+        switch (opt) {
+            case 'p':
+                use_perf = true;
+                break;
+            case 'r':
+                runs = std::max(1, atoi(optarg));
+                break;
+            default:
+                printf("Usage: %s [-p] [-r runs] <recorded sensor output>\n", argv[0]);
+                printf("  -p  collect hardware performance counters (perf_event_open)\n");
+                printf("  -r  number of measured runs of each stage (default 5)\n");
+                return 1;
+        }
+    }
+    if (optind >= argc) {
+        printf("Usage: %s [-p] [-r runs] <recorded sensor output>\n", argv[0]);
+        return 1;
+    }
+    std::ifstream file(argv[optind], std::ios::binary);
+    if (!file.is_open()) {
+        printf("Cannot open %s\n", argv[optind]);
+        return 1;
+    }
+    const std::vector<uint8_t> capture((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    PerfCounters counters;
+    PerfCounters* perf = nullptr;
+    if (use_perf) {
+        if (counters.Open()) {
+            perf = &counters;
+        } else {
+            printf("No performance counters available (kernel.perf_event_paranoid > 2 or no PMU), timing only\n");
+        }
+    }
+
+    // Collect the input of each stage once, outside of the measurements
+    std::vector<std::string> sentences;
+    uint64_t frames = 0;
+    fixposition::StreamFramer collector;
+    collector.AddObserver([&](const fixposition::StreamFramer::FrameType type, const uint8_t* frame, const int size,
+                              const uint64_t) {
+        frames++;
+        if (type == fixposition::StreamFramer::FrameType::NMEA) {
+            sentences.emplace_back(reinterpret_cast<const char*>(frame), size);
+        }
+    });
+    collector.Process(capture.data(), static_cast<int>(capture.size()));
+
+    std::map<std::string, std::vector<std::vector<std::string>>> tokens_by_type;
+    for (const auto& sentence : sentences) {
+        std::vector<std::string> tokens;
+        fixposition::SplitMessage(tokens, sentence.substr(1, sentence.find_last_of('*') - 1), ",");
+        if (tokens.size() >= 2 && tokens[0] == "FP") {
+            tokens_by_type[tokens[1]].push_back(std::move(tokens));
+        }
+    }
+
+    fixposition::OdometryConverter odometry;
+    fixposition::LlhConverter llh;
+    fixposition::ImuConverter rawimu(false);
+    fixposition::ImuConverter corrimu(true);
+    fixposition::TfConverter tf;
+    const std::map<std::string, fixposition::BaseAsciiConverter*> converters = {
+        {"ODOMETRY", &odometry}, {"LLH", &llh}, {"RAWIMU", &rawimu}, {"CORRIMU", &corrimu}, {"TF", &tf}};
+
+    // Converters are measured on the messages they accept, rejecting a message (e.g. an older version) takes a
+    // different path. The converters report rejected messages on stdout, silence them while sorting out.
+    std::map<std::string, uint64_t> rejected;
+    std::ofstream null_stream;
+    std::streambuf* cout_buf = std::cout.rdbuf(null_stream.rdbuf());
+    for (auto& entry : tokens_by_type) {
+        const auto converter = converters.find(entry.first);
+        if (converter == converters.end()) {
+            continue;
+        }
+        auto& messages = entry.second;
+        const auto accepted = std::stable_partition(messages.begin(), messages.end(),
+                                                    [&](const std::vector<std::string>& tokens) {
+                                                        return converter->second->ConvertTokens(tokens);
+                                                    });
+        rejected[entry.first] = std::distance(accepted, messages.end());
+        messages.erase(accepted, messages.end());
+    }
+    std::cout.rdbuf(cout_buf);
+
+    // Stages, in the order the driver runs them
+    std::vector<StageResult> results;
+    results.push_back(Measure("framing", frames, runs, perf, [&]() {
+        uint64_t count = 0;
+        fixposition::StreamFramer framer;
+        framer.AddObserver([&count](const fixposition::StreamFramer::FrameType, const uint8_t*, const int,
+                                    const uint64_t) { count++; });
+        for (std::size_t pos = 0; pos < capture.size(); pos += kReadSize) {
+            const std::size_t size = std::min<std::size_t>(kReadSize, capture.size() - pos);
+            framer.Process(capture.data() + pos, static_cast<int>(size));
+        }
+        return count;
+    }));
+    results.push_back(Measure("tokenizing", sentences.size(), runs, perf, [&]() {
+        uint64_t count = 0;
+        std::vector<std::string> tokens;
+        for (const auto& sentence : sentences) {
+            fixposition::SplitMessage(tokens, sentence.substr(1, sentence.find_last_of('*') - 1), ",");
+            count += tokens.size() >= 2 ? 1 : 0;
+        }
+        return count;
+    }));
+    for (const auto& entry : converters) {
+        const auto& messages = tokens_by_type[entry.first];
+        if (rejected[entry.first] > 0) {
+            printf("%s: %lu messages rejected by the converter, not measured\n", entry.first.c_str(),
+                   rejected[entry.first]);
+        }
+        if (messages.empty()) {
+            continue;
+        }
+        fixposition::BaseAsciiConverter& converter = *entry.second;
+        results.push_back(Measure(entry.first, messages.size(), runs, perf, [&]() {
+            uint64_t count = 0;
+            for (const auto& tokens : messages) {
+                count += converter.ConvertTokens(tokens) ? 1 : 0;
+            }
+            return count;
+        }));
+    }
+
+    // Report, per message
+    printf("\n%zu bytes, %lu frames, %d runs per stage\n\n", capture.size(), frames, runs);
+    printf("%-12s %8s %8s %9s", "stage", "msgs", "ok", "ns/msg");
+    if (perf != nullptr) {
+        for (int c = 0; c < PerfCounters::NUM_COUNTERS; c++) {
+            printf(" %9s", PerfCounters::Name(static_cast<PerfCounters::Counter>(c)));
+        }
+        printf(" %6s", "IPC");
+    }
+    printf("\n");
+    for (const auto& result : results) {
+        const double n = static_cast<double>(result.messages) * runs;
+        printf("%-12s %8lu %8lu %9.1f", result.name.c_str(), result.messages, result.ok,
+               n > 0 ? result.time * 1e9 / n : 0.0);
+        if (perf != nullptr) {
+            for (int c = 0; c < PerfCounters::NUM_COUNTERS; c++) {
+                if (perf->Available(static_cast<PerfCounters::Counter>(c))) {
+                    printf(" %9.1f", n > 0 ? result.counters[c] / n : 0.0);
+                } else {
+                    printf(" %9s", "-");
+                }
+            }
+            const double cycles = result.counters[PerfCounters::CYCLES];
+            if ((cycles > 0.0) && perf->Available(PerfCounters::INSTRUCTIONS)) {
+                printf(" %6.2f", result.counters[PerfCounters::INSTRUCTIONS] / cycles);
+            } else {
+                printf(" %6s", "-");
+            }
+        }
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ *  @file
+ *  @brief Implementation of PerfCounters class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/perf_counters.hpp>
+
+namespace fixposition {
+
+/**
+ * @brief Open one counter of the calling thread, user space only, disabled
+ *
+ * @param[in] type PERF_TYPE_...
+ * @param[in] config
+ * @return int file descriptor, -1 if not available
+ */
+static int OpenCounter(const uint32_t type, const uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+PerfCounters::PerfCounters() {
+    fds_.fill(-1);
+    values_.fill(0.0);
+}
+
+PerfCounters::~PerfCounters() {
+    for (auto& fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+}
+
+bool PerfCounters::Open() {
+    static constexpr const uint64_t kL1dReadMiss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                                   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    fds_[CYCLES] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds_[INSTRUCTIONS] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds_[BRANCH_MISSES] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    fds_[L1D_MISSES] = OpenCounter(PERF_TYPE_HW_CACHE, kL1dReadMiss);
+    fds_[LLC_MISSES] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+
+    bool any = false;
+    for (const int fd : fds_) {
+        any = any || (fd >= 0);
+    }
+    return any;
+}
+
+void PerfCounters::Start() {
+    for (const int fd : fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+const PerfCounters::Values& PerfCounters::Stop() {
+    for (const int fd : fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+        values_[i] = 0.0;
+        uint64_t data[3];  // value, time enabled, time running
+        if ((fds_[i] < 0) || (read(fds_[i], data, sizeof(data)) != sizeof(data)) || (data[2] == 0)) {
+            continue;
+        }
+        // Scale up if the counter only ran part of the time because the kernel multiplexed it
+        values_[i] = static_cast<double>(data[0]) * data[1] / data[2];
+    }
+    return values_;
+}
+
+const char* PerfCounters::Name(const Counter counter) {
+    switch (counter) {
+        case CYCLES:
+            return "cycles";
+        case INSTRUCTIONS:
+            return "instr";
+        case BRANCH_MISSES:
+            return "br-miss";
+        case L1D_MISSES:
+            return "L1d-miss";
+        case LLC_MISSES:
+            return "LLC-miss";
+        default:
+            return "";
+    }
+}
+
+}  // namespace fixposition
@@ -0,0 +1,434 @@
+/**
+ *  @file
+ *  @brief Decode many recorded sensor outputs in parallel and compare digests of the decoded data with golden files
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/fixposition_driver.hpp>
+#include <fixposition_driver_lib/helper.hpp>
+
+static constexpr const int kReadSize = 4096;               //!< chunk size fed to the driver, like a read
+static constexpr const char* kDigestHeader = "# fixposition_regression_digest v1";
+
+/**
+ * @brief FNV-1a (64 bit) over a canonical text form of the decoded data
+ *
+ * Floating point values are written with 12 significant digits, so a different rounding in the last bit (e.g. from
+ * another compiler) does not count as a change, anything visible in the output does.
+ */
+class Digest {
+   public:
+    void Add(const char* data, const std::size_t size) {
+        for (std::size_t i = 0; i < size; i++) {
+            hash_ ^= static_cast<uint8_t>(data[i]);
+            hash_ *= kFnvPrime;
+        }
+        hash_ ^= ';';
+        hash_ *= kFnvPrime;
+    }
+    void Add(const std::string& value) { Add(value.data(), value.size()); }
+    void Add(const double value) {
+        char buf[32];
+        const int len = snprintf(buf, sizeof(buf), "%.12g", value == 0.0 ? 0.0 : value);  // no "-0"
+        Add(buf, len);
+    }
+    void Add(const int value) {
+        char buf[16];
+        Add(buf, snprintf(buf, sizeof(buf), "%d", value));
+    }
+    void Add(const fixposition::times::GpsTime& stamp) {
+        Add(stamp.wno);
+        Add(stamp.tow);
+    }
+    template <typename Derived>
+    void Add(const Eigen::MatrixBase<Derived>& matrix) {
+        for (int i = 0; i < matrix.size(); i++) {
+            Add(static_cast<double>(matrix(i)));
+        }
+    }
+    void Add(const Eigen::Quaterniond& q) { Add(q.coeffs()); }
+
+    uint64_t Get() const { return hash_; }
+
+   private:
+    static constexpr const uint64_t kFnvOffset = 0xcbf29ce484222325ULL;
+    static constexpr const uint64_t kFnvPrime = 0x100000001b3ULL;
+    uint64_t hash_ = kFnvOffset;
+};
+
+/**
+ * @brief Number and digest of the decoded messages of one type
+ *
+ */
+struct TypeDigest {
+    uint64_t count = 0;
+    Digest digest;
+};
+
+using CaptureDigest = std::map<std::string, std::pair<uint64_t, uint64_t>>;  //!< type -> (count, digest)
+
+static void AddPose(Digest& d, const fixposition::PoseWithCovData& pose) {
+    d.Add(pose.position);
+    d.Add(pose.orientation);
+    d.Add(pose.cov);
+}
+
+static void AddTwist(Digest& d, const fixposition::TwistWithCovData& twist) {
+    d.Add(twist.linear);
+    d.Add(twist.angular);
+    d.Add(twist.cov);
+}
+
+static void AddOdometry(Digest& d, const fixposition::OdometryData& odometry) {
+    d.Add(odometry.stamp);
+    d.Add(odometry.frame_id);
+    d.Add(odometry.child_frame_id);
+    AddPose(d, odometry.pose);
+    AddTwist(d, odometry.twist);
+}
+
+static void AddTf(Digest& d, const fixposition::TfData& tf) {
+    d.Add(tf.stamp);
+    d.Add(tf.frame_id);
+    d.Add(tf.child_frame_id);
+    d.Add(tf.translation);
+    d.Add(tf.rotation);
+}
+
+static void AddImu(Digest& d, const fixposition::ImuData& imu) {
+    d.Add(imu.stamp);
+    d.Add(imu.frame_id);
+    d.Add(imu.linear_acceleration);
+    d.Add(imu.angular_velocity);
+}
+
+static void AddNavSatFix(Digest& d, const fixposition::NavSatFixData& fix) {
+    d.Add(fix.stamp);
+    d.Add(fix.frame_id);
+    d.Add(static_cast<int>(fix.status.status));
+    d.Add(static_cast<int>(fix.status.service));
+    d.Add(fix.latitude);
+    d.Add(fix.longitude);
+    d.Add(fix.altitude);
+    d.Add(fix.cov);
+    d.Add(fix.position_covariance_type);
+}
+
+/**
+ * @brief Decode one capture with the driver's framing and converters
+ *
+ * @param[in] path
+ * @param[out] result
+ * @param[out] bytes size of the capture
+ * @return true
+ * @return false cannot read the capture
+ */
+static bool DecodeCapture(const std::string& path, CaptureDigest& result, uint64_t& bytes) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    bytes = data.size();
+
+    fixposition::FixpositionDriverParams params;
+    params.fp_output.type = fixposition::INPUT_TYPE::NONE;
+    params.fp_output.formats = {"ODOMETRY", "LLH", "RAWIMU", "CORRIMU", "TF"};
+    fixposition::FixpositionDriver driver(params);
+
+    std::map<std::string, TypeDigest> types;
+    driver.AddOdometryObserver([&types](const fixposition::OdometryConverter::Msgs& msgs) {
+        TypeDigest& type = types["ODOMETRY"];
+        type.count++;
+        AddOdometry(type.digest, msgs.odometry);
+        AddOdometry(type.digest, msgs.odometry_enu0);
+        AddImu(type.digest, msgs.imu);
+        type.digest.Add(msgs.vrtk.stamp);
+        AddPose(type.digest, msgs.vrtk.pose);
+        AddTwist(type.digest, msgs.vrtk.velocity);
+        type.digest.Add(msgs.vrtk.acceleration);
+        type.digest.Add(msgs.vrtk.fusion_status);
+        type.digest.Add(msgs.vrtk.imu_bias_status);
+        type.digest.Add(msgs.vrtk.gnss1_status);
+        type.digest.Add(msgs.vrtk.gnss2_status);
+        type.digest.Add(msgs.vrtk.wheelspeed_status);
+        type.digest.Add(msgs.vrtk.version);
+        type.digest.Add(msgs.eul);
+        AddTf(type.digest, msgs.tf_ecef_poi);
+        AddTf(type.digest, msgs.tf_ecef_enu);
+        AddTf(type.digest, msgs.tf_ecef_enu0);
+        AddNavSatFix(type.digest, msgs.llh);
+    });
+    driver.AddLlhObserver([&types](const fixposition::NavSatFixData& llh) {
+        TypeDigest& type = types["LLH"];
+        type.count++;
+        AddNavSatFix(type.digest, llh);
+    });
+    driver.AddRawImuObserver([&types](const fixposition::ImuData& imu) {
+        TypeDigest& type = types["RAWIMU"];
+        type.count++;
+        AddImu(type.digest, imu);
+    });
+    driver.AddCorrImuObserver([&types](const fixposition::ImuData& imu) {
+        TypeDigest& type = types["CORRIMU"];
+        type.count++;
+        AddImu(type.digest, imu);
+    });
+    driver.AddTfObserver([&types](const fixposition::TfData& tf) {
+        TypeDigest& type = types["TF"];
+        type.count++;
+        AddTf(type.digest, tf);
+    });
+    driver.AddNovFrameObserver(static_cast<uint16_t>(fixposition::MessageId::BESTGNSSPOS),
+                               [&types](const uint8_t* frame, const int, const fixposition::RawFrameInfo&) {
+                                   const auto* header =
+                                       reinterpret_cast<const fixposition::Oem7MessageHeaderMem*>(frame);
+                                   const auto* payload = reinterpret_cast<const fixposition::BESTGNSSPOSMem*>(
+                                       frame + sizeof(fixposition::Oem7MessageHeaderMem));
+                                   fixposition::NavSatFixData fix;
+                                   fixposition::BestGnssPosToNavSatFix(header, payload, fix);
+                                   TypeDigest& type = types["BESTGNSSPOS"];
+                                   type.count++;
+                                   AddNavSatFix(type.digest, fix);
+                               });
+
+    for (std::size_t pos = 0; pos < data.size(); pos += kReadSize) {
+        driver.Process(data.data() + pos, static_cast<int>(std::min<std::size_t>(kReadSize, data.size() - pos)));
+    }
+
+    result.clear();
+    for (const auto& type : types) {
+        result[type.first] = {type.second.count, type.second.digest.Get()};
+    }
+    // Messages the converters reject are part of the result as well
+    for (const auto& errors : driver.GetDecodeErrors()) {
+        result["ERRORS_" + errors.first] = {errors.second, 0};
+    }
+    return true;
+}
+
+/**
+ * @brief Text form of a digest, also the golden file format
+ *
+ * @param[in] digest
+ * @return std::string
+ */
+static std::string FormatDigest(const CaptureDigest& digest) {
+    std::string text = std::string(kDigestHeader) + "\n";
+    for (const auto& type : digest) {
+        char line[128];
+        snprintf(line, sizeof(line), "%s %" PRIu64 " %016" PRIx64 "\n", type.first.c_str(), type.second.first,
+                 type.second.second);
+        text += line;
+    }
+    return text;
+}
+
+/**
+ * @brief Read a golden file
+ *
+ * @param[in] path
+ * @param[out] digest
+ * @return true
+ * @return false missing or not a digest file
+ */
+static bool ReadDigest(const std::string& path, CaptureDigest& digest) {
+    std::ifstream file(path);
+    std::string line;
+    if (!std::getline(file, line) || line != kDigestHeader) {
+        return false;
+    }
+    digest.clear();
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string type, hash;
+        uint64_t count;
+        if (fields >> type >> count >> hash) {
+            digest[type] = {count, strtoull(hash.c_str(), nullptr, 16)};
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Differences between the golden and the new digest, one line per message type
+ *
+ * @param[in] golden
+ * @param[in] digest
+ * @return std::vector<std::string> empty if equal
+ */
+static std::vector<std::string> DiffDigests(const CaptureDigest& golden, const CaptureDigest& digest) {
+    std::vector<std::string> diffs;
+    char line[256];
+    for (const auto& type : golden) {
+        const auto it = digest.find(type.first);
+        if (it == digest.end()) {
+            snprintf(line, sizeof(line), "%s: %" PRIu64 " messages, none now", type.first.c_str(), type.second.first);
+            diffs.push_back(line);
+        } else if (it->second != type.second) {
+            snprintf(line, sizeof(line),
+                     "%s: %" PRIu64 " -> %" PRIu64 " messages, digest %016" PRIx64 " -> %016" PRIx64,
+                     type.first.c_str(), type.second.first, it->second.first, type.second.second, it->second.second);
+            diffs.push_back(line);
+        }
+    }
+    for (const auto& type : digest) {
+        if (golden.find(type.first) == golden.end()) {
+            snprintf(line, sizeof(line), "%s: new, %" PRIu64 " messages", type.first.c_str(), type.second.first);
+            diffs.push_back(line);
+        }
+    }
+    return diffs;
+}
+
+static void PrintUsage(const char* name) {
+    printf("Usage: %s [-j jobs] [-g golden dir [-u]] [-l list file] [recorded sensor output ...]\n", name);
+    printf("  -j  number of captures decoded in parallel (default: number of cores)\n");
+    printf("  -g  compare with <golden dir>/<capture file name>.digest, without it print the digests\n");
+    printf("  -u  write the golden files instead of comparing\n");
+    printf("  -l  file with one capture path per line, in addition to the arguments\n");
+}
+
+int main(int argc, char** argv) {
+    int jobs = std::max(1u, std::thread::hardware_concurrency());
+    std::string golden_dir;
+    bool update = false;
+    std::vector<std::string> captures;
+    int opt;
+    while ((opt = getopt(argc, argv, "j:g:ul:h")) != -1) {
+        switch (opt) {
+            case 'j':
+                jobs = std::max(1, atoi(optarg));
+                break;
+            case 'g':
+                golden_dir = optarg;
+                break;
+            case 'u':
+                update = true;
+                break;
+            case 'l': {
+                std::ifstream list(optarg);
+                if (!list.is_open()) {
+                    printf("Cannot open %s\n", optarg);
+                    return 2;
+                }
+                std::string line;
+                while (std::getline(list, line)) {
+                    if (!line.empty() && line[0] != '#') {
+                        captures.push_back(line);
+                    }
+                }
+                break;
+            }
+            default:
+                PrintUsage(argv[0]);
+                return 2;
+        }
+    }
+    for (int i = optind; i < argc; i++) {
+        captures.push_back(argv[i]);
+    }
+    if (captures.empty() || (update && golden_dir.empty())) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    // The converters report rejected messages on stdout, these are counted in the digest instead
+    std::ofstream null_stream;
+    std::streambuf* cout_buf = std::cout.rdbuf(null_stream.rdbuf());
+
+    // Each worker takes the next capture, each capture is decoded by its own driver instance
+    std::vector<CaptureDigest> digests(captures.size());
+    std::vector<uint64_t> sizes(captures.size(), 0);
+    std::vector<char> read_ok(captures.size(), false);  // not vector<bool>, written by the workers
+    std::atomic<std::size_t> next(0);
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < std::min<int>(jobs, captures.size()); i++) {
+        workers.emplace_back([&]() {
+            for (std::size_t idx = next++; idx < captures.size(); idx = next++) {
+                read_ok[idx] = DecodeCapture(captures[idx], digests[idx], sizes[idx]);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout.rdbuf(cout_buf);
+
+    int failed = 0;
+    uint64_t total_bytes = 0;
+    for (std::size_t i = 0; i < captures.size(); i++) {
+        total_bytes += sizes[i];
+        if (!read_ok[i]) {
+            printf("ERROR    %s: cannot read\n", captures[i].c_str());
+            failed++;
+            continue;
+        }
+        const std::string text = FormatDigest(digests[i]);
+        if (golden_dir.empty()) {
+            printf("%s\n%s", captures[i].c_str(), text.c_str());
+            continue;
+        }
+
+        const std::string name = captures[i].substr(captures[i].find_last_of('/') + 1);
+        const std::string golden_path = golden_dir + "/" + name + ".digest";
+        if (update) {
+            std::ofstream golden_file(golden_path);
+            golden_file << text;
+            if (!golden_file.good()) {
+                printf("ERROR    %s: cannot write %s\n", captures[i].c_str(), golden_path.c_str());
+                failed++;
+            }
+            continue;
+        }
+        CaptureDigest golden;
+        if (!ReadDigest(golden_path, golden)) {
+            printf("MISSING  %s: no golden file %s\n", captures[i].c_str(), golden_path.c_str());
+            failed++;
+            continue;
+        }
+        const std::vector<std::string> diffs = DiffDigests(golden, digests[i]);
+        if (diffs.empty()) {
+            printf("OK       %s\n", captures[i].c_str());
+        } else {
+            printf("CHANGED  %s\n", captures[i].c_str());
+            for (const auto& diff : diffs) {
+                printf("           %s\n", diff.c_str());
+            }
+            failed++;
+        }
+    }
+
+    printf("%zu captures, %.1f MB in %.2f s (%.1f MB/s, %d jobs), %d failed\n", captures.size(), total_bytes * 1e-6,
+           elapsed, total_bytes * 1e-6 / elapsed, std::min<int>(jobs, captures.size()), failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+/**
+ *  @file
+ *  @brief Implementation of Rtcm3Input class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iostream>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/parser.hpp>
+#include <fixposition_driver_lib/rtcm3_input.hpp>
+
+namespace fixposition {
+
+static constexpr const uint8_t kRtcm3Preamble = 0xd3;
+static constexpr const int kRtcm3HeaderSize = 3;
+static constexpr const int kRtcm3CrcSize = 3;
+
+/**
+ * @brief Get an unsigned field of a RTCM3 payload, bits are numbered from the MSB of the first byte
+ *
+ * @param[in] data
+ * @param[in] pos first bit
+ * @param[in] len number of bits, at most 32
+ * @return uint32_t
+ */
+static uint32_t GetBits(const uint8_t* data, const int pos, const int len) {
+    uint32_t bits = 0;
+    for (int i = pos; i < pos + len; i++) {
+        bits = (bits << 1) | ((data[i / 8] >> (7 - i % 8)) & 1u);
+    }
+    return bits;
+}
+
+bool GetRtcm3EpochTow(const uint8_t* frame, const int size, double& tow) {
+    // Message number (12 bits), reference station id (12 bits) and epoch time (30 bits) lead the payload
+    if (size < kRtcm3HeaderSize + 7 + kRtcm3CrcSize) {
+        return false;
+    }
+    const uint8_t* payload = frame + kRtcm3HeaderSize;
+    const uint32_t type = GetBits(payload, 0, 12);
+    const uint32_t ms = GetBits(payload, 24, 30);
+    if (ms >= 604800000) {
+        return false;
+    }
+    if ((type >= 1001 && type <= 1004) ||  // GPS RTK observables
+        (type >= 1071 && type <= 1077) ||  // GPS MSM
+        (type >= 1091 && type <= 1097) ||  // Galileo MSM, GST has the GPS second count
+        (type >= 1101 && type <= 1107) ||  // SBAS MSM
+        (type >= 1111 && type <= 1117) ||  // QZSS MSM
+        (type >= 1131 && type <= 1137)) {  // NavIC MSM
+        tow = ms * 1e-3;
+        return true;
+    } else if (type >= 1121 && type <= 1127) {
+        // BeiDou MSM, BDT is 14 s behind GPS time
+        tow = ms * 1e-3 + 14.0;
+        if (tow >= 604800.0) {
+            tow -= 604800.0;
+        }
+        return true;
+    }
+    return false;
+}
+
+Rtcm3Input::Rtcm3Input(const Rtcm3InputParams& params) : params_(params) {}
+
+Rtcm3Input::~Rtcm3Input() { Close(); }
+
+bool Rtcm3Input::Open() {
+    Close();
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(params_.port);
+    if (params_.port <= 0 || params_.port > 65535 || inet_pton(AF_INET, params_.host.c_str(), &address.sin_addr) != 1) {
+        std::cerr << "Invalid RTCM3 source " << params_.host << ":" << params_.port << "\n";
+        return false;
+    }
+
+    fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd_ < 0) {
+        std::cerr << "Error in RTCM3 socket creation: " << strerror(errno) << "\n";
+        return false;
+    }
+    if (connect(fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Cannot connect to the RTCM3 source " << params_.host << ":" << params_.port << ": "
+                  << strerror(errno) << "\n";
+        Close();
+        return false;
+    }
+    std::cout << "Connected to the RTCM3 source " << params_.host << ":" << params_.port << "\n";
+    return true;
+}
+
+void Rtcm3Input::Close() {
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    buf_.clear();
+}
+
+bool Rtcm3Input::Read() {
+    uint8_t data[4096];
+    while (true) {
+        const ssize_t n = recv(fd_, data, sizeof(data), MSG_DONTWAIT);
+        if (n > 0) {
+            const double arrival =
+                std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            Process(data, n, arrival);
+        } else if (n == 0) {
+            std::cerr << "RTCM3 source closed the connection\n";
+            return false;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return true;
+        } else if (errno != EINTR) {
+            std::cerr << "RTCM3 read error: " << strerror(errno) << "\n";
+            return false;
+        }
+    }
+}
+
+void Rtcm3Input::Process(const uint8_t* data, const int size, const double arrival) {
+    buf_.insert(buf_.end(), data, data + size);
+
+    std::size_t pos = 0;
+    while (pos < buf_.size()) {
+        const uint8_t* start = buf_.data() + pos;
+        const int available = static_cast<int>(buf_.size() - pos);
+        const int len = IsRtcm3Message(start, available);
+        if (len > 0) {
+            for (auto& ob : obs_) {
+                ob(start, len, arrival);
+            }
+            pos += len;
+        } else if (len < 0) {
+            break;  // completed by the next data
+        } else {
+            // A complete frame with valid header but a wrong CRC, or garbage: resynchronize at the next preamble
+            if (start[0] == kRtcm3Preamble && (start[1] & 0xfc) == 0) {
+                crc_errors_++;
+            }
+            const void* next = memchr(start + 1, kRtcm3Preamble, available - 1);
+            pos = next != nullptr ? static_cast<const uint8_t*>(next) - buf_.data() : buf_.size();
+        }
+    }
+    buf_.erase(buf_.begin(), buf_.begin() + pos);
+}
+
+}  // namespace fixposition
@@ -0,0 +1,74 @@
+/**
+ *  @file
+ *  @brief Implementation of SequenceMonitor class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <algorithm>
+#include <cmath>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/sequence_monitor.hpp>
+
+namespace fixposition {
+
+static constexpr const double kDuplicateTolerance = 0.5e-3;  //!< GPS times closer than this are the same epoch [s]
+
+void SequenceMonitor::Update(const times::GpsTime& stamp, const double arrival) {
+    const double gps = stamp.wno * static_cast<double>(times::Constants::sec_per_week) + stamp.tow;
+    stats_.count++;
+    if (stats_.count == 1) {
+        last_gps_ = gps;
+        last_arrival_ = arrival;
+        return;
+    }
+
+    const double step = gps - last_gps_;
+    if (std::abs(step) < kDuplicateTolerance) {
+        stats_.duplicates++;
+        return;
+    }
+    if (step < 0.0) {
+        // Late message, keep the latest time as reference
+        stats_.out_of_order++;
+        return;
+    }
+
+    // Arrival jitter: difference between arrival spacing and GPS time spacing
+    const double deviation = std::abs((arrival - last_arrival_) - step);
+    stats_.jitter += (deviation - stats_.jitter) / 16.0;
+    stats_.max_jitter = std::max(stats_.max_jitter, deviation);
+    last_gps_ = gps;
+    last_arrival_ = arrival;
+
+    // Steps off the nominal one start a (re-)learning run, a run of kLearnSteps such steps means the rate changed
+    const bool nominal = (stats_.nominal_step > 0.0) && (step < 1.5 * stats_.nominal_step) &&
+                         (step > 0.5 * stats_.nominal_step);
+    if (nominal) {
+        learn_count_ = 0;
+    } else {
+        learn_min_ = (learn_count_ == 0) ? step : std::min(learn_min_, step);
+        learn_count_++;
+        if (learn_count_ >= kLearnSteps) {
+            stats_.nominal_step = learn_min_;
+            learn_count_ = 0;
+        }
+    }
+
+    // Gap: more than one nominal step between two epochs
+    if ((stats_.nominal_step > 0.0) && (step >= 1.5 * stats_.nominal_step)) {
+        stats_.gaps++;
+        stats_.missing += static_cast<uint64_t>(std::lround(step / stats_.nominal_step)) - 1;
+    }
+}
+
+}  // namespace fixposition
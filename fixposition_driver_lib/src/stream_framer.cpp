@@ -0,0 +1,253 @@
+/**
+ *  @file
+ *  @brief Implementation of StreamFramer class
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* PACKAGE */
+#include <fixposition_driver_lib/nov_type.hpp>
+#include <fixposition_driver_lib/stream_framer.hpp>
+
+namespace fixposition {
+
+static constexpr const char kNmeaPreamble = '$';
+static constexpr const int kLibParserMaxNmeaSize = 400;
+static constexpr const int kLibParserMaxNovSize = 4096;
+static constexpr const int kNovShortHeaderSize = 12;
+static constexpr const int kNovCrcSize = 4;
+
+/**
+ * @brief Uppercase hex digit of a nibble
+ *
+ * @param[in] nibble value 0..15
+ * @return char
+ */
+static inline char HexDigit(const uint8_t nibble) { return nibble < 10 ? '0' + nibble : 'A' + (nibble - 10); }
+
+StreamFramer::StreamFramer()
+    : state_(State::IDLE),
+      data_(nullptr),
+      data_start_(0),
+      pending_start_(0),
+      frame_start_(0),
+      frame_size_(0),
+      nmea_ck_(0),
+      nov_len_(0),
+      nov_crc_(0),
+      fed_(0),
+      pos_(0) {
+    pending_.reserve(kLibParserMaxNovSize);
+    spanning_.reserve(kLibParserMaxNovSize);
+}
+
+void StreamFramer::Reset() {
+    ResetFrame();
+    pending_.clear();
+    pending_start_ = 0;
+    data_start_ = 0;
+    fed_ = 0;
+    pos_ = 0;
+}
+
+void StreamFramer::Restore(const uint8_t* pending, const int size, const uint64_t offset) {
+    // Feeding the partial frame again rebuilds the parse state, it cannot complete a frame
+    Reset();
+    fed_ = offset - size;
+    Process(pending, size);
+}
+
+void StreamFramer::ResetFrame() {
+    state_ = State::IDLE;
+    frame_size_ = 0;
+    nmea_ck_ = 0;
+    nov_len_ = 0;
+    nov_crc_ = 0;
+}
+
+void StreamFramer::Process(const uint8_t* data, const int size) {
+    data_ = data;
+    data_start_ = fed_;
+    for (int i = 0; i < size; i++) {
+        Feed(data[i]);
+    }
+
+    // Keep only the bytes of the partial frame, the chunk is not valid after this call
+    if (state_ == State::IDLE) {
+        pending_.clear();
+    } else if (frame_start_ >= data_start_) {
+        pending_.assign(data_ + (frame_start_ - data_start_), data_ + size);
+    } else {
+        pending_.erase(pending_.begin(), pending_.begin() + (frame_start_ - pending_start_));
+        pending_.insert(pending_.end(), data_, data_ + size);
+    }
+    pending_start_ = state_ == State::IDLE ? fed_ : frame_start_;
+    data_ = nullptr;
+    data_start_ = fed_;
+}
+
+uint8_t StreamFramer::ByteAt(const uint64_t offset) const {
+    return offset >= data_start_ ? data_[offset - data_start_] : pending_[offset - pending_start_];
+}
+
+void StreamFramer::Feed(const uint8_t byte) {
+    pos_ = fed_++;
+    if (Step(byte) == Result::CONTINUE) {
+        return;
+    }
+
+    // The partial frame is not valid, scan again everything after its first byte. This is the only case where bytes
+    // are looked at more than once. The rescan always ends with the byte just fed.
+    uint64_t next = frame_start_ + 1;
+    ResetFrame();
+    while (next < fed_) {
+        pos_ = next;
+        if (Step(ByteAt(next)) == Result::FAIL) {
+            next = frame_start_ + 1;
+            ResetFrame();
+        } else {
+            next++;
+        }
+    }
+}
+
+StreamFramer::Result StreamFramer::Step(const uint8_t byte) {
+    if (state_ == State::IDLE) {
+        if (byte == kNmeaPreamble) {
+            frame_start_ = pos_;
+            frame_size_ = 1;
+            nmea_ck_ = 0;
+            state_ = State::NMEA_BODY;
+        } else if (byte == SYNC_CHAR_1) {
+            frame_start_ = pos_;
+            frame_size_ = 1;
+            nov_crc_ = nov_crc32_update(0, byte);
+            nov_len_ = 0;
+            state_ = State::NOV_SYNC2;
+        }
+        // else: garbage between frames, skip
+        return Result::CONTINUE;
+    }
+
+    const int idx = frame_size_++;
+
+    switch (state_) {
+        // Nmea (incl. FP_A): $BODY*CK\r\n
+        case State::NMEA_BODY:
+            if (idx > kLibParserMaxNmeaSize) {
+                return Result::FAIL;
+            }
+            if (byte == '*') {
+                state_ = State::NMEA_CK1;
+            } else if ((byte < 0x20) || (byte > 0x7e) ||  // valid range, also catches '\r' and '\n'
+                       (byte == '$') || (byte == '\\') || (byte == '!') || (byte == '~')) {  // reserved
+                return Result::FAIL;
+            } else {
+                nmea_ck_ ^= byte;
+            }
+            break;
+        case State::NMEA_CK1:
+            state_ = State::NMEA_CK2;
+            break;
+        case State::NMEA_CK2:
+            if ((FrameByte(idx - 1) != HexDigit((nmea_ck_ >> 4) & 0x0f)) || (byte != HexDigit(nmea_ck_ & 0x0f))) {
+                EmitError(FrameError::NMEA_CHECKSUM);
+                return Result::FAIL;
+            }
+            state_ = State::NMEA_CR;
+            break;
+        case State::NMEA_CR:
+            if (byte != '\r') {
+                return Result::FAIL;
+            }
+            state_ = State::NMEA_LF;
+            break;
+        case State::NMEA_LF:
+            if (byte != '\n') {
+                return Result::FAIL;
+            }
+            Emit(FrameType::NMEA);
+            break;
+
+        // Nov B, see IsNovMessage() for the header layout
+        case State::NOV_SYNC2:
+            if (byte != SYNC_CHAR_2) {
+                return Result::FAIL;
+            }
+            nov_crc_ = nov_crc32_update(nov_crc_, byte);
+            state_ = State::NOV_SYNC3;
+            break;
+        case State::NOV_SYNC3:
+            if ((byte != SYNC_CHAR_3_LONG) && (byte != SYNC_CHAR_3_SHORT)) {
+                return Result::FAIL;
+            }
+            nov_crc_ = nov_crc32_update(nov_crc_, byte);
+            state_ = State::NOV_DATA;
+            break;
+        case State::NOV_DATA:
+            if ((nov_len_ == 0) || (idx < nov_len_ - kNovCrcSize)) {
+                nov_crc_ = nov_crc32_update(nov_crc_, byte);
+            }
+
+            // Length is known once the message length field is complete
+            if ((FrameByte(2) == SYNC_CHAR_3_SHORT) && (idx == 3)) {
+                nov_len_ = kNovShortHeaderSize + byte + kNovCrcSize;
+            } else if ((FrameByte(2) == SYNC_CHAR_3_LONG) && (idx == 9)) {
+                const uint16_t msgLen = ((uint16_t)byte << 8) | (uint16_t)FrameByte(8);
+                nov_len_ = FrameByte(3) + msgLen + kNovCrcSize;
+                if (nov_len_ < kNovShortHeaderSize + kNovCrcSize) {
+                    return Result::FAIL;
+                }
+            }
+            if (nov_len_ > kLibParserMaxNovSize) {
+                return Result::FAIL;
+            }
+
+            if ((nov_len_ > 0) && (idx == nov_len_ - 1)) {
+                const uint32_t crc = ((uint32_t)byte << 24) | ((uint32_t)FrameByte(idx - 1) << 16) |
+                                     ((uint32_t)FrameByte(idx - 2) << 8) | ((uint32_t)FrameByte(idx - 3));
+                if (crc != nov_crc_) {
+                    EmitError(FrameError::NOV_CRC);
+                    return Result::FAIL;
+                }
+                Emit(FrameType::NOV_B);
+            }
+            break;
+        default:
+            break;
+    }
+    return Result::CONTINUE;
+}
+
+void StreamFramer::Emit(const FrameType type) {
+    // Frames within the chunk or within the kept bytes are passed in place, only a frame spanning both is copied
+    const uint8_t* frame = nullptr;
+    if (frame_start_ >= data_start_) {
+        frame = data_ + (frame_start_ - data_start_);
+    } else if (frame_start_ + frame_size_ <= data_start_) {
+        frame = pending_.data() + (frame_start_ - pending_start_);
+    } else {
+        spanning_.assign(pending_.begin() + (frame_start_ - pending_start_), pending_.end());
+        spanning_.insert(spanning_.end(), data_, data_ + (frame_start_ + frame_size_ - data_start_));
+        frame = spanning_.data();
+    }
+    for (auto& ob : obs_) {
+        ob(type, frame, frame_size_, frame_start_);
+    }
+    ResetFrame();
+}
+
+void StreamFramer::EmitError(const FrameError error) {
+    for (auto& ob : error_obs_) {
+        ob(error, frame_start_, frame_size_);
+    }
+}
+
+}  // namespace fixposition
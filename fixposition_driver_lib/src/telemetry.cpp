@@ -0,0 +1,143 @@
+/**
+ *  @file
+ *  @brief Implementation of TelemetryEncoder and TelemetryDecoder classes
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <cmath>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/telemetry.hpp>
+
+namespace fixposition {
+
+static constexpr const int64_t kMsPerWeek = 604800000;
+
+/**
+ * @brief Append v as zigzag varint: small magnitudes of either sign take few bytes
+ *
+ * @param[in] v
+ * @param[out] out
+ */
+static void PutZigzagVarint(const int64_t v, std::vector<uint8_t>& out) {
+    uint64_t u = (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+    while (u >= 0x80) {
+        out.push_back(static_cast<uint8_t>(u) | 0x80);
+        u >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(u));
+}
+
+/**
+ * @brief Read a zigzag varint
+ *
+ * @param[in,out] p read position, advanced past the varint
+ * @param[in] end end of the buffer
+ * @param[out] v
+ * @return true
+ * @return false truncated or too long
+ */
+static bool GetZigzagVarint(const uint8_t*& p, const uint8_t* end, int64_t& v) {
+    uint64_t u = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (p >= end) {
+            return false;
+        }
+        const uint8_t b = *p++;
+        u |= static_cast<uint64_t>(b & 0x7f) << shift;
+        if ((b & 0x80) == 0) {
+            v = static_cast<int64_t>(u >> 1) ^ -static_cast<int64_t>(u & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Quantize the sample, see TelemetryEncoder for the units
+ *
+ * @param[in] odometry
+ * @return std::array<int64_t, kTelemetryNumValues>
+ */
+static std::array<int64_t, kTelemetryNumValues> Quantize(const OdometryData& odometry) {
+    // q and -q are the same rotation, keep w >= 0 so that the deltas stay small
+    Eigen::Quaterniond q = odometry.pose.orientation.normalized();
+    if (q.w() < 0.0) {
+        q.coeffs() = -q.coeffs();
+    }
+    return {{odometry.stamp.wno * kMsPerWeek + std::llround(odometry.stamp.tow * 1e3),
+             std::llround(odometry.pose.position.x() * 1e3), std::llround(odometry.pose.position.y() * 1e3),
+             std::llround(odometry.pose.position.z() * 1e3), std::llround(q.w() * kTelemetryQuatScale),
+             std::llround(q.x() * kTelemetryQuatScale), std::llround(q.y() * kTelemetryQuatScale),
+             std::llround(q.z() * kTelemetryQuatScale), std::llround(odometry.twist.linear.x() * 1e3),
+             std::llround(odometry.twist.linear.y() * 1e3), std::llround(odometry.twist.linear.z() * 1e3)}};
+}
+
+TelemetryEncoder::TelemetryEncoder(const TelemetryParams& params) : params_(params), since_keyframe_(-1), seq_(0) {
+    prev_.fill(0);
+}
+
+void TelemetryEncoder::Encode(const OdometryData& odometry, std::vector<uint8_t>& packet) {
+    const auto values = Quantize(odometry);
+    const bool keyframe = (since_keyframe_ < 0) || (since_keyframe_ + 1 >= params_.keyframe_interval);
+
+    packet.clear();
+    packet.push_back(keyframe ? kTelemetryKeyframeFlag : 0);
+    packet.push_back(seq_++);
+    for (int i = 0; i < kTelemetryNumValues; i++) {
+        PutZigzagVarint(keyframe ? values[i] : values[i] - prev_[i], packet);
+    }
+
+    prev_ = values;
+    since_keyframe_ = keyframe ? 0 : since_keyframe_ + 1;
+}
+
+bool TelemetryDecoder::Decode(const uint8_t* packet, const int size, OdometryData& odometry) {
+    if (size < 2) {
+        return false;
+    }
+    const bool keyframe = (packet[0] & kTelemetryKeyframeFlag) != 0;
+    const uint8_t seq = packet[1];
+    if (!keyframe && (!synced_ || seq != static_cast<uint8_t>(seq_ + 1))) {
+        synced_ = false;
+        return false;
+    }
+
+    std::array<int64_t, kTelemetryNumValues> values;
+    const uint8_t* p = packet + 2;
+    const uint8_t* end = packet + size;
+    for (int i = 0; i < kTelemetryNumValues; i++) {
+        int64_t v;
+        if (!GetZigzagVarint(p, end, v)) {
+            synced_ = false;
+            return false;
+        }
+        values[i] = keyframe ? v : prev_[i] + v;
+    }
+    prev_ = values;
+    seq_ = seq;
+    synced_ = true;
+
+    odometry.stamp = times::GpsTime(static_cast<int>(values[0] / kMsPerWeek), (values[0] % kMsPerWeek) * 1e-3);
+    odometry.pose.position = Eigen::Vector3d(values[1], values[2], values[3]) * 1e-3;
+    odometry.pose.orientation =
+        Eigen::Quaterniond(values[4] / kTelemetryQuatScale, values[5] / kTelemetryQuatScale,
+                           values[6] / kTelemetryQuatScale, values[7] / kTelemetryQuatScale)
+            .normalized();
+    odometry.pose.cov.setZero();
+    odometry.twist.linear = Eigen::Vector3d(values[8], values[9], values[10]) * 1e-3;
+    odometry.twist.angular.setZero();
+    odometry.twist.cov.setZero();
+    return true;
+}
+
+}  // namespace fixposition
@@ -35,7 +35,7 @@ static constexpr const int orientation_x_idx = 11;
 static constexpr const int orientation_y_idx = 12;
 static constexpr const int orientation_z_idx = 13;
 
-void TfConverter::ConvertTokens(const std::vector<std::string>& tokens) {
+bool TfConverter::ConvertTokens(const std::vector<std::string>& tokens) {
     bool ok = tokens.size() == kSize_;
     if (!ok) {
         // Size is wrong
@@ -43,9 +43,9 @@ void TfConverter::ConvertTokens(const std::vector<std::string>& tokens) {
 
     } else {
         // If size is ok, check version
-        const int version = std::stoi(tokens.at(msg_version_idx));
+        const int version = StringToInt(tokens[msg_version_idx], ok);
 
-        ok = version == kVersion_;
+        ok = ok && version == kVersion_;
         if (!ok) {
             // Version is wrong
             std::cout << "Error in parsing TF string with verion " << version << " ! TF will be empty.\n";
@@ -55,23 +55,30 @@ void TfConverter::ConvertTokens(const std::vector<std::string>& tokens) {
     if (!ok) {
         // Reset message and return
         msg_ = TfData();
-        return;
+        return false;
     }
 
     // header stamps
-    msg_.stamp = ConvertGpsTime(tokens.at(gps_week_idx), tokens.at(gps_tow_idx));
-    msg_.frame_id = "FP_" + tokens.at(from_frame_idx);
-    msg_.child_frame_id = "FP_" + tokens.at(to_frame_idx);
+    msg_.stamp = ConvertGpsTime(tokens[gps_week_idx], tokens[gps_tow_idx], ok);
+    msg_.frame_id = "FP_" + tokens[from_frame_idx];
+    msg_.child_frame_id = "FP_" + tokens[to_frame_idx];
 
     msg_.translation =
-        Vector3ToEigen(tokens.at(translation_x_idx), tokens.at(translation_y_idx), tokens.at(translation_z_idx));
-    msg_.rotation = Vector4ToEigen(tokens.at(orientation_w_idx), tokens.at(orientation_x_idx),
-                                   tokens.at(orientation_y_idx), tokens.at(orientation_z_idx));
+        Vector3ToEigen(tokens[translation_x_idx], tokens[translation_y_idx], tokens[translation_z_idx], ok);
+    msg_.rotation = Vector4ToEigen(tokens[orientation_w_idx], tokens[orientation_x_idx], tokens[orientation_y_idx],
+                                   tokens[orientation_z_idx], ok);
+
+    if (!ok) {
+        // Malformed number
+        msg_ = TfData();
+        return false;
+    }
 
     // process all observers
     for (auto& ob : obs_) {
         ob(msg_);
     }
+    return true;
 }
 
 }  // namespace fixposition
@@ -0,0 +1,557 @@
+/**
+ *  @file
+ *  @brief Spatial index of the positions in recorded sensor outputs, to find every pass through a given area
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* EXTERNAL */
+#include <fixposition_gnss_tf/gnss_tf.hpp>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/fixposition_driver.hpp>
+
+static constexpr const char kIndexMagic[8] = {'F', 'P', 'T', 'R', 'J', 'I', 'D', 'X'};
+static constexpr const uint32_t kIndexVersion = 1;
+static constexpr const int kReadSize = 4096;              //!< chunk size fed to the driver, like a read
+static constexpr const double kSecondsPerWeek = 604800.0;
+static constexpr const double kMetersPerDegree = 111320.0;  //!< of latitude, roughly
+static constexpr const double kEarthRadius = 6371000.0;     //!< mean radius for the distance of radius queries [m]
+static constexpr const int kTagHeaderSize = 64;             //!< "TIMETAG RTKLIB ..." and the tick frequency
+static constexpr const int kTagRecordSize = 12;             //!< tick in [ms] (uint32) and file position (uint64)
+
+/**
+ * @brief Index file header, followed by the capture paths (NUL terminated, padded to 8 bytes), the cells and the
+ *        points
+ *
+ * The world is split into square tiles of cell_size degrees. The points are sorted by tile, a tile's points are
+ * contiguous, and the cells table lists the occupied tiles in key order with the index of their first point.
+ */
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_captures;
+    double cell_size;    //!< [deg]
+    uint64_t num_cells;
+    uint64_t num_points;
+    uint64_t paths_size;  //!< [bytes] incl. padding
+};
+
+struct IndexCell {
+    uint64_t key;    //!< row (latitude) << 32 | column (longitude)
+    uint64_t first;  //!< index of the first point, the cell ends where the next begins
+};
+
+struct IndexPoint {
+    double lat;        //!< [deg]
+    double lon;        //!< [deg]
+    double gps;        //!< GPS time in [s] since the GPS epoch
+    uint64_t offset;   //!< capture offset of the message
+    uint32_t size;     //!< [bytes] of the message
+    uint32_t capture;  //!< index into the capture paths
+};
+
+static uint64_t CellKey(const double lat, const double lon, const double cell_size) {
+    const uint64_t row = static_cast<uint64_t>(std::floor((lat + 90.0) / cell_size));
+    const uint64_t col = static_cast<uint64_t>(std::floor((lon + 180.0) / cell_size));
+    return (row << 32) | col;
+}
+
+/**
+ * @brief Decode the positions of one capture with the driver's framing and converters
+ *
+ * @param[in] path
+ * @param[in] source ODOMETRY or LLH
+ * @param[in] interval minimum GPS time between indexed positions [s]
+ * @param[in] capture index of the capture
+ * @param[out] points
+ * @return true
+ * @return false cannot read the capture
+ */
+static bool DecodeCapture(const std::string& path, const std::string& source, const double interval,
+                          const uint32_t capture, std::vector<IndexPoint>& points) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    fixposition::FixpositionDriverParams params;
+    params.fp_output.type = fixposition::INPUT_TYPE::NONE;
+    params.fp_output.formats = {source};
+    fixposition::FixpositionDriver driver(params);
+
+    // The frame observer runs before the conversion and tells where the message is
+    IndexPoint point;
+    point.capture = capture;
+    double last_gps = -1e12;
+    driver.AddFpaFrameObserver(source,
+                               [&point](const uint8_t*, const int size, const fixposition::RawFrameInfo& info) {
+                                   point.offset = info.offset;
+                                   point.size = size;
+                               });
+    const auto add_point = [&](const fixposition::times::GpsTime& stamp, const double lat, const double lon) {
+        point.gps = stamp.wno * kSecondsPerWeek + stamp.tow;
+        if (std::abs(point.gps - last_gps) < interval) {
+            return;
+        }
+        last_gps = point.gps;
+        point.lat = lat;
+        point.lon = lon;
+        points.push_back(point);
+    };
+    if (source == "ODOMETRY") {
+        driver.AddOdometryObserver([&add_point](const fixposition::OdometryConverter::Msgs& msgs) {
+            const Eigen::Vector3d& ecef = msgs.odometry.pose.position;
+            if (ecef.norm() < 1e6) {  // all zero until the fusion is initialized
+                return;
+            }
+            const Eigen::Vector3d llh = fixposition::gnss_tf::TfWgs84LlhEcef(ecef);
+            add_point(msgs.odometry.stamp, llh(0) * 180.0 / M_PI, llh(1) * 180.0 / M_PI);
+        });
+    } else {
+        driver.AddLlhObserver([&add_point](const fixposition::NavSatFixData& llh) {
+            if (llh.latitude == 0.0 && llh.longitude == 0.0) {  // no fix
+                return;
+            }
+            add_point(llh.stamp, llh.latitude, llh.longitude);
+        });
+    }
+
+    for (std::size_t pos = 0; pos < data.size(); pos += kReadSize) {
+        driver.Process(data.data() + pos, static_cast<int>(std::min<std::size_t>(kReadSize, data.size() - pos)));
+    }
+    return true;
+}
+
+static int Build(const std::string& index_path, const std::vector<std::string>& captures, const std::string& source,
+                 const double interval, const double cell_size, const int jobs) {
+    // The converters report rejected messages on stdout
+    std::ofstream null_stream;
+    std::streambuf* cout_buf = std::cout.rdbuf(null_stream.rdbuf());
+
+    std::vector<std::vector<IndexPoint>> capture_points(captures.size());
+    std::vector<char> read_ok(captures.size(), false);  // not vector<bool>, written by the workers
+    std::atomic<std::size_t> next(0);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < std::min<int>(jobs, captures.size()); i++) {
+        workers.emplace_back([&]() {
+            for (std::size_t idx = next++; idx < captures.size(); idx = next++) {
+                read_ok[idx] = DecodeCapture(captures[idx], source, interval, idx, capture_points[idx]);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::cout.rdbuf(cout_buf);
+
+    std::vector<IndexPoint> points;
+    for (std::size_t i = 0; i < captures.size(); i++) {
+        if (!read_ok[i]) {
+            printf("Cannot read %s\n", captures[i].c_str());
+            return 1;
+        }
+        printf("%-60s %8zu positions\n", captures[i].c_str(), capture_points[i].size());
+        points.insert(points.end(), capture_points[i].begin(), capture_points[i].end());
+        std::vector<IndexPoint>().swap(capture_points[i]);
+    }
+
+    // Sort by tile, within a tile by capture and offset, so a query finds a pass in order
+    std::sort(points.begin(), points.end(), [cell_size](const IndexPoint& a, const IndexPoint& b) {
+        const uint64_t key_a = CellKey(a.lat, a.lon, cell_size);
+        const uint64_t key_b = CellKey(b.lat, b.lon, cell_size);
+        if (key_a != key_b) {
+            return key_a < key_b;
+        }
+        return a.capture != b.capture ? a.capture < b.capture : a.offset < b.offset;
+    });
+    std::vector<IndexCell> cells;
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const uint64_t key = CellKey(points[i].lat, points[i].lon, cell_size);
+        if (cells.empty() || cells.back().key != key) {
+            cells.push_back({key, i});
+        }
+    }
+
+    std::string paths;
+    for (const auto& capture : captures) {
+        paths.append(capture.c_str(), capture.size() + 1);
+    }
+    paths.resize((paths.size() + 7) / 8 * 8, '\0');
+
+    IndexHeader header;
+    memcpy(header.magic, kIndexMagic, sizeof(header.magic));
+    header.version = kIndexVersion;
+    header.num_captures = captures.size();
+    header.cell_size = cell_size;
+    header.num_cells = cells.size();
+    header.num_points = points.size();
+    header.paths_size = paths.size();
+
+    FILE* file = fopen(index_path.c_str(), "wb");
+    if (file == nullptr) {
+        printf("Cannot write %s\n", index_path.c_str());
+        return 1;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && fwrite(paths.data(), 1, paths.size(), file) == paths.size();
+    ok = ok && fwrite(cells.data(), sizeof(IndexCell), cells.size(), file) == cells.size();
+    ok = ok && fwrite(points.data(), sizeof(IndexPoint), points.size(), file) == points.size();
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) {
+        printf("Cannot write %s\n", index_path.c_str());
+        return 1;
+    }
+    printf("%zu captures, %zu positions in %zu tiles of %.4f deg -> %s\n", captures.size(), points.size(),
+           cells.size(), cell_size, index_path.c_str());
+    return 0;
+}
+
+/**
+ * @brief A pass through the queried area: consecutive matching positions of one capture
+ *
+ */
+struct Segment {
+    uint32_t capture;
+    double gps_begin;
+    double gps_end;
+    uint64_t begin;  //!< first byte of the first matching message
+    uint64_t end;    //!< one past the last byte of the last matching message
+    uint64_t count;  //!< matching positions
+};
+
+/**
+ * @brief Write a segment of a capture to a new file, with a matching .tag file if the capture has one, so that it
+ *        can be replayed with str2str -in file://<segment>::T
+ *
+ * @param[in] capture
+ * @param[in] segment
+ * @param[in] out_path
+ * @return true
+ * @return false
+ */
+static bool ExtractSegment(const std::string& capture, const Segment& segment, const std::string& out_path) {
+    std::ifstream in(capture, std::ios::binary);
+    std::ofstream out(out_path, std::ios::binary);
+    if (!in.is_open() || !out.is_open()) {
+        return false;
+    }
+    std::vector<char> buf(segment.end - segment.begin);
+    in.seekg(segment.begin);
+    in.read(buf.data(), buf.size());
+    out.write(buf.data(), in.gcount());
+    if (!in || !out) {
+        return false;
+    }
+
+    // Keep the chunks from the one that contains the segment start, re-based to the segment
+    FILE* tag_in = fopen((capture + ".tag").c_str(), "rb");
+    if (tag_in == nullptr) {
+        return true;
+    }
+    uint8_t header[kTagHeaderSize];
+    int64_t sec = 0;
+    double frac = 0.0;
+    bool ok = (fread(header, 1, sizeof(header), tag_in) == sizeof(header)) && (memcmp(header, "TIMETAG", 7) == 0) &&
+              (fread(&sec, sizeof(sec), 1, tag_in) == 1) && (fread(&frac, sizeof(frac), 1, tag_in) == 1);
+    std::vector<std::pair<uint32_t, uint64_t>> records;
+    uint8_t rec[kTagRecordSize];
+    while (ok && fread(rec, 1, sizeof(rec), tag_in) == sizeof(rec)) {
+        uint32_t tick;
+        uint64_t pos;
+        memcpy(&tick, rec, sizeof(tick));
+        memcpy(&pos, rec + sizeof(tick), sizeof(pos));
+        if (pos >= segment.end) {
+            break;
+        }
+        if (pos <= segment.begin) {
+            records.clear();  // only the last chunk starting before the segment is needed
+            pos = segment.begin;
+        }
+        records.emplace_back(tick, pos - segment.begin);
+    }
+    fclose(tag_in);
+    if (!ok || records.empty()) {
+        return true;
+    }
+
+    FILE* tag_out = fopen((out_path + ".tag").c_str(), "wb");
+    if (tag_out == nullptr) {
+        return false;
+    }
+    const uint32_t tick0 = records.front().first;
+    const double start = frac + tick0 * 1e-3;
+    sec += static_cast<int64_t>(std::floor(start));
+    frac = start - std::floor(start);
+    ok = (fwrite(header, 1, sizeof(header), tag_out) == sizeof(header)) &&
+         (fwrite(&sec, sizeof(sec), 1, tag_out) == 1) && (fwrite(&frac, sizeof(frac), 1, tag_out) == 1);
+    for (const auto& record : records) {
+        const uint32_t tick = record.first - tick0;
+        memcpy(rec, &tick, sizeof(tick));
+        memcpy(rec + sizeof(tick), &record.second, sizeof(record.second));
+        ok = ok && fwrite(rec, 1, sizeof(rec), tag_out) == sizeof(rec);
+    }
+    return (fclose(tag_out) == 0) && ok;
+}
+
+static void PrintGpsTime(const double gps) {
+    const int wno = static_cast<int>(gps / kSecondsPerWeek);
+    printf("%4d:%10.3f", wno, gps - wno * kSecondsPerWeek);
+}
+
+static int Query(const std::string& index_path, const double lat_min, const double lon_min, const double lat_max,
+                 const double lon_max, const double radius, const double max_gap, const std::string& extract_dir) {
+    const int fd = open(index_path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(IndexHeader)) {
+        printf("Cannot read %s\n", index_path.c_str());
+        if (fd >= 0) {
+            close(fd);
+        }
+        return 1;
+    }
+    void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        printf("Cannot map %s\n", index_path.c_str());
+        return 1;
+    }
+    const uint8_t* data = static_cast<const uint8_t*>(addr);
+    const IndexHeader& header = *reinterpret_cast<const IndexHeader*>(data);
+    const std::size_t size = sizeof(IndexHeader) + header.paths_size + header.num_cells * sizeof(IndexCell) +
+                             header.num_points * sizeof(IndexPoint);
+    if (memcmp(header.magic, kIndexMagic, sizeof(kIndexMagic)) != 0 || header.version != kIndexVersion ||
+        static_cast<std::size_t>(st.st_size) != size) {
+        printf("%s is not a trajectory index\n", index_path.c_str());
+        munmap(addr, st.st_size);
+        return 1;
+    }
+    std::vector<std::string> captures;
+    const char* path = reinterpret_cast<const char*>(data + sizeof(IndexHeader));
+    for (uint32_t i = 0; i < header.num_captures; i++) {
+        captures.emplace_back(path);
+        path += captures.back().size() + 1;
+    }
+    const IndexCell* cells = reinterpret_cast<const IndexCell*>(data + sizeof(IndexHeader) + header.paths_size);
+    const IndexPoint* points = reinterpret_cast<const IndexPoint*>(cells + header.num_cells);
+
+    // Radius query: (lat_min, lon_min) is the center, search the enclosing box and check the distance
+    double box[4] = {lat_min, lon_min, lat_max, lon_max};
+    if (radius > 0.0) {
+        const double dlat = radius / kMetersPerDegree;
+        const double dlon = dlat / std::max(std::cos(lat_min * M_PI / 180.0), 1e-6);
+        box[0] = lat_min - dlat;
+        box[1] = lon_min - dlon;
+        box[2] = lat_min + dlat;
+        box[3] = lon_min + dlon;
+    }
+    const auto inside = [&](const IndexPoint& p) {
+        if (p.lat < box[0] || p.lat > box[2] || p.lon < box[1] || p.lon > box[3]) {
+            return false;
+        }
+        if (radius <= 0.0) {
+            return true;
+        }
+        const double lat1 = lat_min * M_PI / 180.0;
+        const double lat2 = p.lat * M_PI / 180.0;
+        const double s_dlat = std::sin((lat2 - lat1) / 2.0);
+        const double s_dlon = std::sin((p.lon - lon_min) * M_PI / 180.0 / 2.0);
+        const double a = s_dlat * s_dlat + std::cos(lat1) * std::cos(lat2) * s_dlon * s_dlon;
+        return 2.0 * kEarthRadius * std::asin(std::sqrt(std::min(a, 1.0))) <= radius;
+    };
+
+    // Only the tiles overlapping the box are looked at, one binary search per row of tiles
+    std::vector<IndexPoint> matches;
+    const uint64_t first_key = CellKey(box[0], box[1], header.cell_size);
+    const uint64_t last_key = CellKey(box[2], box[3], header.cell_size);
+    const uint64_t col_min = first_key & 0xffffffff;
+    const uint64_t col_max = last_key & 0xffffffff;
+    const IndexCell* cells_end = cells + header.num_cells;
+    for (uint64_t row = first_key >> 32; row <= (last_key >> 32); row++) {
+        const IndexCell* cell = std::lower_bound(
+            cells, cells_end, (row << 32) | col_min,
+            [](const IndexCell& c, const uint64_t key) { return c.key < key; });
+        for (; cell != cells_end && cell->key <= ((row << 32) | col_max); cell++) {
+            const uint64_t end = (cell + 1 != cells_end) ? (cell + 1)->first : header.num_points;
+            for (uint64_t i = cell->first; i < end; i++) {
+                if (inside(points[i])) {
+                    matches.push_back(points[i]);
+                }
+            }
+        }
+    }
+
+    // Group into passes: same capture, no larger GPS time gap than max_gap
+    std::sort(matches.begin(), matches.end(), [](const IndexPoint& a, const IndexPoint& b) {
+        return a.capture != b.capture ? a.capture < b.capture : a.offset < b.offset;
+    });
+    std::vector<Segment> segments;
+    for (const auto& p : matches) {
+        if (segments.empty() || segments.back().capture != p.capture || p.gps - segments.back().gps_end > max_gap ||
+            p.gps < segments.back().gps_end) {
+            segments.push_back({p.capture, p.gps, p.gps, p.offset, p.offset + p.size, 0});
+        }
+        Segment& segment = segments.back();
+        segment.gps_end = p.gps;
+        segment.end = p.offset + p.size;
+        segment.count++;
+    }
+    munmap(addr, st.st_size);
+
+    printf("%zu passes, %zu positions\n", segments.size(), matches.size());
+    int failed = 0;
+    for (std::size_t i = 0; i < segments.size(); i++) {
+        const Segment& segment = segments[i];
+        printf("%s  GPS ", captures[segment.capture].c_str());
+        PrintGpsTime(segment.gps_begin);
+        printf(" - ");
+        PrintGpsTime(segment.gps_end);
+        printf("  %6.1f s  bytes %" PRIu64 "-%" PRIu64 "  %" PRIu64 " positions\n", segment.gps_end - segment.gps_begin,
+               segment.begin, segment.end, segment.count);
+        if (!extract_dir.empty()) {
+            const std::string& capture = captures[segment.capture];
+            const std::string name = capture.substr(capture.find_last_of('/') + 1);
+            const std::string out_path = extract_dir + "/" + name + "." + std::to_string(i) + ".txt";
+            if (ExtractSegment(capture, segment, out_path)) {
+                printf("  -> %s\n", out_path.c_str());
+            } else {
+                printf("  cannot extract to %s\n", out_path.c_str());
+                failed++;
+            }
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+static void PrintUsage(const char* name) {
+    printf("Usage: %s build [-s ODOMETRY|LLH] [-i interval] [-c cell size] [-j jobs] [-l list file] <index> "
+           "[recorded sensor output ...]\n",
+           name);
+    printf("       %s query [-b lat_min,lon_min,lat_max,lon_max] [-r lat,lon,radius] [-g gap] [-x dir] <index>\n",
+           name);
+    printf("  -s  positions to index (default ODOMETRY)\n");
+    printf("  -i  minimum time between indexed positions [s] (default 0.2)\n");
+    printf("  -c  tile size [deg] (default 0.001)\n");
+    printf("  -j  number of recordings decoded in parallel (default: number of cores)\n");
+    printf("  -l  file with one recording path per line, in addition to the arguments\n");
+    printf("  -b  bounding box [deg]\n");
+    printf("  -r  circle, center [deg] and radius [m]\n");
+    printf("  -g  gap [s] that separates two passes (default 5)\n");
+    printf("  -x  write each pass to <dir> (with a .tag file for str2str if the recording has one)\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || (strcmp(argv[1], "build") != 0 && strcmp(argv[1], "query") != 0)) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+    const bool build = strcmp(argv[1], "build") == 0;
+    std::string source = "ODOMETRY";
+    double interval = 0.2;
+    double cell_size = 0.001;
+    int jobs = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> captures;
+    double area[4] = {0.0, 0.0, 0.0, 0.0};
+    bool have_area = false;
+    double radius = 0.0;
+    double max_gap = 5.0;
+    std::string extract_dir;
+    int opt;
+    optind = 2;
+    while ((opt = getopt(argc, argv, "s:i:c:j:l:b:r:g:x:h")) != -1) {
+        switch (opt) {
+            case 's':
+                source = optarg;
+                break;
+            case 'i':
+                interval = atof(optarg);
+                break;
+            case 'c':
+                cell_size = atof(optarg);
+                break;
+            case 'j':
+                jobs = std::max(1, atoi(optarg));
+                break;
+            case 'l': {
+                std::ifstream list(optarg);
+                if (!list.is_open()) {
+                    printf("Cannot open %s\n", optarg);
+                    return 2;
+                }
+                std::string line;
+                while (std::getline(list, line)) {
+                    if (!line.empty() && line[0] != '#') {
+                        captures.push_back(line);
+                    }
+                }
+                break;
+            }
+            case 'b':
+                have_area = sscanf(optarg, "%lf,%lf,%lf,%lf", &area[0], &area[1], &area[2], &area[3]) == 4 &&
+                            area[0] <= area[2] && area[1] <= area[3];
+                radius = 0.0;
+                break;
+            case 'r':
+                have_area = sscanf(optarg, "%lf,%lf,%lf", &area[0], &area[1], &radius) == 3 && radius > 0.0;
+                break;
+            case 'g':
+                max_gap = atof(optarg);
+                break;
+            case 'x':
+                extract_dir = optarg;
+                break;
+            default:
+                PrintUsage(argv[0]);
+                return 2;
+        }
+    }
+    if (optind >= argc) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+    const std::string index_path = argv[optind];
+    for (int i = optind + 1; i < argc; i++) {
+        captures.push_back(argv[i]);
+    }
+
+    if (build) {
+        if (captures.empty() || (source != "ODOMETRY" && source != "LLH") || cell_size <= 0.0) {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+        return Build(index_path, captures, source, interval, cell_size, jobs);
+    }
+    if (!have_area) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+    return Query(index_path, area[0], area[1], area[2], area[3], radius, max_gap, extract_dir);
+}
@@ -32,10 +32,12 @@
 #include <sensor_msgs/msg/nav_sat_fix.hpp>
 
 /* FIXPOSITION */
+#include <fixposition_driver_lib/gps_clock.hpp>
 #include <fixposition_driver_lib/msg_data.hpp>
 #include <fixposition_driver_lib/time_conversions.hpp>
 
 /* PACKAGE */
+#include <fixposition_driver_ros2/msg/gps_clock.hpp>
 #include <fixposition_driver_ros2/msg/vrtk.hpp>
 
 namespace fixposition {
@@ -125,6 +127,14 @@ void VrtkDataToMsg(const VrtkData& data, fixposition_driver_ros2::msg::VRTK& msg
  */
 void TfDataToMsg(const TfData& data, geometry_msgs::msg::TransformStamped& msg);
 
+/**
+ * @brief
+ *
+ * @param[in] data
+ * @param[out] msg all but the header, which is left to the caller
+ */
+void ClockEstimateToMsg(const ClockEstimate& data, fixposition_driver_ros2::msg::GpsClock& msg);
+
 }  // namespace fixposition
 
 #endif
@@ -0,0 +1,80 @@
+/**
+ *  @file
+ *  @brief Declaration of FixpositionDriverLifecycleNode
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+#ifndef __FIXPOSITION_DRIVER_ROS2_FIXPOSITION_DRIVER_LIFECYCLE_NODE_
+#define __FIXPOSITION_DRIVER_ROS2_FIXPOSITION_DRIVER_LIFECYCLE_NODE_
+
+/* SYSTEM / STL */
+#include <chrono>
+#include <memory>
+
+/* ROS2 */
+#include <rclcpp/rclcpp.hpp>
+#include <rclcpp_lifecycle/lifecycle_node.hpp>
+
+/* FIXPOSITION */
+#include <fixposition_driver_lib/params.hpp>
+
+/* PACKAGE */
+#include <fixposition_driver_ros2/fixposition_driver_node.hpp>
+
+namespace fixposition {
+
+/**
+ * @brief Driver node managed by a lifecycle manager
+ *
+ * - configure: load the parameters, connect to the sensor and create the publishers
+ * - activate: discard the data that arrived while inactive, then read, convert and publish
+ * - deactivate: stop reading, the connection stays open so activating again takes milliseconds. Nothing runs while
+ *   inactive, the kernel holds the data until it is discarded on activation.
+ * - cleanup, shutdown: disconnect
+ *
+ * Parameters are read on the first configuration only.
+ */
+class FixpositionDriverLifecycleNode : public rclcpp_lifecycle::LifecycleNode {
+   public:
+    using CallbackReturn = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn;
+
+    /**
+     * @brief Construct a new Fixposition Driver Lifecycle Node object, unconfigured
+     *
+     * @param[in] options
+     */
+    explicit FixpositionDriverLifecycleNode(const rclcpp::NodeOptions& options = rclcpp::NodeOptions());
+
+    CallbackReturn on_configure(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_activate(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_deactivate(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_cleanup(const rclcpp_lifecycle::State& state) override;
+    CallbackReturn on_shutdown(const rclcpp_lifecycle::State& state) override;
+
+   private:
+    /**
+     * @brief Read timer callback: read, convert and publish once, reconnect after fp_output.reconnect_delay if the
+     * connection is lost
+     *
+     */
+    void Read();
+
+    FixpositionDriverParams params_;
+    bool params_loaded_ = false;  //!< parameters are declared and loaded
+    std::unique_ptr<FixpositionDriverNode<rclcpp_lifecycle::LifecycleNode>> driver_;
+    rclcpp::TimerBase::SharedPtr read_timer_;                //!< drives RunOnce() at fp_output.rate while active
+    bool reconnect_ = false;                                 //!< the connection was lost
+    std::chrono::steady_clock::time_point reconnect_time_;  //!< time to connect again
+};
+
+}  // namespace fixposition
+
+#endif
@@ -23,6 +23,8 @@
 /* ROS2 */
 #include <nav_msgs/msg/odometry.hpp>
 #include <rcl/rcl.h>
+#include <rclcpp_lifecycle/lifecycle_node.hpp>
+#include <rclcpp_lifecycle/lifecycle_publisher.hpp>
 #include <sensor_msgs/msg/imu.hpp>
 #include <sensor_msgs/msg/nav_sat_fix.hpp>
 #include <tf2_ros/static_transform_broadcaster.h>
@@ -33,10 +35,13 @@
 
 /* FIXPOSITION */
 #include <fixposition_driver_lib/fixposition_driver.hpp>
+#include <fixposition_driver_lib/telemetry.hpp>
 
 /* PACKAGE */
 #include <fixposition_driver_ros2/data_to_ros2.hpp>
 #include <fixposition_driver_ros2/msg/speed.hpp>
+#include <fixposition_driver_ros2/msg/status.hpp>
+#include <fixposition_driver_ros2/msg/telemetry.hpp>
 #include <fixposition_driver_ros2/msg/vrtk.hpp>
 
 
@@ -46,8 +51,36 @@
 /*PIXHOOK*/
 #include <pix_hooke_driver_msgs/msg/v2a_drive_sta_fb.hpp>
 
+/* RTCM */
+#include <rtcm_msgs/msg/message.hpp>
+
 
 namespace fixposition {
+
+/**
+ * @brief Publisher type created by a node of type NodeT
+ *
+ */
+template <typename NodeT, typename MsgT>
+struct NodePublisher {
+    using SharedPtr = typename rclcpp::Publisher<MsgT>::SharedPtr;
+};
+
+/**
+ * @brief Lifecycle nodes create publishers that only publish while the node is active
+ *
+ */
+template <typename MsgT>
+struct NodePublisher<rclcpp_lifecycle::LifecycleNode, MsgT> {
+    using SharedPtr = typename rclcpp_lifecycle::LifecyclePublisher<MsgT>::SharedPtr;
+};
+
+/**
+ * @brief Publishes the driver output on the topics of a ROS node
+ *
+ * @tparam NodeT rclcpp::Node, or rclcpp_lifecycle::LifecycleNode for FixpositionDriverLifecycleNode
+ */
+template <typename NodeT>
 class FixpositionDriverNode : public FixpositionDriver {
    public:
     /**
@@ -55,16 +88,56 @@ class FixpositionDriverNode : public FixpositionDriver {
      *
      * @param[in] params
      */
-    FixpositionDriverNode(std::shared_ptr<rclcpp::Node> node, const FixpositionDriverParams& params);
+    FixpositionDriverNode(std::shared_ptr<NodeT> node, const FixpositionDriverParams& params);
 
     void Run();
 
+    /**
+     * @brief Stop the timers and the wheelspeed forwarding while the caller stops calling RunOnce(), e.g. while a
+     * lifecycle node is inactive. The connection stays open.
+     *
+     */
+    void Pause();
+
+    /**
+     * @brief Continue after Pause(), the data that arrived in the meantime is discarded
+     *
+     */
+    void Resume();
+
     void RegisterObservers();
 
     // void WsCallback(const fixposition_driver_ros2::msg::Speed::ConstSharedPtr msg);
     void WsCallback(const pix_hooke_driver_msgs::msg::V2aDriveStaFb::ConstSharedPtr msg);
 
+    /**
+     * @brief Forward RTCM3 corrections received on customer_input.rtcm3.topic to the sensor
+     *
+     * @param[in] msg
+     */
+    void Rtcm3Callback(const rtcm_msgs::msg::Message::ConstSharedPtr msg);
+
    private:
+    /**
+     * @brief Log the gap, duplicate, out-of-order and jitter statistics of each message stream, and the wakeups, CPU
+     * and latency of the read loop
+     *
+     */
+    void ReportStreamStats();
+
+    /**
+     * @brief Publish the status flags of the VRTK data if any of them changed
+     *
+     * @param[in] data
+     */
+    void UpdateStatus(const VrtkData& data);
+
+    /**
+     * @brief Publish the current status again, so monitors can tell a silent driver from an unchanged status
+     *
+     */
+    void PublishStatusHeartbeat();
+
     /**
      * @brief Observer Functions to publish NavSatFix from BestGnssPos
      *
@@ -73,24 +146,46 @@ class FixpositionDriverNode : public FixpositionDriver {
      */
     void BestGnssPosToPublishNavSatFix(const Oem7MessageHeaderMem* header, const BESTGNSSPOSMem* payload);
     
-    std::shared_ptr<rclcpp::Node> node_;
-    rclcpp::Subscription<pix_hooke_driver_msgs::msg::V2aDriveStaFb>::SharedPtr ws_sub_;  //!< wheelspeed message subscriber
-
-    rclcpp::Publisher<sensor_msgs::msg::Imu>::SharedPtr rawimu_pub_;
-    rclcpp::Publisher<sensor_msgs::msg::Imu>::SharedPtr corrimu_pub_;
-    rclcpp::Publisher<sensor_msgs::msg::NavSatFix>::SharedPtr navsatfix_pub_;
-    rclcpp::Publisher<sensor_msgs::msg::NavSatFix>::SharedPtr navsatfix_gnss1_pub_;
-    rclcpp::Publisher<sensor_msgs::msg::NavSatFix>::SharedPtr navsatfix_gnss2_pub_;
-    rclcpp::Publisher<nav_msgs::msg::Odometry>::SharedPtr odometry_pub_;
-    rclcpp::Publisher<sensor_msgs::msg::Imu>::SharedPtr poiimu_pub_;             //!< Bias corrected IMU from ODOMETRY
-    rclcpp::Publisher<fixposition_driver_ros2::msg::VRTK>::SharedPtr vrtk_pub_;  //!< VRTK message
-    rclcpp::Publisher<nav_msgs::msg::Odometry>::SharedPtr odometry_enu0_pub_;    //!< ENU0 Odometry
-    rclcpp::Publisher<geometry_msgs::msg::Vector3Stamped>::SharedPtr eul_pub_;  //!< Euler angles Yaw-Pitch-Roll in local ENU
-    rclcpp::Publisher<geometry_msgs::msg::Vector3Stamped>::SharedPtr
+    template <typename MsgT>
+    using PublisherPtr = typename NodePublisher<NodeT, MsgT>::SharedPtr;
+
+    std::shared_ptr<NodeT> node_;
+    rclcpp::Subscription<pix_hooke_driver_msgs::msg::V2aDriveStaFb>::SharedPtr
+        ws_sub_;  //!< wheelspeed message subscriber
+    rclcpp::Subscription<rtcm_msgs::msg::Message>::SharedPtr rtcm3_sub_;  //!< RTCM3 corrections subscriber
+    bool paused_ = false;  //!< Pause() was called, drop wheelspeeds and corrections
+
+    PublisherPtr<sensor_msgs::msg::Imu> rawimu_pub_;
+    PublisherPtr<sensor_msgs::msg::Imu> corrimu_pub_;
+    PublisherPtr<sensor_msgs::msg::NavSatFix> navsatfix_pub_;
+    PublisherPtr<sensor_msgs::msg::NavSatFix> navsatfix_gnss1_pub_;
+    PublisherPtr<sensor_msgs::msg::NavSatFix> navsatfix_gnss2_pub_;
+    PublisherPtr<nav_msgs::msg::Odometry> odometry_pub_;
+    PublisherPtr<sensor_msgs::msg::Imu> poiimu_pub_;             //!< Bias corrected IMU from ODOMETRY
+    PublisherPtr<fixposition_driver_ros2::msg::VRTK> vrtk_pub_;  //!< VRTK message
+    PublisherPtr<nav_msgs::msg::Odometry> odometry_enu0_pub_;    //!< ENU0 Odometry
+    PublisherPtr<geometry_msgs::msg::Vector3Stamped> eul_pub_;   //!< Euler angles Yaw-Pitch-Roll in local ENU
+    PublisherPtr<geometry_msgs::msg::Vector3Stamped>
         eul_imu_pub_;  //!< Euler angles Pitch-Roll as estimated from the IMU in
                        // local horizontal
-    rclcpp::Publisher<autoware_sensing_msgs::msg::GnssInsOrientationStamped>::SharedPtr orientation_pub_;
+    PublisherPtr<autoware_sensing_msgs::msg::GnssInsOrientationStamped> orientation_pub_;
+
+
+    PublisherPtr<fixposition_driver_ros2::msg::Status> status_pub_;  //!< latched, change-only status
+    rclcpp::TimerBase::SharedPtr status_timer_;                      //!< status heartbeat
+    fixposition_driver_ros2::msg::Status status_;                    //!< last published status
+    bool status_valid_ = false;                                      //!< status_ holds a received status
+    fixposition_driver_ros2::msg::VRTK vrtk_;  //!< reused VRTK message, keeps the version string allocated
+
+    PublisherPtr<fixposition_driver_ros2::msg::Telemetry> telemetry_pub_;  //!< compact ODOMETRY
+    TelemetryEncoder telemetry_encoder_;                                   //!< quantizes and delta-encodes ODOMETRY
+    fixposition_driver_ros2::msg::Telemetry telemetry_;                    //!< reused telemetry message
+
+    PublisherPtr<fixposition_driver_ros2::msg::GpsClock> gps_clock_pub_;  //!< host to GPS clock
 
+    rclcpp::TimerBase::SharedPtr stats_timer_;  //!< timer to report stream statistics
+    ReadStats last_read_stats_;                 //!< read loop counters at the previous report
+    std::chrono::steady_clock::time_point last_stats_time_;  //!< time of the previous report
 
     std::shared_ptr<tf2_ros::TransformBroadcaster> br_;
     std::shared_ptr<tf2_ros::StaticTransformBroadcaster> static_br_;
@@ -38,7 +38,8 @@ namespace fixposition {
  * @return true
  * @return false
  */
-bool LoadParamsFromRos2(std::shared_ptr<rclcpp::Node> node, const std::string& ns, FpOutputParams& params);
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, FpOutputParams& params);
 
 /**
  * @brief Load all parameters from ROS parameter server
@@ -50,17 +51,127 @@ bool LoadParamsFromRos2(std::shared_ptr<rclcpp::Node> node, const std::string& n
  * @return false
  */
 
-bool LoadParamsFromRos2(std::shared_ptr<rclcpp::Node> node, const std::string& ns, CustomerInputParams& params);
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, CustomerInputParams& params);
 
 /**
  * @brief Load all parameters from ROS parameter server
  *
  * @param[in] node
+ * @param[in] ns namespace to load the parameters from
+ * @param[out] params
+ * @return true
+ * @return false
+ */
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, CanInputParams& params);
+
+/**
+ * @brief Load all parameters from ROS parameter server
+ *
+ * @param[in] node
+ * @param[in] ns namespace to load the parameters from
+ * @param[out] params
+ * @return true
+ * @return false
+ */
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, Rtcm3InputParams& params);
+
+/**
+ * @brief Load all parameters from ROS parameter server
+ *
+ * @param[in] node
+ * @param[in] ns namespace to load the parameters from
+ * @param[out] params
+ * @return true
+ * @return false
+ */
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, LoadSheddingParams& params);
+
+/**
+ * @brief Load all parameters from ROS parameter server
+ *
+ * @param[in] node
+ * @param[in] ns namespace to load the parameters from
+ * @param[out] params
+ * @return true
+ * @return false
+ */
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, ExtrinsicParams& params);
+
+/**
+ * @brief Load all parameters from ROS parameter server
+ *
+ * @param[in] node
+ * @param[in] ns namespace to load the parameters from
+ * @param[out] params
+ * @return true
+ * @return false
+ */
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, TelemetryParams& params);
+
+/**
+ * @brief Load all parameters from ROS parameter server
+ *
+ * @param[in] node
+ * @param[in] ns namespace to load the parameters from
+ * @param[out] params
+ * @return true
+ * @return false
+ */
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, ClockModelParams& params);
+
+/**
+ * @brief Load all parameters from ROS parameter server
+ *
+ * @param[in] node
+ * @param[in] ns namespace to load the parameters from
+ * @param[out] params
+ * @return true
+ * @return false
+ */
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, HotRestartParams& params);
+
+/**
+ * @brief Load all parameters from ROS parameter server
+ *
+ * @param[in] node
+ * @param[in] ns namespace to load the parameters from
+ * @param[out] params
+ * @return true
+ * @return false
+ */
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, FlightRecorderParams& params);
+
+/**
+ * @brief Load all parameters from ROS parameter server
+ *
+ * @param[in] node
+ * @param[in] ns namespace to load the parameters from
+ * @param[out] params
+ * @return true
+ * @return false
+ */
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, StatsParams& params);
+
+/**
+ * @brief Load all parameters from ROS parameter server
+ *
+ * @param[in] node rclcpp::Node or rclcpp_lifecycle::LifecycleNode
  * @param[out] params
  * @return true
  * @return false
  */
-bool LoadParamsFromRos2(std::shared_ptr<rclcpp::Node> node, FixpositionDriverParams& params);
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, FixpositionDriverParams& params);
 
 }  // namespace fixposition
 
@@ -0,0 +1,173 @@
+/**
+ *  @file
+ *  @brief Declaration of SensorEmulator, a stand-in TCP server for the Vision-RTK 2
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+#ifndef __FIXPOSITION_DRIVER_ROS2_SENSOR_EMULATOR__
+#define __FIXPOSITION_DRIVER_ROS2_SENSOR_EMULATOR__
+
+/* SYSTEM / STL */
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* FIXPOSITION */
+#include <fixposition_driver_lib/time_conversions.hpp>
+
+namespace fixposition {
+
+/**
+ * @brief Serve FP_A messages on a local TCP port like the sensor does
+ *
+ * The GPS time of every message is the wall clock time at which it is sent, so a subscriber can compute the
+ * sensor-to-subscriber latency from the header stamp of the ROS message alone.
+ */
+class SensorEmulator {
+   public:
+    struct Stream {
+        std::string header;  //!< FP_A message type: ODOMETRY, LLH, RAWIMU, CORRIMU or TF
+        double rate;         //!< output rate in [Hz]
+    };
+
+    /**
+     * @brief Construct a new SensorEmulator object
+     *
+     * @param[in] port TCP port to listen on
+     * @param[in] streams messages to send, streams with a rate <= 0 are ignored
+     */
+    SensorEmulator(const int port, const std::vector<Stream>& streams);
+
+    /**
+     * @brief Replay a recorded sensor output in a loop instead of sending the streams, call before Start()
+     *
+     * Messages are paced by their GPS time, divided by speed. Messages without a GPS time follow the previous one
+     * right away, jumps of the GPS time (e.g. where the loop starts again) do not pause the replay. FP_A messages are
+     * stamped with the send time like the streams, other messages are sent unchanged.
+     *
+     * @param[in] path recorded sensor output
+     * @param[in] speed replay speed, e.g. 10 for ten times faster than recorded
+     * @return true
+     * @return false cannot read the file or it contains no messages
+     */
+    bool LoadCapture(const std::string& path, const double speed);
+
+    /**
+     * @brief Close the connection periodically, so the driver has to reconnect. Call before Start()
+     *
+     * @param[in] period [s], <= 0 to keep the connection (default)
+     */
+    void SetDisconnectPeriod(const double period) { disconnect_period_ = period; }
+
+    /**
+     * @brief Destroy the SensorEmulator object, stop the server
+     *
+     */
+    ~SensorEmulator();
+
+    /**
+     * @brief Listen on the port and start serving in a thread
+     *
+     * @return true success
+     * @return false cannot listen on the port
+     */
+    bool Start();
+
+    /**
+     * @brief Stop serving and close all sockets
+     *
+     */
+    void Stop();
+
+    /**
+     * @brief Number of messages sent so far
+     *
+     * @return uint64_t
+     */
+    uint64_t SentCount() const { return sent_; }
+
+    /**
+     * @brief Number of connections accepted so far
+     *
+     * @return uint64_t
+     */
+    uint64_t ConnectionCount() const { return connections_; }
+
+    /**
+     * @brief Build a complete FP_A sentence incl. checksum and \r\n
+     *
+     * @param[in] header message type
+     * @param[in] stamp GPS time to put into the message
+     * @return std::string empty if the type is not supported
+     */
+    static std::string MakeSentence(const std::string& header, const times::GpsTime& stamp);
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Message of a recorded sensor output
+     *
+     */
+    struct CaptureFrame {
+        std::string data;  //!< complete frame
+        double delay;      //!< [s] after the previous frame, at replay speed
+        bool fp_a;         //!< FP_A message with a GPS time, restamped when sent
+    };
+
+    /**
+     * @brief Accept one client after the other and send the streams or the capture to it
+     *
+     */
+    void Serve();
+
+    /**
+     * @brief Send the streams until the client is gone, we stop or the disconnect period is over
+     *
+     * @param[in] client_fd
+     * @param[in] until end of the disconnect period
+     */
+    void ServeStreams(const int client_fd, const Clock::time_point until);
+
+    /**
+     * @brief Continue the replay of the capture until the client is gone, we stop or the disconnect period is over
+     *
+     * @param[in] client_fd
+     * @param[in] until end of the disconnect period
+     */
+    void ServeCapture(const int client_fd, const Clock::time_point until);
+
+    /**
+     * @brief Replace the GPS time (fields 3 and 4) of an FP_A sentence and update the checksum
+     *
+     * @param[in] sentence
+     * @param[in] stamp
+     * @return std::string
+     */
+    static std::string Restamp(const std::string& sentence, const times::GpsTime& stamp);
+
+    const int port_;
+    std::vector<Stream> streams_;        //!< streams with a positive rate
+    std::vector<CaptureFrame> capture_;  //!< recorded sensor output to replay, empty to send the streams
+    std::size_t capture_idx_ = 0;        //!< next frame to replay, the replay continues on the next connection
+    double disconnect_period_ = 0.0;     //!< [s], <= 0 to keep the connection
+    int server_fd_ = -1;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> sent_;
+    std::atomic<uint64_t> connections_;
+    std::thread thread_;
+};
+
+}  // namespace fixposition
+
+#endif
@@ -93,7 +93,10 @@ void VrtkDataToMsg(const VrtkData& data, fixposition_driver_ros2::msg::VRTK& msg
     msg.gnss1_status = data.gnss1_status;
     msg.gnss2_status = data.gnss2_status;
     msg.wheelspeed_status = data.wheelspeed_status;
-    msg.version = data.version;
+    // Unchanged most of the time, skip the copy
+    if (msg.version != data.version) {
+        msg.version = data.version;
+    }
 }
 
 void TfDataToMsg(const TfData& data, geometry_msgs::msg::TransformStamped& msg) {
@@ -110,4 +113,12 @@ void TfDataToMsg(const TfData& data, geometry_msgs::msg::TransformStamped& msg)
     tf2::toMsg(data.translation, msg.transform.translation);
 }
 
+void ClockEstimateToMsg(const ClockEstimate& data, fixposition_driver_ros2::msg::GpsClock& msg) {
+    msg.valid = data.valid;
+    msg.host_ref = data.host_ref;
+    msg.gps_ref = data.gps_ref;
+    msg.drift = data.drift;
+    msg.uncertainty = data.uncertainty;
+}
+
 }  // namespace fixposition
@@ -0,0 +1,121 @@
+/**
+ *  @file
+ *  @brief Implementation of FixpositionDriverLifecycleNode and its main function
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <algorithm>
+#include <memory>
+
+/* ROS */
+#include <rclcpp/logging.hpp>
+#include <rclcpp/rclcpp.hpp>
+
+/* PACKAGE */
+#include <fixposition_driver_ros2/fixposition_driver_lifecycle_node.hpp>
+#include <fixposition_driver_ros2/params.hpp>
+
+namespace fixposition {
+
+FixpositionDriverLifecycleNode::FixpositionDriverLifecycleNode(const rclcpp::NodeOptions& options)
+    : rclcpp_lifecycle::LifecycleNode("fixposition_driver", options) {}
+
+FixpositionDriverLifecycleNode::CallbackReturn FixpositionDriverLifecycleNode::on_configure(
+    const rclcpp_lifecycle::State& state) {
+    // Parameters can only be declared once, a node configured again after cleanup keeps them
+    if (!params_loaded_) {
+        if (!LoadParamsFromRos2(shared_from_this(), params_)) {
+            RCLCPP_ERROR(get_logger(), "Params Loading Failed!");
+            return CallbackReturn::FAILURE;
+        }
+        params_loaded_ = true;
+        RCLCPP_INFO(get_logger(), "Params Loaded!");
+    }
+
+    // Connects, or takes over the connection of a running instance. A failed connection is retried once active.
+    driver_.reset(new FixpositionDriverNode<rclcpp_lifecycle::LifecycleNode>(shared_from_this(), params_));
+    if (driver_->HandoffRefused()) {
+        RCLCPP_ERROR(get_logger(), "The running driver instance keeps the connection.");
+        driver_.reset();
+        return CallbackReturn::FAILURE;
+    }
+    driver_->Pause();
+    reconnect_ = false;
+    return CallbackReturn::SUCCESS;
+}
+
+FixpositionDriverLifecycleNode::CallbackReturn FixpositionDriverLifecycleNode::on_activate(
+    const rclcpp_lifecycle::State& state) {
+    // Activates the publishers
+    rclcpp_lifecycle::LifecycleNode::on_activate(state);
+    driver_->Resume();
+    read_timer_ = create_wall_timer(std::chrono::microseconds(1000000 / std::max(1, params_.fp_output.rate)),
+                                    std::bind(&FixpositionDriverLifecycleNode::Read, this));
+    return CallbackReturn::SUCCESS;
+}
+
+FixpositionDriverLifecycleNode::CallbackReturn FixpositionDriverLifecycleNode::on_deactivate(
+    const rclcpp_lifecycle::State& state) {
+    read_timer_.reset();
+    driver_->Pause();
+    rclcpp_lifecycle::LifecycleNode::on_deactivate(state);
+    return CallbackReturn::SUCCESS;
+}
+
+FixpositionDriverLifecycleNode::CallbackReturn FixpositionDriverLifecycleNode::on_cleanup(
+    const rclcpp_lifecycle::State& state) {
+    driver_.reset();
+    return CallbackReturn::SUCCESS;
+}
+
+FixpositionDriverLifecycleNode::CallbackReturn FixpositionDriverLifecycleNode::on_shutdown(
+    const rclcpp_lifecycle::State& state) {
+    read_timer_.reset();
+    driver_.reset();
+    return CallbackReturn::SUCCESS;
+}
+
+void FixpositionDriverLifecycleNode::Read() {
+    if (reconnect_) {
+        if (std::chrono::steady_clock::now() < reconnect_time_) {
+            return;
+        }
+        reconnect_ = false;
+        driver_->Connect();
+    }
+
+    if (driver_->RunOnce()) {
+        return;
+    }
+    if (driver_->HandedOver()) {
+        // A new driver instance took over the connection
+        RCLCPP_INFO(get_logger(), "Connection handed over to the new driver instance.");
+        read_timer_->cancel();
+        return;
+    }
+    RCLCPP_WARN(get_logger(), "Reconnecting in %.1f seconds ...", params_.fp_output.reconnect_delay);
+    reconnect_ = true;
+    reconnect_time_ = std::chrono::steady_clock::now() +
+                      std::chrono::microseconds(static_cast<int64_t>(params_.fp_output.reconnect_delay * 1e6));
+}
+
+}  // namespace fixposition
+
+int main(int argc, char** argv) {
+    rclcpp::init(argc, argv);
+    auto node = std::make_shared<fixposition::FixpositionDriverLifecycleNode>();
+    rclcpp::executors::SingleThreadedExecutor executor;
+    executor.add_node(node->get_node_base_interface());
+    executor.spin();
+    rclcpp::shutdown();
+    return 0;
+}
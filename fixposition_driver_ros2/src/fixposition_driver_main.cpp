@@ -0,0 +1,43 @@
+/**
+ *  @file
+ *  @brief Main function for the fixposition driver ros node
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <memory>
+
+/* ROS */
+#include <rclcpp/logging.hpp>
+#include <rclcpp/rclcpp.hpp>
+
+/* PACKAGE */
+#include <fixposition_driver_ros2/fixposition_driver_node.hpp>
+#include <fixposition_driver_ros2/params.hpp>
+
+int main(int argc, char** argv) {
+    rclcpp::init(argc, argv);
+    std::shared_ptr<rclcpp::Node> node = rclcpp::Node::make_shared("fixposition_driver");
+    fixposition::FixpositionDriverParams params;
+
+    RCLCPP_INFO(node->get_logger(), "Starting node...");
+
+    if (fixposition::LoadParamsFromRos2(node, params)) {
+        RCLCPP_INFO(node->get_logger(), "Params Loaded!");
+        fixposition::FixpositionDriverNode<rclcpp::Node> driver_node(node, params);
+        driver_node.Run();
+        RCLCPP_INFO(node->get_logger(), "Exiting.");
+    } else {
+        RCLCPP_ERROR(node->get_logger(), "Params Loading Failed!");
+        rclcpp::shutdown();
+        return 1;
+    }
+}
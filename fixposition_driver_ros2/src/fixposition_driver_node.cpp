@@ -1,6 +1,6 @@
 /**
  *  @file
- *  @brief Main function for the fixposition driver ros node
+ *  @brief Implementation of FixpositionDriverNode
  *
  * \verbatim
  *  ___    ___
@@ -18,6 +18,7 @@
 /* ROS */
 #include <rclcpp/logging.hpp>
 #include <rclcpp/rclcpp.hpp>
+#include <rclcpp_lifecycle/lifecycle_node.hpp>
 
 /* FIXPOSITION */
 #include <fixposition_driver_lib/converter/imu.hpp>
@@ -35,34 +36,176 @@
 
 namespace fixposition {
 
-FixpositionDriverNode::FixpositionDriverNode(std::shared_ptr<rclcpp::Node> node, const FixpositionDriverParams& params)
+template <typename NodeT>
+FixpositionDriverNode<NodeT>::FixpositionDriverNode(std::shared_ptr<NodeT> node, const FixpositionDriverParams& params)
     : FixpositionDriver(params),
       node_(node),
-      rawimu_pub_(node_->create_publisher<sensor_msgs::msg::Imu>("/fixposition/rawimu", 100)),
-      corrimu_pub_(node_->create_publisher<sensor_msgs::msg::Imu>("/fixposition/corrimu", 100)),
-      navsatfix_pub_(node_->create_publisher<sensor_msgs::msg::NavSatFix>("/fixposition/navsatfix", 100)),
-      navsatfix_gnss1_pub_(node_->create_publisher<sensor_msgs::msg::NavSatFix>("/fixposition/gnss1", 100)),
-      navsatfix_gnss2_pub_(node_->create_publisher<sensor_msgs::msg::NavSatFix>("/fixposition/gnss2", 100)),
-      odometry_pub_(node_->create_publisher<nav_msgs::msg::Odometry>("/fixposition/odometry", 100)),
-      poiimu_pub_(node_->create_publisher<sensor_msgs::msg::Imu>("/fixposition/poiimu", 100)),
-      vrtk_pub_(node_->create_publisher<fixposition_driver_ros2::msg::VRTK>("/fixposition/vrtk", 100)),
-      odometry_enu0_pub_(node_->create_publisher<nav_msgs::msg::Odometry>("/fixposition/odometry_enu", 100)),
+      rawimu_pub_(node_->template create_publisher<sensor_msgs::msg::Imu>("/fixposition/rawimu", 100)),
+      corrimu_pub_(node_->template create_publisher<sensor_msgs::msg::Imu>("/fixposition/corrimu", 100)),
+      navsatfix_pub_(node_->template create_publisher<sensor_msgs::msg::NavSatFix>("/fixposition/navsatfix", 100)),
+      navsatfix_gnss1_pub_(node_->template create_publisher<sensor_msgs::msg::NavSatFix>("/fixposition/gnss1", 100)),
+      navsatfix_gnss2_pub_(node_->template create_publisher<sensor_msgs::msg::NavSatFix>("/fixposition/gnss2", 100)),
+      odometry_pub_(node_->template create_publisher<nav_msgs::msg::Odometry>("/fixposition/odometry", 100)),
+      poiimu_pub_(node_->template create_publisher<sensor_msgs::msg::Imu>("/fixposition/poiimu", 100)),
+      vrtk_pub_(node_->template create_publisher<fixposition_driver_ros2::msg::VRTK>("/fixposition/vrtk", 100)),
+      odometry_enu0_pub_(node_->template create_publisher<nav_msgs::msg::Odometry>("/fixposition/odometry_enu", 100)),
       
-      orientation_pub_(node_->create_publisher<autoware_sensing_msgs::msg::GnssInsOrientationStamped>("/autoware_orientation", 100)),
+      orientation_pub_(node_->template create_publisher<autoware_sensing_msgs::msg::GnssInsOrientationStamped>(
+          "/autoware_orientation", 100)),
 
-      eul_pub_(node_->create_publisher<geometry_msgs::msg::Vector3Stamped>("/fixposition/ypr", 100)),
-      eul_imu_pub_(node_->create_publisher<geometry_msgs::msg::Vector3Stamped>("/fixposition/imu_ypr", 100)),
+      eul_pub_(node_->template create_publisher<geometry_msgs::msg::Vector3Stamped>("/fixposition/ypr", 100)),
+      eul_imu_pub_(node_->template create_publisher<geometry_msgs::msg::Vector3Stamped>("/fixposition/imu_ypr", 100)),
+      status_pub_(node_->template create_publisher<fixposition_driver_ros2::msg::Status>(
+          "/fixposition/status", rclcpp::QoS(1).reliable().transient_local())),
+      telemetry_encoder_(params_.telemetry),
       br_(std::make_shared<tf2_ros::TransformBroadcaster>(node_)),
       static_br_(std::make_shared<tf2_ros::StaticTransformBroadcaster>(node_)) {
-    ws_sub_ = node_->create_subscription<pix_hooke_driver_msgs::msg::V2aDriveStaFb>(
-        params_.customer_input.speed_topic, 100,
-        std::bind(&FixpositionDriverNode::WsCallback, this, std::placeholders::_1));
+    // Wheelspeeds read directly from CAN bypass the speed topic
+    if (params_.customer_input.can.interface.empty()) {
+        ws_sub_ = node_->template create_subscription<pix_hooke_driver_msgs::msg::V2aDriveStaFb>(
+            params_.customer_input.speed_topic, 100,
+            std::bind(&FixpositionDriverNode::WsCallback, this, std::placeholders::_1));
+    }
+    if (!params_.customer_input.rtcm3.topic.empty()) {
+        rtcm3_sub_ = node_->template create_subscription<rtcm_msgs::msg::Message>(
+            params_.customer_input.rtcm3.topic, 100,
+            std::bind(&FixpositionDriverNode::Rtcm3Callback, this, std::placeholders::_1));
+    }
+
+    if (params_.fp_output.status_heartbeat > 0.0) {
+        status_timer_ = node_->create_wall_timer(
+            std::chrono::milliseconds(static_cast<int64_t>(params_.fp_output.status_heartbeat * 1000)),
+            std::bind(&FixpositionDriverNode::PublishStatusHeartbeat, this));
+    }
+    if (params_.telemetry.enabled) {
+        telemetry_pub_ =
+            node_->template create_publisher<fixposition_driver_ros2::msg::Telemetry>("/fixposition/telemetry", 100);
+    }
+    if (params_.clock.enabled) {
+        gps_clock_pub_ = node_->template create_publisher<fixposition_driver_ros2::msg::GpsClock>(
+            "/fixposition/gps_clock", rclcpp::QoS(1).reliable().transient_local());
+        AddClockObserver([this](const ClockEstimate& estimate) {
+            fixposition_driver_ros2::msg::GpsClock msg;
+            msg.header.stamp = node_->now();
+            ClockEstimateToMsg(estimate, msg);
+            gps_clock_pub_->publish(msg);
+        });
+    }
+
+    if (params_.fp_output.stats_period > 0.0) {
+        stats_timer_ = node_->create_wall_timer(
+            std::chrono::milliseconds(static_cast<int64_t>(params_.fp_output.stats_period * 1000)),
+            std::bind(&FixpositionDriverNode::ReportStreamStats, this));
+    }
 
-    Connect();
+    // FixpositionDriver connected already, or took over the connection of a running instance
     RegisterObservers();
 }
 
-void FixpositionDriverNode::Run() {
+template <typename NodeT>
+void FixpositionDriverNode<NodeT>::ReportStreamStats() {
+    const auto now = std::chrono::steady_clock::now();
+    const ReadStats read_stats = GetReadStats();
+    if (last_stats_time_.time_since_epoch().count() > 0) {
+        const double dt = std::chrono::duration<double>(now - last_stats_time_).count();
+        const uint64_t latency_count = read_stats.latency_count - last_read_stats_.latency_count;
+        RCLCPP_INFO(node_->get_logger(),
+                    "read: %.1f wakeups/s (%.1f empty), %.1f kB/s, CPU %.1f %%, latency mean %.3f ms (max %.3f ms)",
+                    (read_stats.wakeups - last_read_stats_.wakeups) / dt,
+                    (read_stats.empty_reads - last_read_stats_.empty_reads) / dt,
+                    (read_stats.bytes - last_read_stats_.bytes) / dt * 1e-3,
+                    (read_stats.cpu_time - last_read_stats_.cpu_time) / dt * 1e2,
+                    latency_count > 0 ? (read_stats.latency_sum - last_read_stats_.latency_sum) / latency_count * 1e3
+                                      : 0.0,
+                    read_stats.latency_max * 1e3);
+    }
+    last_read_stats_ = read_stats;
+    last_stats_time_ = now;
+
+    for (const auto& monitor : GetSequenceMonitors()) {
+        const auto& stats = monitor.second.GetStats();
+        RCLCPP_INFO(node_->get_logger(),
+                    "%s: %lu msgs, step %.3f s, %lu gaps (%lu missing), %lu duplicates, %lu out of order, "
+                    "jitter %.3f ms (max %.3f ms)",
+                    monitor.first.c_str(), stats.count, stats.nominal_step, stats.gaps, stats.missing,
+                    stats.duplicates, stats.out_of_order, stats.jitter * 1e3, stats.max_jitter * 1e3);
+    }
+    if (params_.load_shedding.enabled) {
+        const auto& shedder = GetLoadShedder();
+        for (const auto& shed : shedder.GetShedCounts()) {
+            RCLCPP_INFO(node_->get_logger(), "%s: %lu msgs shed (level %d)", shed.first.c_str(), shed.second,
+                        shedder.GetLevel());
+        }
+    }
+    for (const auto& errors : GetDecodeErrors()) {
+        RCLCPP_WARN(node_->get_logger(), "%s: %lu malformed msgs dropped", errors.first.c_str(), errors.second);
+    }
+
+    const auto& rtcm3 = params_.customer_input.rtcm3;
+    if (rtcm3.port > 0 || !rtcm3.topic.empty()) {
+        const Rtcm3Stats stats = GetRtcm3Stats();
+        RCLCPP_INFO(node_->get_logger(),
+                    "RTCM3: %lu frames (%lu kB) forwarded, %lu CRC errors, %lu dropped, latency mean %.3f ms (max %.3f "
+                    "ms), age mean %.3f s (max %.3f s)",
+                    stats.frames, stats.bytes / 1000, stats.crc_errors, stats.dropped,
+                    stats.frames > 0 ? stats.latency_sum / stats.frames * 1e3 : 0.0, stats.latency_max * 1e3,
+                    stats.age_count > 0 ? stats.age_sum / stats.age_count : 0.0, stats.age_max);
+    }
+}
+
+template <typename NodeT>
+void FixpositionDriverNode<NodeT>::UpdateStatus(const VrtkData& data) {
+    status_.header.stamp = GpsTimeToMsgTime(data.stamp);
+    if (status_valid_ && status_.fusion_status == data.fusion_status &&
+        status_.imu_bias_status == data.imu_bias_status && status_.gnss1_status == data.gnss1_status &&
+        status_.gnss2_status == data.gnss2_status && status_.wheelspeed_status == data.wheelspeed_status &&
+        status_.version == data.version) {
+        return;
+    }
+    status_.header.frame_id = data.frame_id;
+    status_.fusion_status = data.fusion_status;
+    status_.imu_bias_status = data.imu_bias_status;
+    status_.gnss1_status = data.gnss1_status;
+    status_.gnss2_status = data.gnss2_status;
+    status_.wheelspeed_status = data.wheelspeed_status;
+    status_.version = data.version;
+    status_valid_ = true;
+    status_pub_->publish(status_);
+}
+
+template <typename NodeT>
+void FixpositionDriverNode<NodeT>::PublishStatusHeartbeat() {
+    if (status_valid_) {
+        status_pub_->publish(status_);
+    }
+}
+
+template <typename NodeT>
+void FixpositionDriverNode<NodeT>::Pause() {
+    paused_ = true;
+    if (status_timer_) {
+        status_timer_->cancel();
+    }
+    if (stats_timer_) {
+        stats_timer_->cancel();
+    }
+}
+
+template <typename NodeT>
+void FixpositionDriverNode<NodeT>::Resume() {
+    // Stale by now, and a burst of old messages would look like fresh ones to the subscribers
+    FlushInput();
+    if (status_timer_) {
+        status_timer_->reset();
+    }
+    if (stats_timer_) {
+        stats_timer_->reset();
+    }
+    paused_ = false;
+}
+
+template <typename NodeT>
+void FixpositionDriverNode<NodeT>::Run() {
     rclcpp::Rate rate(params_.fp_output.rate);
     const auto reconnect_delay =
         std::chrono::nanoseconds((uint64_t)params_.fp_output.reconnect_delay * 1000 * 1000 * 1000);
@@ -71,107 +214,131 @@ void FixpositionDriverNode::Run() {
         // Read data and publish to ros
         const bool connection_ok = RunOnce();
         // process Incoming ROS msgs
-        rclcpp::spin_some(node_);
+        rclcpp::spin_some(node_->get_node_base_interface());
+        // A new driver instance took over the connection
+        if (HandedOver()) {
+            RCLCPP_INFO(node_->get_logger(), "Connection handed over to the new driver instance.");
+            break;
+        }
+        // The running driver instance did not hand over, this one must not connect
+        if (HandoffRefused()) {
+            RCLCPP_ERROR(node_->get_logger(), "The running driver instance keeps the connection.");
+            break;
+        }
         // Handle connection loss
         if (!connection_ok) {
             printf("Reconnecting in %.1f seconds ...\n", params_.fp_output.reconnect_delay);
 
             rclcpp::sleep_for(reconnect_delay);
             Connect();
-        } else {
+        } else if (params_.fp_output.read.strategy == READ_STRATEGY::RATE) {
             rate.sleep();
-        }
+        }  // else RunOnce() waited for data
     }
 }
 
-void FixpositionDriverNode::RegisterObservers() {
+template <typename NodeT>
+void FixpositionDriverNode<NodeT>::RegisterObservers() {
     // NOV_B
     bestgnsspos_obs_.push_back(std::bind(&FixpositionDriverNode::BestGnssPosToPublishNavSatFix, this,
                                          std::placeholders::_1, std::placeholders::_2));
     // FP_A
     for (const auto& format : params_.fp_output.formats) {
         if (format == "ODOMETRY") {
-            dynamic_cast<OdometryConverter*>(a_converters_["ODOMETRY"].get())
-                ->AddObserver([this](const OdometryConverter::Msgs& data) {
-                    // ODOMETRY Observer Lambda
-                    // Msgs
-                    if (odometry_pub_->get_subscription_count() > 0) {
-                        nav_msgs::msg::Odometry odometry;
-                        OdometryDataToMsg(data.odometry, odometry);
-                        odometry_pub_->publish(odometry);
-                    }
+            AddOdometryObserver([this](const OdometryConverter::Msgs& data) {
+                // ODOMETRY Observer Lambda
+                // Msgs
+                if (odometry_pub_->get_subscription_count() > 0) {
+                    nav_msgs::msg::Odometry odometry;
+                    OdometryDataToMsg(data.odometry, odometry);
+                    odometry_pub_->publish(odometry);
+                }
 
-                    if (odometry_enu0_pub_->get_subscription_count() > 0) {
-                        nav_msgs::msg::Odometry odometry_enu0;
-                        autoware_sensing_msgs::msg::GnssInsOrientationStamped gnss_ins_orientation;
-                        OdometryDataToMsg(data.odometry_enu0, odometry_enu0);
-                        gnss_ins_orientation.header = odometry_enu0.header;
-                        gnss_ins_orientation.orientation.orientation = odometry_enu0.pose.pose.orientation;
-                        gnss_ins_orientation.orientation.rmse_rotation_x = 0.0017;
-                        gnss_ins_orientation.orientation.rmse_rotation_y = 0.0017;
-                        gnss_ins_orientation.orientation.rmse_rotation_z = 0.0017;
-                        odometry_enu0_pub_->publish(odometry_enu0);
-                        orientation_pub_->publish(gnss_ins_orientation);
-                    }
+                if (odometry_enu0_pub_->get_subscription_count() > 0) {
+                    nav_msgs::msg::Odometry odometry_enu0;
+                    autoware_sensing_msgs::msg::GnssInsOrientationStamped gnss_ins_orientation;
+                    OdometryDataToMsg(data.odometry_enu0, odometry_enu0);
+                    gnss_ins_orientation.header = odometry_enu0.header;
+                    gnss_ins_orientation.orientation.orientation = odometry_enu0.pose.pose.orientation;
+                    gnss_ins_orientation.orientation.rmse_rotation_x = 0.0017;
+                    gnss_ins_orientation.orientation.rmse_rotation_y = 0.0017;
+                    gnss_ins_orientation.orientation.rmse_rotation_z = 0.0017;
+                    odometry_enu0_pub_->publish(odometry_enu0);
+                    orientation_pub_->publish(gnss_ins_orientation);
+                }
 
-                    if (vrtk_pub_->get_subscription_count() > 0) {
-                        fixposition_driver_ros2::msg::VRTK vrtk;
-                        VrtkDataToMsg(data.vrtk, vrtk);
-                        vrtk_pub_->publish(vrtk);
-                    }
-                    if (eul_pub_->get_subscription_count() > 0) {
-                        geometry_msgs::msg::Vector3Stamped ypr;
-                        ypr.header.stamp = GpsTimeToMsgTime(data.odometry.stamp);
-                        ypr.header.frame_id = "FP_POI";
-                        ypr.vector.set__x(data.eul.x());
-                        ypr.vector.set__y(data.eul.y());
-                        ypr.vector.set__z(data.eul.z());
-                        eul_pub_->publish(ypr);
-                    }
+                if (vrtk_pub_->get_subscription_count() > 0) {
+                    VrtkDataToMsg(data.vrtk, vrtk_);
+                    vrtk_pub_->publish(vrtk_);
+                }
+                UpdateStatus(data.vrtk);
+                if (telemetry_pub_) {
+                    telemetry_encoder_.Encode(data.odometry, telemetry_.data);
+                    telemetry_pub_->publish(telemetry_);
+                }
+                if (params_.fp_output.llh_from_odometry && data.llh_valid &&
+                    navsatfix_pub_->get_subscription_count() > 0) {
+                    sensor_msgs::msg::NavSatFix navsatfix;
+                    NavSatFixDataToMsg(data.llh, navsatfix);
+                    navsatfix_pub_->publish(navsatfix);
+                }
+                if (eul_pub_->get_subscription_count() > 0 &&
+                    (!load_shedder_.Shedding() || load_shedder_.Accept("YPR"))) {
+                    geometry_msgs::msg::Vector3Stamped ypr;
+                    ypr.header.stamp = GpsTimeToMsgTime(data.odometry.stamp);
+                    ypr.header.frame_id = "FP_POI";
+                    ypr.vector.set__x(data.eul.x());
+                    ypr.vector.set__y(data.eul.y());
+                    ypr.vector.set__z(data.eul.z());
+                    eul_pub_->publish(ypr);
+                }
 
-                    if (poiimu_pub_->get_subscription_count() > 0) {
-                        sensor_msgs::msg::Imu poiimu;
-                        ImuDataToMsg(data.imu, poiimu);
-                        poiimu_pub_->publish(poiimu);
+                if (poiimu_pub_->get_subscription_count() > 0) {
+                    sensor_msgs::msg::Imu poiimu;
+                    ImuDataToMsg(data.imu, poiimu);
+                    if (!params_.extrinsic.frame_id.empty()) {
+                        poiimu.header.frame_id = data.imu.frame_id;
                     }
+                    poiimu_pub_->publish(poiimu);
+                }
 
-                    // TFs
-                    if (data.vrtk.fusion_status > 0) {
-                        geometry_msgs::msg::TransformStamped tf_ecef_poi;
-                        geometry_msgs::msg::TransformStamped tf_ecef_enu;
-                        geometry_msgs::msg::TransformStamped tf_ecef_enu0;
-                        TfDataToMsg(data.tf_ecef_poi, tf_ecef_poi);
-                        TfDataToMsg(data.tf_ecef_enu, tf_ecef_enu);
-                        TfDataToMsg(data.tf_ecef_enu0, tf_ecef_enu0);
-
-                        // br_->sendTransform(tf_ecef_enu);
-                        // br_->sendTransform(tf_ecef_poi);
-                        // static_br_->sendTransform(tf_ecef_enu0);
-                    }
-                });
-        } else if (format == "LLH" && a_converters_["LLH"]) {
-            dynamic_cast<LlhConverter*>(a_converters_["LLH"].get())->AddObserver([this](const NavSatFixData& data) {
+                // TFs
+                if (data.vrtk.fusion_status > 0) {
+                    geometry_msgs::msg::TransformStamped tf_ecef_poi;
+                    geometry_msgs::msg::TransformStamped tf_ecef_enu;
+                    geometry_msgs::msg::TransformStamped tf_ecef_enu0;
+                    TfDataToMsg(data.tf_ecef_poi, tf_ecef_poi);
+                    TfDataToMsg(data.tf_ecef_enu, tf_ecef_enu);
+                    TfDataToMsg(data.tf_ecef_enu0, tf_ecef_enu0);
+
+                    // br_->sendTransform(tf_ecef_enu);
+                    // br_->sendTransform(tf_ecef_poi);
+                    // static_br_->sendTransform(tf_ecef_enu0);
+                }
+            });
+        } else if (format == "LLH") {
+            AddLlhObserver([this](const NavSatFixData& data) {
                 // LLH Observer Lambda
                 sensor_msgs::msg::NavSatFix msg;
                 NavSatFixDataToMsg(data, msg);
                 navsatfix_pub_->publish(msg);
             });
         } else if (format == "RAWIMU") {
-            dynamic_cast<ImuConverter*>(a_converters_["RAWIMU"].get())->AddObserver([this](const ImuData& data) {
+            AddRawImuObserver([this](const ImuData& data) {
                 // RAWIMU Observer Lambda
                 sensor_msgs::msg::Imu msg;
                 ImuDataToMsg(data, msg);
                 rawimu_pub_->publish(msg);
             });
         } else if (format == "CORRIMU") {
-            dynamic_cast<ImuConverter*>(a_converters_["CORRIMU"].get())->AddObserver([this](const ImuData& data) {
+            AddCorrImuObserver([this](const ImuData& data) {
                 // CORRIMU Observer Lambda
                 sensor_msgs::msg::Imu msg;
                 ImuDataToMsg(data, msg);
                 corrimu_pub_->publish(msg);
             });
         } else if (format == "TF") {
-            dynamic_cast<TfConverter*>(a_converters_["TF"].get())->AddObserver([this](const TfData& data) {
+            AddTfObserver([this](const TfData& data) {
                 // TF Observer Lambda
                 geometry_msgs::msg::TransformStamped tf;
                 TfDataToMsg(data, tf);
@@ -200,13 +367,26 @@ void FixpositionDriverNode::RegisterObservers() {
 // void FixpositionDriverNode::WsCallback(const fixposition_driver_ros2::msg::Speed::ConstSharedPtr msg) {
 //     FixpositionDriver::WsCallback(msg->speeds);
 // }
-void FixpositionDriverNode::WsCallback(const pix_hooke_driver_msgs::msg::V2aDriveStaFb::ConstSharedPtr msg) {
+template <typename NodeT>
+void FixpositionDriverNode<NodeT>::WsCallback(const pix_hooke_driver_msgs::msg::V2aDriveStaFb::ConstSharedPtr msg) {
+    if (paused_) {
+        return;
+    }
     std::vector<int> speed;
     speed.push_back(int(msg->vcu_chassis_speed_fb * 1000));
     FixpositionDriver::WsCallback(speed);
 }
 
-void FixpositionDriverNode::BestGnssPosToPublishNavSatFix(const Oem7MessageHeaderMem* header,
+template <typename NodeT>
+void FixpositionDriverNode<NodeT>::Rtcm3Callback(const rtcm_msgs::msg::Message::ConstSharedPtr msg) {
+    if (paused_) {
+        return;
+    }
+    ForwardRtcm3(msg->message.data(), static_cast<int>(msg->message.size()));
+}
+
+template <typename NodeT>
+void FixpositionDriverNode<NodeT>::BestGnssPosToPublishNavSatFix(const Oem7MessageHeaderMem* header,
                                                           const BESTGNSSPOSMem* payload) {
     // Buffer to data struct
     NavSatFixData nav_sat_fix;
@@ -228,23 +408,10 @@ void FixpositionDriverNode::BestGnssPosToPublishNavSatFix(const Oem7MessageHeade
     }
 }
 
-}  // namespace fixposition
-
-int main(int argc, char** argv) {
-    rclcpp::init(argc, argv);
-    std::shared_ptr<rclcpp::Node> node = rclcpp::Node::make_shared("fixposition_driver");
-    fixposition::FixpositionDriverParams params;
-
-    RCLCPP_INFO(node->get_logger(), "Starting node...");
+template class FixpositionDriverNode<rclcpp::Node>;
+// Only built along with the lifecycle executable, see CMakeLists.txt
+#ifdef FIXPOSITION_DRIVER_LIFECYCLE_NODE
+template class FixpositionDriverNode<rclcpp_lifecycle::LifecycleNode>;
+#endif
 
-    if (fixposition::LoadParamsFromRos2(node, params)) {
-        RCLCPP_INFO(node->get_logger(), "Params Loaded!");
-        fixposition::FixpositionDriverNode driver_node(node, params);
-        driver_node.Run();
-        RCLCPP_INFO(node->get_logger(), "Exiting.");
-    } else {
-        RCLCPP_ERROR(node->get_logger(), "Params Loading Failed!");
-        rclcpp::shutdown();
-        return 1;
-    }
-}
+}  // namespace fixposition
@@ -0,0 +1,192 @@
+/**
+ *  @file
+ *  @brief End-to-end latency measurement: emulated sensor -> driver node -> subscriber
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+
+/* ROS */
+#include <geometry_msgs/msg/vector3_stamped.hpp>
+#include <nav_msgs/msg/odometry.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/imu.hpp>
+#include <sensor_msgs/msg/nav_sat_fix.hpp>
+
+/* PACKAGE */
+#include <fixposition_driver_ros2/msg/vrtk.hpp>
+#include <fixposition_driver_ros2/sensor_emulator.hpp>
+
+namespace fixposition {
+
+/**
+ * @brief Subscribes to the driver outputs with several QoS settings and records the latency of every message
+ *
+ * The emulator stamps every message with its send time, so latency = receive time - header stamp.
+ */
+class LatencyHarness {
+   public:
+    LatencyHarness(std::shared_ptr<rclcpp::Node> node) : node_(node) {
+        qos_.emplace_back("reliable", rclcpp::QoS(100).reliable());
+        qos_.emplace_back("best_effort", rclcpp::SensorDataQoS());
+
+        Subscribe<nav_msgs::msg::Odometry>("/fixposition/odometry");
+        Subscribe<nav_msgs::msg::Odometry>("/fixposition/odometry_enu");
+        Subscribe<fixposition_driver_ros2::msg::VRTK>("/fixposition/vrtk");
+        Subscribe<sensor_msgs::msg::Imu>("/fixposition/poiimu");
+        Subscribe<geometry_msgs::msg::Vector3Stamped>("/fixposition/ypr");
+        Subscribe<sensor_msgs::msg::NavSatFix>("/fixposition/navsatfix");
+        Subscribe<sensor_msgs::msg::Imu>("/fixposition/rawimu");
+        Subscribe<sensor_msgs::msg::Imu>("/fixposition/corrimu");
+        Subscribe<geometry_msgs::msg::Vector3Stamped>("/fixposition/imu_ypr");
+    }
+
+    /**
+     * @brief Total number of messages received
+     *
+     */
+    std::size_t Count() const {
+        std::size_t count = 0;
+        for (const auto& rec : records_) {
+            count += rec.second.size();
+        }
+        return count;
+    }
+
+    /**
+     * @brief Print the latency distribution per topic and QoS, optionally also as CSV
+     *
+     * @param[in] csv_file file to write, empty for none
+     * @return double worst p99 latency over all topics in [ms]
+     */
+    double Report(const std::string& csv_file) {
+        std::ofstream csv;
+        if (!csv_file.empty()) {
+            csv.open(csv_file);
+            csv << "topic,qos,count,min_ms,mean_ms,p50_ms,p90_ms,p99_ms,max_ms\n";
+        }
+
+        double worst_p99 = 0.0;
+        printf("%-28s %-12s %8s %9s %9s %9s %9s %9s %9s\n", "topic", "qos", "count", "min", "mean", "p50", "p90", "p99",
+               "max");
+        for (auto& rec : records_) {
+            auto& lat = rec.second;
+            if (lat.empty()) {
+                continue;
+            }
+            std::sort(lat.begin(), lat.end());
+            double sum = 0.0;
+            for (const double l : lat) {
+                sum += l;
+            }
+            const double mean = sum / lat.size();
+            const double p50 = Percentile(lat, 0.50);
+            const double p90 = Percentile(lat, 0.90);
+            const double p99 = Percentile(lat, 0.99);
+            worst_p99 = std::max(worst_p99, p99);
+
+            printf("%-28s %-12s %8zu %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f\n", rec.first.first.c_str(),
+                   rec.first.second.c_str(), lat.size(), lat.front(), mean, p50, p90, p99, lat.back());
+            if (csv.is_open()) {
+                csv << rec.first.first << "," << rec.first.second << "," << lat.size() << "," << lat.front() << ","
+                    << mean << "," << p50 << "," << p90 << "," << p99 << "," << lat.back() << "\n";
+            }
+        }
+        return worst_p99;
+    }
+
+   private:
+    template <typename MsgT>
+    void Subscribe(const std::string& topic) {
+        for (const auto& qos : qos_) {
+            auto& rec = records_[std::make_pair(topic, qos.first)];
+            subs_.push_back(node_->create_subscription<MsgT>(
+                topic, qos.second, [&rec](const typename MsgT::ConstSharedPtr msg) {
+                    const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::system_clock::now().time_since_epoch())
+                                         .count();
+                    const int64_t stamp = int64_t(msg->header.stamp.sec) * 1000000000 + msg->header.stamp.nanosec;
+                    rec.push_back((now - stamp) * 1e-6);
+                }));
+        }
+    }
+
+    static double Percentile(const std::vector<double>& sorted, const double p) {
+        const std::size_t idx = std::min(sorted.size() - 1, static_cast<std::size_t>(p * sorted.size()));
+        return sorted[idx];
+    }
+
+    std::shared_ptr<rclcpp::Node> node_;
+    std::vector<std::pair<std::string, rclcpp::QoS>> qos_;
+    std::vector<rclcpp::SubscriptionBase::SharedPtr> subs_;
+    std::map<std::pair<std::string, std::string>, std::vector<double>> records_;  //!< (topic, qos) -> latencies [ms]
+};
+
+}  // namespace fixposition
+
+int main(int argc, char** argv) {
+    rclcpp::init(argc, argv);
+    auto node = rclcpp::Node::make_shared("fixposition_latency_harness");
+
+    const int port = node->declare_parameter("port", 21001);
+    const double duration = node->declare_parameter("duration", 30.0);
+    const double max_p99_ms = node->declare_parameter("max_p99_ms", 0.0);
+    const std::string csv_file = node->declare_parameter("csv_file", std::string(""));
+    const std::vector<fixposition::SensorEmulator::Stream> streams = {
+        {"ODOMETRY", node->declare_parameter("odometry_rate", 100.0)},
+        {"LLH", node->declare_parameter("llh_rate", 10.0)},
+        {"RAWIMU", node->declare_parameter("rawimu_rate", 200.0)},
+        {"CORRIMU", node->declare_parameter("corrimu_rate", 200.0)},
+        {"TF", node->declare_parameter("tf_rate", 200.0)},
+    };
+
+    fixposition::SensorEmulator emulator(port, streams);
+    if (!emulator.Start()) {
+        rclcpp::shutdown();
+        return 1;
+    }
+    fixposition::LatencyHarness harness(node);
+    RCLCPP_INFO(node->get_logger(), "Serving on port %d, waiting for the driver to connect...", port);
+
+    // Measure for the given duration starting with the first received message
+    rclcpp::executors::SingleThreadedExecutor executor;
+    executor.add_node(node);
+    auto start = std::chrono::steady_clock::time_point::max();
+    while (rclcpp::ok()) {
+        executor.spin_once(std::chrono::milliseconds(100));
+        const auto now = std::chrono::steady_clock::now();
+        if (start == std::chrono::steady_clock::time_point::max() && harness.Count() > 0) {
+            start = now;
+            RCLCPP_INFO(node->get_logger(), "Driver connected, measuring for %.1f s", duration);
+        }
+        if (start != std::chrono::steady_clock::time_point::max() &&
+            now - start > std::chrono::duration<double>(duration)) {
+            break;
+        }
+    }
+    emulator.Stop();
+
+    RCLCPP_INFO(node->get_logger(), "Sent %lu messages, received %zu", emulator.SentCount(), harness.Count());
+    const double worst_p99 = harness.Report(csv_file);
+    rclcpp::shutdown();
+
+    // Regression gate
+    if (max_p99_ms > 0.0 && worst_p99 > max_p99_ms) {
+        printf("FAIL: worst p99 latency %.3f ms exceeds %.3f ms\n", worst_p99, max_p99_ms);
+        return 1;
+    }
+    return 0;
+}
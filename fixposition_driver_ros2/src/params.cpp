@@ -14,13 +14,15 @@
 
 /* ROS */
 #include <rclcpp/rclcpp.hpp>
+#include <rclcpp_lifecycle/lifecycle_node.hpp>
 
 /* PACKAGE */
 #include <fixposition_driver_ros2/params.hpp>
 
 namespace fixposition {
 
-bool LoadParamsFromRos2(std::shared_ptr<rclcpp::Node> node, const std::string& ns, FpOutputParams& params) {
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, FpOutputParams& params) {
     const std::string RATE = ns + ".rate";
     const std::string RECONNECT_DELAY = ns + ".reconnect_delay";
     const std::string TYPE = ns + ".type";
@@ -28,6 +30,15 @@ bool LoadParamsFromRos2(std::shared_ptr<rclcpp::Node> node, const std::string& n
     const std::string IP = ns + ".ip";
     const std::string PORT = ns + ".port";
     const std::string BAUDRATE = ns + ".baudrate";
+    const std::string AUTO_BAUD = ns + ".auto_baud";
+    const std::string AUTO_BAUD_WINDOW = ns + ".auto_baud_window";
+    const std::string STATS_PERIOD = ns + ".stats_period";
+    const std::string LLH_FROM_ODOMETRY = ns + ".llh_from_odometry";
+    const std::string STATUS_HEARTBEAT = ns + ".status_heartbeat";
+    const std::string STRATEGY = ns + ".read_strategy";
+    const std::string SPIN_TIME = ns + ".spin_time";
+    const std::string MIN_BATCH = ns + ".min_batch";
+    const std::string MAX_BATCH_DELAY = ns + ".max_batch_delay";
 
     node->declare_parameter(RATE, 100);
     node->declare_parameter(RECONNECT_DELAY, 5.0);
@@ -36,6 +47,15 @@ bool LoadParamsFromRos2(std::shared_ptr<rclcpp::Node> node, const std::string& n
     node->declare_parameter(PORT, "21000");
     node->declare_parameter(IP, "127.0.0.1");
     node->declare_parameter(BAUDRATE, 115200);
+    node->declare_parameter(AUTO_BAUD, params.auto_baud);
+    node->declare_parameter(AUTO_BAUD_WINDOW, params.auto_baud_window);
+    node->declare_parameter(STATS_PERIOD, 0.0);
+    node->declare_parameter(LLH_FROM_ODOMETRY, false);
+    node->declare_parameter(STATUS_HEARTBEAT, params.status_heartbeat);
+    node->declare_parameter(STRATEGY, "rate");
+    node->declare_parameter(SPIN_TIME, params.read.spin_time);
+    node->declare_parameter(MIN_BATCH, params.read.min_batch);
+    node->declare_parameter(MAX_BATCH_DELAY, params.read.max_batch_delay);
     // read parameters
     if (node->get_parameter(RATE, params.rate)) {
         RCLCPP_INFO(node->get_logger(), "%s : %d", RATE.c_str(), params.rate);
@@ -48,6 +68,37 @@ bool LoadParamsFromRos2(std::shared_ptr<rclcpp::Node> node, const std::string& n
         RCLCPP_WARN(node->get_logger(), "%s : %f", RECONNECT_DELAY.c_str(), params.reconnect_delay);
     }
 
+    node->get_parameter(STATS_PERIOD, params.stats_period);
+    RCLCPP_INFO(node->get_logger(), "%s : %f", STATS_PERIOD.c_str(), params.stats_period);
+
+    node->get_parameter(LLH_FROM_ODOMETRY, params.llh_from_odometry);
+    RCLCPP_INFO(node->get_logger(), "%s : %d", LLH_FROM_ODOMETRY.c_str(), params.llh_from_odometry);
+
+    node->get_parameter(STATUS_HEARTBEAT, params.status_heartbeat);
+    RCLCPP_INFO(node->get_logger(), "%s : %f", STATUS_HEARTBEAT.c_str(), params.status_heartbeat);
+
+    std::string strategy_str;
+    node->get_parameter(STRATEGY, strategy_str);
+    RCLCPP_INFO(node->get_logger(), "%s : %s", STRATEGY.c_str(), strategy_str.c_str());
+    if (strategy_str == "rate") {
+        params.read.strategy = READ_STRATEGY::RATE;
+    } else if (strategy_str == "blocking") {
+        params.read.strategy = READ_STRATEGY::BLOCKING;
+    } else if (strategy_str == "busy_poll") {
+        params.read.strategy = READ_STRATEGY::BUSY_POLL;
+        node->get_parameter(SPIN_TIME, params.read.spin_time);
+        RCLCPP_INFO(node->get_logger(), "%s : %f", SPIN_TIME.c_str(), params.read.spin_time);
+    } else if (strategy_str == "coalesced") {
+        params.read.strategy = READ_STRATEGY::COALESCED;
+        node->get_parameter(MIN_BATCH, params.read.min_batch);
+        RCLCPP_INFO(node->get_logger(), "%s : %d", MIN_BATCH.c_str(), params.read.min_batch);
+        node->get_parameter(MAX_BATCH_DELAY, params.read.max_batch_delay);
+        RCLCPP_INFO(node->get_logger(), "%s : %f", MAX_BATCH_DELAY.c_str(), params.read.max_batch_delay);
+    } else {
+        RCLCPP_ERROR(node->get_logger(), "Read strategy has to be rate, blocking, busy_poll or coalesced!");
+        return false;
+    }
+
     std::string type_str;
     node->get_parameter(TYPE, type_str);
     if (type_str == "tcp") {
@@ -83,26 +134,318 @@ bool LoadParamsFromRos2(std::shared_ptr<rclcpp::Node> node, const std::string& n
         } else {
             RCLCPP_WARN(node->get_logger(), "Using Default %s : %d", BAUDRATE.c_str(), params.baudrate);
         }
+        node->get_parameter(AUTO_BAUD, params.auto_baud);
+        RCLCPP_INFO(node->get_logger(), "%s : %d", AUTO_BAUD.c_str(), params.auto_baud);
+        if (params.auto_baud) {
+            node->get_parameter(AUTO_BAUD_WINDOW, params.auto_baud_window);
+            RCLCPP_INFO(node->get_logger(), "%s : %f", AUTO_BAUD_WINDOW.c_str(), params.auto_baud_window);
+        }
     }
 
     return true;
 }
 
-bool LoadParamsFromRos2(std::shared_ptr<rclcpp::Node> node, const std::string& ns, CustomerInputParams& params) {
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, CanInputParams& params) {
+    const std::string INTERFACE = ns + ".interface";
+    const std::string IDS = ns + ".ids";
+    const std::string START_BITS = ns + ".start_bits";
+    const std::string LENGTHS = ns + ".lengths";
+    const std::string BIG_ENDIAN_PARAM = ns + ".big_endian";
+    const std::string SIGNED = ns + ".signed";
+    const std::string SCALES = ns + ".scales";
+    const std::string OFFSETS = ns + ".offsets";
+
+    node->declare_parameter(INTERFACE, "");
+    node->declare_parameter(IDS, std::vector<int64_t>());
+    node->declare_parameter(START_BITS, std::vector<int64_t>());
+    node->declare_parameter(LENGTHS, std::vector<int64_t>());
+    node->declare_parameter(BIG_ENDIAN_PARAM, std::vector<bool>());
+    node->declare_parameter(SIGNED, std::vector<bool>());
+    node->declare_parameter(SCALES, std::vector<double>());
+    node->declare_parameter(OFFSETS, std::vector<double>());
+
+    node->get_parameter(INTERFACE, params.interface);
+    if (params.interface.empty()) {
+        return true;
+    }
+    RCLCPP_INFO(node->get_logger(), "%s : %s", INTERFACE.c_str(), params.interface.c_str());
+
+    // One entry per signal in each list
+    std::vector<int64_t> ids, start_bits, lengths;
+    std::vector<bool> big_endian, is_signed;
+    std::vector<double> scales, offsets;
+    node->get_parameter(IDS, ids);
+    node->get_parameter(START_BITS, start_bits);
+    node->get_parameter(LENGTHS, lengths);
+    node->get_parameter(BIG_ENDIAN_PARAM, big_endian);
+    node->get_parameter(SIGNED, is_signed);
+    node->get_parameter(SCALES, scales);
+    node->get_parameter(OFFSETS, offsets);
+
+    const std::size_t n = ids.size();
+    if ((n != 1 && n != 2 && n != 4) || start_bits.size() != n || lengths.size() != n || big_endian.size() != n ||
+        is_signed.size() != n || scales.size() != n || offsets.size() != n) {
+        RCLCPP_ERROR(node->get_logger(), "%s.* must all have 1, 2 or 4 entries!", ns.c_str());
+        return false;
+    }
+
+    params.signals.clear();
+    for (std::size_t i = 0; i < n; i++) {
+        CanSignalParams signal;
+        signal.can_id = ids[i];
+        signal.start_bit = start_bits[i];
+        signal.length = lengths[i];
+        signal.big_endian = big_endian[i];
+        signal.is_signed = is_signed[i];
+        signal.scale = scales[i];
+        signal.offset = offsets[i];
+        params.signals.push_back(signal);
+        RCLCPP_INFO(node->get_logger(), "%s[%ld] : id 0x%x bit %d len %d %s %s scale %f offset %f", ns.c_str(), i,
+                    signal.can_id, signal.start_bit, signal.length, signal.big_endian ? "motorola" : "intel",
+                    signal.is_signed ? "signed" : "unsigned", signal.scale, signal.offset);
+    }
+    return true;
+}
+
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, Rtcm3InputParams& params) {
+    const std::string HOST = ns + ".host";
+    const std::string PORT = ns + ".port";
+    const std::string TOPIC = ns + ".topic";
+
+    node->declare_parameter(HOST, params.host);
+    node->declare_parameter(PORT, params.port);
+    node->declare_parameter(TOPIC, params.topic);
+
+    node->get_parameter(HOST, params.host);
+    node->get_parameter(PORT, params.port);
+    node->get_parameter(TOPIC, params.topic);
+    if (params.port > 0) {
+        RCLCPP_INFO(node->get_logger(), "%s : %s:%d", ns.c_str(), params.host.c_str(), params.port);
+    }
+    if (!params.topic.empty()) {
+        RCLCPP_INFO(node->get_logger(), "%s : %s", TOPIC.c_str(), params.topic.c_str());
+    }
+    return true;
+}
+
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, CustomerInputParams& params) {
     const std::string SPEED_TOPIC = ns + ".speed_topic";
     node->declare_parameter(SPEED_TOPIC, "/fixposition/speed");
     node->get_parameter(SPEED_TOPIC, params.speed_topic);
     RCLCPP_INFO(node->get_logger(), "%s : %s", SPEED_TOPIC.c_str(), params.speed_topic.c_str());
+    return LoadParamsFromRos2(node, ns + ".can", params.can) && LoadParamsFromRos2(node, ns + ".rtcm3", params.rtcm3);
+}
+
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, LoadSheddingParams& params) {
+    const std::string ENABLED = ns + ".enabled";
+    const std::string TIME_BUDGET = ns + ".time_budget";
+    const std::string BACKLOG_BUDGET = ns + ".backlog_budget";
+    const std::string DECIMATION = ns + ".decimation";
+    const std::string TYPES = ns + ".types";
+    const std::string PRIORITIES = ns + ".priorities";
+
+    node->declare_parameter(ENABLED, params.enabled);
+    node->declare_parameter(TIME_BUDGET, params.time_budget);
+    node->declare_parameter(BACKLOG_BUDGET, params.backlog_budget);
+    node->declare_parameter(DECIMATION, params.decimation);
+    node->declare_parameter(TYPES, params.types);
+    node->declare_parameter(PRIORITIES, std::vector<int64_t>(params.priorities.begin(), params.priorities.end()));
+
+    node->get_parameter(ENABLED, params.enabled);
+    RCLCPP_INFO(node->get_logger(), "%s : %d", ENABLED.c_str(), params.enabled);
+    if (!params.enabled) {
+        return true;
+    }
+    node->get_parameter(TIME_BUDGET, params.time_budget);
+    RCLCPP_INFO(node->get_logger(), "%s : %f", TIME_BUDGET.c_str(), params.time_budget);
+    node->get_parameter(BACKLOG_BUDGET, params.backlog_budget);
+    RCLCPP_INFO(node->get_logger(), "%s : %d", BACKLOG_BUDGET.c_str(), params.backlog_budget);
+    node->get_parameter(DECIMATION, params.decimation);
+    RCLCPP_INFO(node->get_logger(), "%s : %d", DECIMATION.c_str(), params.decimation);
+
+    std::vector<int64_t> priorities;
+    node->get_parameter(TYPES, params.types);
+    node->get_parameter(PRIORITIES, priorities);
+    if (params.types.size() != priorities.size()) {
+        RCLCPP_ERROR(node->get_logger(), "%s and %s must have the same number of entries!", TYPES.c_str(),
+                     PRIORITIES.c_str());
+        return false;
+    }
+    params.priorities.assign(priorities.begin(), priorities.end());
+    for (std::size_t i = 0; i < params.types.size(); i++) {
+        RCLCPP_INFO(node->get_logger(), "%s[%s] : priority %d", ns.c_str(), params.types[i].c_str(),
+                    params.priorities[i]);
+    }
+    return true;
+}
+
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, ExtrinsicParams& params) {
+    const std::string FRAME_ID = ns + ".frame_id";
+    const std::string TRANSLATION = ns + ".translation";
+    const std::string ROTATION = ns + ".rotation";
+
+    node->declare_parameter(FRAME_ID, "");
+    node->declare_parameter(TRANSLATION, params.translation);
+    node->declare_parameter(ROTATION, params.rotation);
+
+    node->get_parameter(FRAME_ID, params.frame_id);
+    if (params.frame_id.empty()) {
+        return true;
+    }
+    RCLCPP_INFO(node->get_logger(), "%s : %s", FRAME_ID.c_str(), params.frame_id.c_str());
+    node->get_parameter(TRANSLATION, params.translation);
+    node->get_parameter(ROTATION, params.rotation);
+    if (params.translation.size() != 3 || params.rotation.size() != 4) {
+        RCLCPP_ERROR(node->get_logger(), "%s needs 3 and %s 4 (w, x, y, z) entries!", TRANSLATION.c_str(),
+                     ROTATION.c_str());
+        return false;
+    }
+    RCLCPP_INFO(node->get_logger(), "%s : [%f, %f, %f]", TRANSLATION.c_str(), params.translation[0],
+                params.translation[1], params.translation[2]);
+    RCLCPP_INFO(node->get_logger(), "%s : [%f, %f, %f, %f]", ROTATION.c_str(), params.rotation[0], params.rotation[1],
+                params.rotation[2], params.rotation[3]);
     return true;
 }
 
-bool LoadParamsFromRos2(std::shared_ptr<rclcpp::Node> node, FixpositionDriverParams& params) {
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, TelemetryParams& params) {
+    const std::string ENABLED = ns + ".enabled";
+    const std::string KEYFRAME_INTERVAL = ns + ".keyframe_interval";
+
+    node->declare_parameter(ENABLED, params.enabled);
+    node->declare_parameter(KEYFRAME_INTERVAL, params.keyframe_interval);
+
+    node->get_parameter(ENABLED, params.enabled);
+    RCLCPP_INFO(node->get_logger(), "%s : %d", ENABLED.c_str(), params.enabled);
+    if (!params.enabled) {
+        return true;
+    }
+    node->get_parameter(KEYFRAME_INTERVAL, params.keyframe_interval);
+    RCLCPP_INFO(node->get_logger(), "%s : %d", KEYFRAME_INTERVAL.c_str(), params.keyframe_interval);
+    if (params.keyframe_interval < 1) {
+        RCLCPP_ERROR(node->get_logger(), "%s must be at least 1!", KEYFRAME_INTERVAL.c_str());
+        return false;
+    }
+    return true;
+}
+
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, ClockModelParams& params) {
+    const std::string ENABLED = ns + ".enabled";
+    const std::string STREAM = ns + ".stream";
+    const std::string DELAY = ns + ".delay";
+    const std::string WINDOW = ns + ".window";
+    const std::string NUM_WINDOWS = ns + ".num_windows";
+    const std::string SHM_NAME = ns + ".shm_name";
+
+    node->declare_parameter(ENABLED, params.enabled);
+    node->declare_parameter(STREAM, params.stream);
+    node->declare_parameter(DELAY, params.delay);
+    node->declare_parameter(WINDOW, params.window);
+    node->declare_parameter(NUM_WINDOWS, params.num_windows);
+    node->declare_parameter(SHM_NAME, params.shm_name);
+
+    node->get_parameter(ENABLED, params.enabled);
+    RCLCPP_INFO(node->get_logger(), "%s : %d", ENABLED.c_str(), params.enabled);
+    if (!params.enabled) {
+        return true;
+    }
+    node->get_parameter(STREAM, params.stream);
+    RCLCPP_INFO(node->get_logger(), "%s : %s", STREAM.c_str(), params.stream.c_str());
+    node->get_parameter(DELAY, params.delay);
+    RCLCPP_INFO(node->get_logger(), "%s : %f", DELAY.c_str(), params.delay);
+    node->get_parameter(WINDOW, params.window);
+    RCLCPP_INFO(node->get_logger(), "%s : %f", WINDOW.c_str(), params.window);
+    node->get_parameter(NUM_WINDOWS, params.num_windows);
+    RCLCPP_INFO(node->get_logger(), "%s : %d", NUM_WINDOWS.c_str(), params.num_windows);
+    node->get_parameter(SHM_NAME, params.shm_name);
+    RCLCPP_INFO(node->get_logger(), "%s : %s", SHM_NAME.c_str(), params.shm_name.c_str());
+    if (params.window <= 0.0) {
+        RCLCPP_ERROR(node->get_logger(), "%s must be positive!", WINDOW.c_str());
+        return false;
+    }
+    return true;
+}
+
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, HotRestartParams& params) {
+    const std::string SOCKET = ns + ".socket";
+    const std::string TIMEOUT = ns + ".timeout";
+
+    node->declare_parameter(SOCKET, params.socket);
+    node->declare_parameter(TIMEOUT, params.timeout);
+
+    node->get_parameter(SOCKET, params.socket);
+    if (params.socket.empty()) {
+        return true;
+    }
+    RCLCPP_INFO(node->get_logger(), "%s : %s", SOCKET.c_str(), params.socket.c_str());
+    node->get_parameter(TIMEOUT, params.timeout);
+    RCLCPP_INFO(node->get_logger(), "%s : %f", TIMEOUT.c_str(), params.timeout);
+    return true;
+}
+
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, FlightRecorderParams& params) {
+    const std::string FILE = ns + ".file";
+    const std::string SIZE = ns + ".size";
+
+    node->declare_parameter(FILE, params.file);
+    node->declare_parameter(SIZE, params.size);
+
+    node->get_parameter(FILE, params.file);
+    if (params.file.empty()) {
+        return true;
+    }
+    RCLCPP_INFO(node->get_logger(), "%s : %s", FILE.c_str(), params.file.c_str());
+    node->get_parameter(SIZE, params.size);
+    RCLCPP_INFO(node->get_logger(), "%s : %d", SIZE.c_str(), params.size);
+    if (params.size < 1) {
+        RCLCPP_ERROR(node->get_logger(), "%s must be at least 1 MiB!", SIZE.c_str());
+        return false;
+    }
+    return true;
+}
+
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, const std::string& ns, StatsParams& params) {
+    const std::string SHM_NAME = ns + ".shm_name";
+
+    node->declare_parameter(SHM_NAME, params.shm_name);
+
+    node->get_parameter(SHM_NAME, params.shm_name);
+    if (params.shm_name.empty()) {
+        return true;
+    }
+    RCLCPP_INFO(node->get_logger(), "%s : %s", SHM_NAME.c_str(), params.shm_name.c_str());
+    return true;
+}
+
+template <typename NodeT>
+bool LoadParamsFromRos2(std::shared_ptr<NodeT> node, FixpositionDriverParams& params) {
     bool ok = true;
 
     ok &= LoadParamsFromRos2(node, "fp_output", params.fp_output);
     ok &= LoadParamsFromRos2(node, "customer_input", params.customer_input);
+    ok &= LoadParamsFromRos2(node, "load_shedding", params.load_shedding);
+    ok &= LoadParamsFromRos2(node, "extrinsic", params.extrinsic);
+    ok &= LoadParamsFromRos2(node, "telemetry", params.telemetry);
+    ok &= LoadParamsFromRos2(node, "clock", params.clock);
+    ok &= LoadParamsFromRos2(node, "hot_restart", params.hot_restart);
+    ok &= LoadParamsFromRos2(node, "flight_recorder", params.flight_recorder);
+    ok &= LoadParamsFromRos2(node, "stats", params.stats);
 
     return ok;
 }
 
+// Plain and lifecycle node, the nested loaders are instantiated along with these
+template bool LoadParamsFromRos2(std::shared_ptr<rclcpp::Node> node, FixpositionDriverParams& params);
+template bool LoadParamsFromRos2(std::shared_ptr<rclcpp_lifecycle::LifecycleNode> node,
+                                 FixpositionDriverParams& params);
+
 }  // namespace fixposition
@@ -0,0 +1,296 @@
+/**
+ *  @file
+ *  @brief Implementation of SensorEmulator
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <arpa/inet.h>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+/* FIXPOSITION */
+#include <fixposition_driver_lib/helper.hpp>
+#include <fixposition_driver_lib/nov_type.hpp>
+#include <fixposition_driver_lib/stream_framer.hpp>
+
+/* PACKAGE */
+#include <fixposition_driver_ros2/sensor_emulator.hpp>
+
+namespace fixposition {
+
+static constexpr const double kMaxReplayStep = 1.0;  //!< larger GPS time steps of a capture are replayed as 0 [s]
+
+/**
+ * @brief GPS time of a recorded frame: fields 3 and 4 of FP_A messages, header of NOV_B messages with a long header
+ *
+ * @param[in] type
+ * @param[in] frame
+ * @param[in] size
+ * @param[out] gps [s] since the GPS epoch
+ * @return true
+ * @return false no GPS time in the frame
+ */
+static bool CaptureGpsTime(const StreamFramer::FrameType type, const uint8_t* frame, const int size, double& gps) {
+    if (type == StreamFramer::FrameType::NOV_B) {
+        if ((frame[2] != SYNC_CHAR_3_LONG) || (size < static_cast<int>(sizeof(Oem7MessageHeaderMem)))) {
+            return false;
+        }
+        Oem7MessageHeaderMem header;
+        memcpy(&header, frame, sizeof(header));
+        gps = header.gps_week * static_cast<double>(times::Constants::sec_per_week) + header.gps_milliseconds * 1e-3;
+        return header.gps_week > 0;
+    }
+    std::vector<std::string> tokens;
+    SplitMessage(tokens, std::string(reinterpret_cast<const char*>(frame), size), ",*");
+    if (tokens.size() < 5 || tokens[0] != "$FP" || tokens[3].empty() || tokens[4].empty()) {
+        return false;
+    }
+    const long week = strtol(tokens[3].c_str(), nullptr, 10);
+    const double tow = strtod(tokens[4].c_str(), nullptr);
+    gps = week * static_cast<double>(times::Constants::sec_per_week) + tow;
+    return week > 0;
+}
+
+SensorEmulator::SensorEmulator(const int port, const std::vector<Stream>& streams)
+    : port_(port), running_(false), sent_(0), connections_(0) {
+    for (const auto& stream : streams) {
+        if (stream.rate > 0.0) {
+            streams_.push_back(stream);
+        }
+    }
+}
+
+bool SensorEmulator::LoadCapture(const std::string& path, const double speed) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open() || speed <= 0.0) {
+        std::cerr << "Emulator: cannot read " << path << "\n";
+        return false;
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    capture_.clear();
+    capture_idx_ = 0;
+    bool have_gps = false;
+    double last_gps = 0.0;
+    StreamFramer framer;
+    framer.AddObserver(
+        [&](const StreamFramer::FrameType type, const uint8_t* frame, const int size, const uint64_t) {
+            CaptureFrame capture_frame;
+            capture_frame.data.assign(reinterpret_cast<const char*>(frame), size);
+            capture_frame.delay = 0.0;
+            double gps = 0.0;
+            const bool has_gps = CaptureGpsTime(type, frame, size, gps);
+            capture_frame.fp_a = has_gps && (type == StreamFramer::FrameType::NMEA);
+            if (has_gps) {
+                const double step = gps - last_gps;
+                if (have_gps && step > 0.0 && step <= kMaxReplayStep) {
+                    capture_frame.delay = step / speed;
+                }
+                have_gps = true;
+                last_gps = gps;
+            }
+            capture_.push_back(std::move(capture_frame));
+        });
+    framer.Process(data.data(), static_cast<int>(data.size()));
+
+    if (capture_.empty()) {
+        std::cerr << "Emulator: no messages in " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+SensorEmulator::~SensorEmulator() { Stop(); }
+
+std::string SensorEmulator::Restamp(const std::string& sentence, const times::GpsTime& stamp) {
+    // $FP,TYPE,VERSION,WEEK,TOW,...*CK\r\n: replace what is between the third and the fifth comma
+    std::size_t commas[5];
+    std::size_t pos = 0;
+    for (auto& comma : commas) {
+        pos = sentence.find(',', pos + 1);
+        if (pos == std::string::npos) {
+            return sentence;
+        }
+        comma = pos;
+    }
+    const std::size_t star_pos = sentence.rfind('*');
+    if (star_pos == std::string::npos || star_pos < commas[4]) {
+        return sentence;
+    }
+
+    char time_buf[64];
+    snprintf(time_buf, sizeof(time_buf), "%d,%.6f", stamp.wno, stamp.tow);
+    const std::string body =
+        sentence.substr(1, commas[2]) + time_buf + sentence.substr(commas[4], star_pos - commas[4]);
+
+    uint8_t ck = 0;
+    for (const char c : body) {
+        ck ^= static_cast<uint8_t>(c);
+    }
+    char ck_buf[8];
+    snprintf(ck_buf, sizeof(ck_buf), "*%02X\r\n", ck);
+    return "$" + body + ck_buf;
+}
+
+std::string SensorEmulator::MakeSentence(const std::string& header, const times::GpsTime& stamp) {
+    // Static content, only the time changes. Field counts and versions as expected by the converters.
+    std::string payload;
+    if (header == "ODOMETRY") {
+        payload =
+            "4278423.4014,636393.8127,4672182.5997,-0.923102,0.113633,-0.349381,0.113590,2.6775,0.0336,0.0234,0.00085,"
+            "0.00124,0.00444,0.0649,-0.1537,9.7801,4,1,8,8,1,0.02173,0.02821,0.02187,0.00019,-0.00176,-0.00702,0.00153,"
+            "0.00133,0.00183,0.00010,0.00007,0.00068,0.07619,0.08496,0.06098,0.00141,0.00093,-0.00079,"
+            "fp_release_vr2_2.29.0_28";
+    } else if (header == "LLH") {
+        payload = "47.398352081,8.460425163,444.523,0.028011,0.029076,0.014718,-0.0013104,0.00057655,0.00023722";
+    } else if (header == "RAWIMU" || header == "CORRIMU") {
+        payload = "-0.199914,0.472851,9.917973,0.023436,0.007723,0.002131";
+    } else if (header == "TF") {
+        payload = "POI,IMUH,0.00000,0.00000,0.00000,0.999848,0.012345,-0.008765,0.000000";
+    } else {
+        return "";
+    }
+    const char* version = (header == "ODOMETRY" || header == "TF") ? "2" : "1";
+
+    char time_buf[64];
+    snprintf(time_buf, sizeof(time_buf), "%d,%.6f", stamp.wno, stamp.tow);
+    const std::string body = "FP," + header + "," + version + "," + time_buf + "," + payload;
+
+    uint8_t ck = 0;
+    for (const char c : body) {
+        ck ^= static_cast<uint8_t>(c);
+    }
+    char ck_buf[8];
+    snprintf(ck_buf, sizeof(ck_buf), "*%02X\r\n", ck);
+    return "$" + body + ck_buf;
+}
+
+bool SensorEmulator::Start() {
+    server_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (server_fd_ < 0) {
+        std::cerr << "Emulator: cannot create socket: " << strerror(errno) << "\n";
+        return false;
+    }
+    const int one = 1;
+    setsockopt(server_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port_);
+    if (bind(server_fd_, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(server_fd_, 1) != 0) {
+        std::cerr << "Emulator: cannot listen on port " << port_ << ": " << strerror(errno) << "\n";
+        close(server_fd_);
+        server_fd_ = -1;
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&SensorEmulator::Serve, this);
+    return true;
+}
+
+void SensorEmulator::Stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (server_fd_ != -1) {
+        close(server_fd_);
+        server_fd_ = -1;
+    }
+}
+
+void SensorEmulator::Serve() {
+    while (running_) {
+        // Wait for the driver to connect, checking regularly if we should stop
+        struct pollfd pfd = {server_fd_, POLLIN, 0};
+        if (poll(&pfd, 1, 100) <= 0) {
+            continue;
+        }
+        const int client_fd = accept(server_fd_, nullptr, nullptr);
+        if (client_fd < 0) {
+            continue;
+        }
+        connections_++;
+
+        Clock::time_point until = Clock::time_point::max();
+        if (disconnect_period_ > 0.0) {
+            until = Clock::now() +
+                    std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(disconnect_period_));
+        }
+        if (capture_.empty()) {
+            ServeStreams(client_fd, until);
+        } else {
+            ServeCapture(client_fd, until);
+        }
+        close(client_fd);
+    }
+}
+
+void SensorEmulator::ServeStreams(const int client_fd, const Clock::time_point until) {
+    if (streams_.empty()) {
+        return;
+    }
+    std::vector<Clock::time_point> next(streams_.size(), Clock::now());
+    while (running_ && Clock::now() < until) {
+        // Next stream due
+        std::size_t idx = 0;
+        for (std::size_t i = 1; i < streams_.size(); i++) {
+            if (next[i] < next[idx]) {
+                idx = i;
+            }
+        }
+        std::this_thread::sleep_until(next[idx]);
+        next[idx] += std::chrono::nanoseconds(static_cast<int64_t>(1e9 / streams_[idx].rate));
+
+        // Stamp with the send time
+        const auto stamp = times::PtimeToGpsTime(BOOST_POSIX::microsec_clock::universal_time());
+        const std::string sentence = MakeSentence(streams_[idx].header, stamp);
+        if (send(client_fd, sentence.data(), sentence.size(), MSG_NOSIGNAL) < 0) {
+            return;
+        }
+        sent_++;
+    }
+}
+
+void SensorEmulator::ServeCapture(const int client_fd, const Clock::time_point until) {
+    Clock::time_point next = Clock::now();
+    while (running_ && Clock::now() < until) {
+        const CaptureFrame& frame = capture_[capture_idx_];
+        next += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(frame.delay));
+        std::this_thread::sleep_until(next);
+
+        // Stamp FP_A messages with the send time
+        const std::string restamped =
+            frame.fp_a ? Restamp(frame.data, times::PtimeToGpsTime(BOOST_POSIX::microsec_clock::universal_time()))
+                       : std::string();
+        const std::string& data = frame.fp_a ? restamped : frame.data;
+        if (send(client_fd, data.data(), data.size(), MSG_NOSIGNAL) < 0) {
+            return;  // sent again on the next connection
+        }
+        sent_++;
+        capture_idx_ = (capture_idx_ + 1) % capture_.size();
+    }
+}
+
+}  // namespace fixposition
@@ -0,0 +1,292 @@
+/**
+ *  @file
+ *  @brief Long-duration soak test: replayed sensor output -> driver node (in process) -> subscriber, watching for
+ *         growing memory, descriptors and latency
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <dirent.h>
+#include <malloc.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* ROS */
+#include <geometry_msgs/msg/vector3_stamped.hpp>
+#include <nav_msgs/msg/odometry.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/imu.hpp>
+#include <sensor_msgs/msg/nav_sat_fix.hpp>
+
+/* PACKAGE */
+#include <fixposition_driver_ros2/fixposition_driver_node.hpp>
+#include <fixposition_driver_ros2/params.hpp>
+#include <fixposition_driver_ros2/sensor_emulator.hpp>
+
+namespace fixposition {
+
+/**
+ * @brief Resource usage of the process and latency of the messages received since the previous sample
+ *
+ */
+struct SoakSample {
+    double time = 0.0;      //!< [s] since the start of the test
+    uint64_t rss = 0;       //!< resident set size [bytes]
+    uint64_t fds = 0;       //!< open file descriptors
+    uint64_t heap = 0;      //!< bytes allocated with malloc and not freed
+    uint64_t messages = 0;  //!< messages received in the sample period
+    double p50 = 0.0;       //!< latency percentiles of these messages [ms]
+    double p99 = 0.0;
+};
+
+/**
+ * @brief Sample the resource usage of this process
+ *
+ * @param[out] sample
+ */
+static void SampleProcess(SoakSample& sample) {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size = 0, resident = 0;
+    statm >> size >> resident;
+    sample.rss = resident * sysconf(_SC_PAGESIZE);
+
+    sample.fds = 0;
+    DIR* dir = opendir("/proc/self/fd");
+    if (dir != nullptr) {
+        while (readdir(dir) != nullptr) {
+            sample.fds++;
+        }
+        closedir(dir);
+        sample.fds -= 3;  // ".", ".." and the descriptor of dir itself
+    }
+
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const struct mallinfo2 info = mallinfo2();
+#else
+    const struct mallinfo info = mallinfo();
+#endif
+    sample.heap = info.uordblks + info.hblkhd;  // small blocks in use + mmapped large blocks
+}
+
+/**
+ * @brief Subscribes to the driver outputs and collects the latency of every message until the next sample
+ *
+ * The emulator stamps every message with its send time, so latency = receive time - header stamp.
+ */
+class SoakSubscriber {
+   public:
+    SoakSubscriber(std::shared_ptr<rclcpp::Node> node) : node_(node) {
+        Subscribe<nav_msgs::msg::Odometry>("/fixposition/odometry");
+        Subscribe<sensor_msgs::msg::NavSatFix>("/fixposition/navsatfix");
+        Subscribe<sensor_msgs::msg::Imu>("/fixposition/rawimu");
+        Subscribe<sensor_msgs::msg::Imu>("/fixposition/corrimu");
+        Subscribe<geometry_msgs::msg::Vector3Stamped>("/fixposition/imu_ypr");
+    }
+
+    /**
+     * @brief Latency percentiles of the messages since the last call, starts the next period
+     *
+     * @param[out] sample
+     */
+    void TakeLatency(SoakSample& sample) {
+        // Swap out under the lock, the buffers keep their capacity so the test itself does not grow
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::swap(latencies_, sorted_);
+        }
+        sample.messages = sorted_.size();
+        sample.p50 = 0.0;
+        sample.p99 = 0.0;
+        if (!sorted_.empty()) {
+            std::sort(sorted_.begin(), sorted_.end());
+            sample.p50 = sorted_[std::min(sorted_.size() - 1, static_cast<std::size_t>(0.50 * sorted_.size()))];
+            sample.p99 = sorted_[std::min(sorted_.size() - 1, static_cast<std::size_t>(0.99 * sorted_.size()))];
+        }
+        sorted_.clear();
+    }
+
+   private:
+    template <typename MsgT>
+    void Subscribe(const std::string& topic) {
+        subs_.push_back(node_->create_subscription<MsgT>(
+            topic, rclcpp::SensorDataQoS(), [this](const typename MsgT::ConstSharedPtr msg) {
+                const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count();
+                const int64_t stamp = int64_t(msg->header.stamp.sec) * 1000000000 + msg->header.stamp.nanosec;
+                std::lock_guard<std::mutex> lock(mutex_);
+                latencies_.push_back((now - stamp) * 1e-6);
+            }));
+    }
+
+    std::shared_ptr<rclcpp::Node> node_;
+    std::vector<rclcpp::SubscriptionBase::SharedPtr> subs_;
+    std::mutex mutex_;
+    std::vector<double> latencies_;  //!< [ms] of the current period
+    std::vector<double> sorted_;     //!< [ms] of the period being evaluated
+};
+
+}  // namespace fixposition
+
+int main(int argc, char** argv) {
+    rclcpp::init(argc, argv);
+    auto node = rclcpp::Node::make_shared("fixposition_soak_harness");
+
+    const int port = node->declare_parameter("port", 21002);
+    const std::string capture = node->declare_parameter("capture", std::string(""));
+    const double replay_speed = node->declare_parameter("replay_speed", 10.0);
+    const double duration = node->declare_parameter("duration", 3600.0);
+    const double warmup = node->declare_parameter("warmup", 60.0);
+    const double sample_period = std::max(0.1, node->declare_parameter("sample_period", 10.0));
+    const double reconnect_period = node->declare_parameter("reconnect_period", 0.0);
+    const std::string read_strategy = node->declare_parameter("read_strategy", std::string("rate"));
+    const std::string csv_file = node->declare_parameter("csv_file", std::string(""));
+    // Allowed growth over the first sample after the warm-up, < 0 to not check
+    const double max_rss_growth_kb = node->declare_parameter("max_rss_growth_kb", 10240.0);
+    const double max_heap_growth_kb = node->declare_parameter("max_heap_growth_kb", 4096.0);
+    const int max_fd_growth = node->declare_parameter("max_fd_growth", 0);
+    const double max_p99_growth_ms = node->declare_parameter("max_p99_growth_ms", 5.0);
+
+    // Sensor: the recording in a loop, or the synthetic streams of the latency harness
+    const std::vector<fixposition::SensorEmulator::Stream> streams = {
+        {"ODOMETRY", 100.0}, {"LLH", 10.0}, {"RAWIMU", 200.0}, {"CORRIMU", 200.0}, {"TF", 200.0}};
+    fixposition::SensorEmulator emulator(port, streams);
+    if (!capture.empty() && !emulator.LoadCapture(capture, replay_speed)) {
+        rclcpp::shutdown();
+        return 1;
+    }
+    emulator.SetDisconnectPeriod(reconnect_period);
+    if (!emulator.Start()) {
+        rclcpp::shutdown();
+        return 1;
+    }
+
+    // Driver node in this process, so its memory and descriptors are ours to watch
+    const std::vector<rclcpp::Parameter> driver_params = {
+        rclcpp::Parameter("fp_output.formats", std::vector<std::string>{"ODOMETRY", "LLH", "RAWIMU", "CORRIMU", "TF"}),
+        rclcpp::Parameter("fp_output.type", "tcp"),
+        rclcpp::Parameter("fp_output.ip", "127.0.0.1"),
+        rclcpp::Parameter("fp_output.port", std::to_string(port)),
+        rclcpp::Parameter("fp_output.rate", 200),
+        rclcpp::Parameter("fp_output.reconnect_delay", 1.0),
+        rclcpp::Parameter("fp_output.read_strategy", read_strategy),
+    };
+    auto driver = rclcpp::Node::make_shared(
+        "fixposition_driver", rclcpp::NodeOptions().use_global_arguments(false).parameter_overrides(driver_params));
+    fixposition::FixpositionDriverParams params;
+    if (!fixposition::LoadParamsFromRos2(driver, params)) {
+        RCLCPP_ERROR(node->get_logger(), "Driver params loading failed!");
+        emulator.Stop();
+        rclcpp::shutdown();
+        return 1;
+    }
+    std::thread driver_thread([driver, params]() {
+        fixposition::FixpositionDriverNode<rclcpp::Node> driver_node(driver, params);
+        driver_node.Run();
+    });
+
+    fixposition::SoakSubscriber subscriber(node);
+    std::ofstream csv;
+    if (!csv_file.empty()) {
+        csv.open(csv_file);
+        csv << "time_s,rss_kb,heap_kb,fds,messages,p50_ms,p99_ms\n";
+    }
+    RCLCPP_INFO(node->get_logger(), "Soak test for %.0f s, %s, baseline after %.0f s", duration,
+                capture.empty() ? "synthetic streams" : ("replaying " + capture).c_str(), warmup);
+    printf("%10s %12s %12s %6s %9s %9s %9s\n", "time[s]", "rss[kB]", "heap[kB]", "fds", "msgs", "p50[ms]", "p99[ms]");
+
+    rclcpp::executors::SingleThreadedExecutor executor;
+    executor.add_node(node);
+    const auto start = std::chrono::steady_clock::now();
+    auto next_sample = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                   std::chrono::duration<double>(sample_period));
+    bool have_baseline = false;
+    fixposition::SoakSample baseline;
+    std::string failure;
+    while (rclcpp::ok() && failure.empty()) {
+        executor.spin_once(std::chrono::milliseconds(100));
+        const auto now = std::chrono::steady_clock::now();
+        if (now < next_sample) {
+            continue;
+        }
+        next_sample += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(sample_period));
+
+        fixposition::SoakSample sample;
+        sample.time = std::chrono::duration<double>(now - start).count();
+        fixposition::SampleProcess(sample);
+        subscriber.TakeLatency(sample);
+        printf("%10.0f %12.0f %12.0f %6lu %9lu %9.3f %9.3f\n", sample.time, sample.rss / 1024.0,
+               sample.heap / 1024.0, sample.fds, sample.messages, sample.p50, sample.p99);
+        fflush(stdout);
+        if (csv.is_open()) {
+            csv << sample.time << "," << sample.rss / 1024 << "," << sample.heap / 1024 << "," << sample.fds << ","
+                << sample.messages << "," << sample.p50 << "," << sample.p99 << "\n";
+        }
+
+        if (sample.time < warmup) {
+            continue;
+        }
+        if (!have_baseline) {
+            baseline = sample;
+            have_baseline = true;
+            continue;
+        }
+
+        // Regression gates, checked on every sample so the test stops as soon as something runs away
+        char buf[160];
+        if (max_rss_growth_kb >= 0.0 && (double(sample.rss) - double(baseline.rss)) / 1024.0 > max_rss_growth_kb) {
+            snprintf(buf, sizeof(buf), "RSS grew by %.0f kB", (double(sample.rss) - double(baseline.rss)) / 1024.0);
+            failure = buf;
+        } else if (max_heap_growth_kb >= 0.0 &&
+                   (double(sample.heap) - double(baseline.heap)) / 1024.0 > max_heap_growth_kb) {
+            snprintf(buf, sizeof(buf), "heap grew by %.0f kB",
+                     (double(sample.heap) - double(baseline.heap)) / 1024.0);
+            failure = buf;
+        } else if (max_fd_growth >= 0 && sample.fds > baseline.fds + max_fd_growth) {
+            snprintf(buf, sizeof(buf), "open descriptors grew from %lu to %lu", baseline.fds, sample.fds);
+            failure = buf;
+        } else if (max_p99_growth_ms >= 0.0 && sample.messages > 0 && sample.p99 > baseline.p99 + max_p99_growth_ms) {
+            snprintf(buf, sizeof(buf), "p99 latency grew from %.3f ms to %.3f ms", baseline.p99, sample.p99);
+            failure = buf;
+        } else if (sample.messages == 0) {
+            failure = "no messages received";
+        }
+        if (sample.time >= duration) {
+            break;
+        }
+    }
+
+    RCLCPP_INFO(node->get_logger(), "Sent %lu messages over %lu connections", emulator.SentCount(),
+                emulator.ConnectionCount());
+    rclcpp::shutdown();
+    driver_thread.join();
+    emulator.Stop();
+
+    if (!failure.empty()) {
+        printf("FAIL: %s\n", failure.c_str());
+        return 1;
+    }
+    if (!have_baseline) {
+        printf("FAIL: the test ended before the warm-up\n");
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ *  @file
+ *  @brief Compare the size of telemetry packets with the serialized nav_msgs/Odometry of a recording
+ *
+ * \verbatim
+ *  ___    ___
+ *  \  \  /  /
+ *   \  \/  /   Fixposition AG
+ *   /  /\  \   All right reserved.
+ *  /__/  \__\
+ * \endverbatim
+ *
+ */
+
+/* SYSTEM / STL */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+/* ROS */
+#include <nav_msgs/msg/odometry.hpp>
+#include <rclcpp/serialization.hpp>
+#include <rclcpp/serialized_message.hpp>
+
+/* PACKAGE */
+#include <fixposition_driver_lib/converter/base_converter.hpp>
+#include <fixposition_driver_lib/helper.hpp>
+#include <fixposition_driver_lib/perf_counters.hpp>
+#include <fixposition_driver_lib/telemetry.hpp>
+#include <fixposition_driver_ros2/data_to_ros2.hpp>
+#include <fixposition_driver_ros2/msg/telemetry.hpp>
+
+int main(int argc, char** argv) {
+    // -p: also count cycles, instructions, branch and cache misses of the encoding
+    const bool use_perf = (argc > 1) && (std::string(argv[1]) == "-p");
+    const int arg0 = use_perf ? 2 : 1;
+    if (argc <= arg0) {
+        printf("Usage: %s [-p] <recorded sensor output> [keyframe interval]\n", argv[0]);
+        return 1;
+    }
+    const char* path = argv[arg0];
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        printf("Cannot open %s\n", path);
+        return 1;
+    }
+    fixposition::TelemetryParams params;
+    params.enabled = true;
+    if (argc > arg0 + 1) {
+        params.keyframe_interval = std::max(1, std::stoi(argv[arg0 + 1]));
+    }
+
+    fixposition::PerfCounters perf;
+    fixposition::PerfCounters::Values encode_counters = {};
+    const bool have_perf = use_perf && perf.Open();
+    if (use_perf && !have_perf) {
+        printf("No performance counters available (kernel.perf_event_paranoid > 2 or no PMU)\n");
+    }
+
+    fixposition::TelemetryEncoder encoder(params);
+    fixposition::TelemetryDecoder decoder;
+    rclcpp::Serialization<nav_msgs::msg::Odometry> odometry_serializer;
+    rclcpp::Serialization<fixposition_driver_ros2::msg::Telemetry> telemetry_serializer;
+    rclcpp::SerializedMessage serialized;
+    fixposition_driver_ros2::msg::Telemetry telemetry;
+
+    uint64_t samples = 0, odometry_bytes = 0, packet_bytes = 0, telemetry_bytes = 0, decode_errors = 0;
+    double first_stamp = 0.0, last_stamp = 0.0, encode_time = 0.0;
+    double max_pos_err = 0.0, max_rot_err = 0.0, max_vel_err = 0.0;
+
+    // Position, orientation and velocity are at the same place in all ODOMETRY versions
+    std::string line;
+    while (std::getline(file, line)) {
+        const auto start = line.find("$FP,ODOMETRY,");
+        const auto star = line.find('*', start);
+        if (start == std::string::npos || star == std::string::npos) {
+            continue;
+        }
+        std::vector<std::string> tokens;
+        fixposition::SplitMessage(tokens, line.substr(start + 1, star - start - 1), ",");
+        if (tokens.size() < 15 || tokens[5].empty()) {
+            continue;
+        }
+        fixposition::OdometryData odometry;
+        odometry.stamp = fixposition::ConvertGpsTime(tokens[3], tokens[4]);
+        odometry.frame_id = "ECEF";
+        odometry.child_frame_id = "gnss";
+        odometry.pose.position = fixposition::Vector3ToEigen(tokens[5], tokens[6], tokens[7]);
+        odometry.pose.orientation = fixposition::Vector4ToEigen(tokens[8], tokens[9], tokens[10], tokens[11]);
+        odometry.twist.linear = fixposition::Vector3ToEigen(tokens[12], tokens[13], tokens[14]);
+
+        const double stamp = odometry.stamp.wno * 604800.0 + odometry.stamp.tow;
+        first_stamp = samples == 0 ? stamp : first_stamp;
+        last_stamp = stamp;
+        samples++;
+
+        // What the driver publishes today
+        nav_msgs::msg::Odometry msg;
+        fixposition::OdometryDataToMsg(odometry, msg);
+        odometry_serializer.serialize_message(&msg, &serialized);
+        odometry_bytes += serialized.size();
+
+        // Telemetry packet, bare and wrapped in its ROS message
+        if (have_perf) {
+            perf.Start();
+        }
+        const auto t0 = std::chrono::steady_clock::now();
+        encoder.Encode(odometry, telemetry.data);
+        encode_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (have_perf) {
+            const auto& values = perf.Stop();
+            for (int c = 0; c < fixposition::PerfCounters::NUM_COUNTERS; c++) {
+                encode_counters[c] += values[c];
+            }
+        }
+        packet_bytes += telemetry.data.size();
+        telemetry_serializer.serialize_message(&telemetry, &serialized);
+        telemetry_bytes += serialized.size();
+
+        fixposition::OdometryData decoded;
+        if (!decoder.Decode(telemetry.data.data(), telemetry.data.size(), decoded)) {
+            decode_errors++;
+            continue;
+        }
+        max_pos_err = std::max(max_pos_err, (decoded.pose.position - odometry.pose.position).norm());
+        max_rot_err =
+            std::max(max_rot_err, decoded.pose.orientation.angularDistance(odometry.pose.orientation.normalized()));
+        max_vel_err = std::max(max_vel_err, (decoded.twist.linear - odometry.twist.linear).norm());
+    }
+
+    if (samples < 2 || last_stamp <= first_stamp) {
+        printf("Not enough ODOMETRY messages in %s\n", path);
+        return 1;
+    }
+    const double duration = last_stamp - first_stamp;
+    printf("%lu ODOMETRY samples over %.1f s (%.1f Hz), keyframe interval %d\n", samples, duration,
+           (samples - 1) / duration, params.keyframe_interval);
+    printf("%-32s %10s %12s\n", "", "B/sample", "B/s");
+    printf("%-32s %10.1f %12.1f\n", "nav_msgs/Odometry (CDR)", double(odometry_bytes) / samples,
+           odometry_bytes / duration);
+    printf("%-32s %10.1f %12.1f\n", "Telemetry (CDR)", double(telemetry_bytes) / samples, telemetry_bytes / duration);
+    printf("%-32s %10.1f %12.1f\n", "Telemetry packet", double(packet_bytes) / samples, packet_bytes / duration);
+    printf("Reduction %.1fx, encoding %.0f ns/sample\n", double(odometry_bytes) / packet_bytes,
+           encode_time / samples * 1e9);
+    if (have_perf) {
+        printf("Encoding per sample:");
+        for (int c = 0; c < fixposition::PerfCounters::NUM_COUNTERS; c++) {
+            const auto counter = static_cast<fixposition::PerfCounters::Counter>(c);
+            if (perf.Available(counter)) {
+                printf(" %.1f %s", encode_counters[c] / samples, fixposition::PerfCounters::Name(counter));
+            }
+        }
+        printf("\n");
+    }
+    printf("Max error: position %.4f m, orientation %.6f rad, velocity %.4f m/s, %lu decode errors\n", max_pos_err,
+           max_rot_err, max_vel_err, decode_errors);
+    return decode_errors == 0 ? 0 : 1;
+}